@@ -0,0 +1,289 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#include "boss_runeworder_capture.h"
+#include "boss_runeworder_pack.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+
+template<typename T>
+void PutCaptureValue(std::string& buffer, T const& value)
+{
+    buffer.append(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template<typename T>
+T GetCaptureValue(uint8 const*& data)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    data += sizeof(T);
+    return value;
+}
+
+}
+
+void AppendRuneCaptureFileHeader(std::string& buffer)
+{
+    RuneCaptureFileHeader header = { RUNECAPTURE_MAGIC, RUNECAPTURE_VERSION, uint16(sizeof(RuneCaptureFileHeader)) };
+    PutCaptureValue(buffer, header);
+}
+
+void AppendRuneCapture(RuneCapture const& capture, std::string& buffer)
+{
+    RuneCaptureRecordHeader header = capture.header;
+    header.pointCount = uint8(std::min<size_t>(capture.points.size(), MAX_RUNE_POINTS));
+    header.vertexCount = uint8(std::min<size_t>(capture.vertices.size(), header.pointCount));
+    header.angleCount = uint8(std::min<size_t>(capture.angles.size(), MAX_RUNE_POINTS));
+    header.strokeCount = uint8(std::min<size_t>(capture.strokes.size(), MAX_RUNE_POINTS));
+    header.matchCount = uint8(std::min<size_t>(capture.matches.size(), MAX_RUNE_MATCHES));
+    header.reserved = 0;
+
+    size_t start = buffer.size();
+    PutCaptureValue(buffer, uint32(0)); //size and checksum, filled below
+    PutCaptureValue(buffer, uint32(0));
+    PutCaptureValue(buffer, header);
+    for (uint8 i = 0; i < header.pointCount; ++i)
+    {
+        PutCaptureValue(buffer, capture.points[i].x);
+        PutCaptureValue(buffer, capture.points[i].y);
+    }
+    for (uint8 i = 0; i < header.vertexCount; ++i)
+        PutCaptureValue(buffer, uint8(std::min<uint32>(capture.vertices[i], header.pointCount - 1)));
+    for (uint8 i = 0; i < header.angleCount; ++i)
+        PutCaptureValue(buffer, int16(capture.angles[i]));
+    for (uint8 i = 0; i < header.strokeCount; ++i)
+        PutCaptureValue(buffer, uint8(capture.strokes[i].type | (capture.strokes[i].reverse ? RUNECAPTURE_STROKE_REVERSE : 0)));
+    for (uint8 i = 0; i < header.matchCount; ++i)
+    {
+        RuneMatch const& match = capture.matches[i];
+        RuneCaptureMatch stored = { match.type, match.score.errors, match.score.offset, match.score.coverage, uint8(match.score.reversed) };
+        PutCaptureValue(buffer, stored);
+    }
+
+    uint32 size = uint32(buffer.size() - start - 2 * sizeof(uint32));
+    uint32 checksum = RunePackChecksum(reinterpret_cast<uint8 const*>(buffer.data()) + start + 2 * sizeof(uint32), size);
+    std::memcpy(&buffer[start], &size, sizeof(size));
+    std::memcpy(&buffer[start + sizeof(size)], &checksum, sizeof(checksum));
+}
+
+RuneCaptureReadResults ReadRuneCapture(uint8 const* data, size_t size, size_t& offset, RuneCapture& capture)
+{
+    if (offset >= size)
+        return RUNECAPTURE_READ_END;
+    if (size - offset < 2 * sizeof(uint32))
+        return RUNECAPTURE_READ_TRUNCATED;
+
+    uint8 const* pos = data + offset;
+    uint32 recordSize = GetCaptureValue<uint32>(pos);
+    uint32 checksum = GetCaptureValue<uint32>(pos);
+    if (recordSize < sizeof(RuneCaptureRecordHeader))
+        return RUNECAPTURE_READ_CORRUPT;
+    if (size - offset - 2 * sizeof(uint32) < recordSize)
+        return RUNECAPTURE_READ_TRUNCATED;
+    if (RunePackChecksum(pos, recordSize) != checksum)
+        return RUNECAPTURE_READ_CORRUPT;
+
+    RuneCaptureRecordHeader header = GetCaptureValue<RuneCaptureRecordHeader>(pos);
+    if (recordSize != sizeof(header) + header.pointCount * 2 * sizeof(float) + header.vertexCount + header.angleCount * sizeof(int16) +
+        header.strokeCount + header.matchCount * sizeof(RuneCaptureMatch))
+        return RUNECAPTURE_READ_CORRUPT;
+
+    capture.header = header;
+    capture.points.resize(header.pointCount);
+    for (RuneTemplatePoint& point : capture.points)
+    {
+        point.x = GetCaptureValue<float>(pos);
+        point.y = GetCaptureValue<float>(pos);
+    }
+    capture.vertices.resize(header.vertexCount);
+    for (uint32& vertex : capture.vertices)
+    {
+        vertex = GetCaptureValue<uint8>(pos);
+        if (vertex >= header.pointCount)
+            return RUNECAPTURE_READ_CORRUPT;
+    }
+    capture.angles.resize(header.angleCount);
+    for (int32& angle : capture.angles)
+        angle = GetCaptureValue<int16>(pos);
+    capture.strokes.clear();
+    for (uint8 i = 0; i < header.strokeCount; ++i)
+    {
+        uint8 stroke = GetCaptureValue<uint8>(pos);
+        uint8 type = stroke & ~RUNECAPTURE_STROKE_REVERSE;
+        bool reverse = stroke & RUNECAPTURE_STROKE_REVERSE;
+        if (type < LINE || type >= TURN_REVERSE || (reverse && (type == LINE || type == LINE_REV)))
+            return RUNECAPTURE_READ_CORRUPT;
+        capture.strokes.emplace_back(type, reverse);
+    }
+    capture.matches.resize(header.matchCount);
+    for (RuneMatch& match : capture.matches)
+    {
+        RuneCaptureMatch stored = GetCaptureValue<RuneCaptureMatch>(pos);
+        match.type = stored.type;
+        match.score = RuneMatchScore{ stored.errors, stored.offset, stored.coverage, stored.reversed != 0 };
+    }
+
+    offset += 2 * sizeof(uint32) + recordSize;
+    return RUNECAPTURE_READ_OK;
+}
+
+bool ReadRuneCaptureFileHeader(uint8 const* data, size_t size, size_t& offset, std::string& error)
+{
+    RuneCaptureFileHeader header;
+    if (size - offset < sizeof(header))
+    {
+        error = "file too short";
+        return false;
+    }
+    std::memcpy(&header, data + offset, sizeof(header));
+    if (header.magic != RUNECAPTURE_MAGIC)
+    {
+        error = "not a rune capture log";
+        return false;
+    }
+    if (header.version != RUNECAPTURE_VERSION || header.headerSize != sizeof(header))
+    {
+        error = "unsupported capture version " + std::to_string(header.version) + ", expected " + std::to_string(RUNECAPTURE_VERSION);
+        return false;
+    }
+    offset += sizeof(header);
+    return true;
+}
+
+bool RuneCaptureLog::Open(std::string const& fileName, std::string& error)
+{
+    Close();
+
+    //existing logs are appended to if they are of this version, a record torn by a crash is cut off
+    if (FILE* existing = std::fopen(fileName.c_str(), "rb"))
+    {
+        uint8 data[sizeof(RuneCaptureFileHeader)];
+        size_t read = std::fread(data, 1, sizeof(data), existing);
+        size_t offset = 0;
+        if (read && !ReadRuneCaptureFileHeader(data, read, offset, error))
+        {
+            std::fclose(existing);
+            return false;
+        }
+
+        //record sizes only, payloads are skipped
+        std::fseek(existing, 0, SEEK_END);
+        uint64 fileSize = uint64(std::ftell(existing));
+        uint64 validSize = offset;
+        uint32 prefix[2];
+        while (std::fseek(existing, long(validSize), SEEK_SET) == 0 && std::fread(prefix, sizeof(prefix), 1, existing) == 1 &&
+            fileSize - validSize - sizeof(prefix) >= prefix[0])
+            validSize += sizeof(prefix) + prefix[0];
+        std::fclose(existing);
+
+        std::error_code ec;
+        if (validSize < fileSize)
+            std::filesystem::resize_file(fileName, validSize, ec);
+        if (ec)
+        {
+            error = "cannot cut off torn record: " + ec.message();
+            return false;
+        }
+    }
+
+    _file = std::fopen(fileName.c_str(), "ab");
+    if (!_file)
+    {
+        error = std::strerror(errno);
+        return false;
+    }
+
+    std::fseek(_file, 0, SEEK_END);
+    if (std::ftell(_file) == 0)
+    {
+        std::string header;
+        AppendRuneCaptureFileHeader(header);
+        if (std::fwrite(header.data(), header.size(), 1, _file) != 1 || std::fflush(_file))
+        {
+            error = std::strerror(errno);
+            std::fclose(_file);
+            _file = nullptr;
+            return false;
+        }
+    }
+
+    _stopping = false;
+    _writer = std::thread(&RuneCaptureLog::_Run, this);
+    return true;
+}
+
+void RuneCaptureLog::Close()
+{
+    if (!_file)
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _stopping = true;
+    }
+    _wake.notify_one();
+    _writer.join();
+    std::fclose(_file);
+    _file = nullptr;
+}
+
+void RuneCaptureLog::Push(RuneCapture&& capture)
+{
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_pending.size() >= RUNECAPTURE_MAX_PENDING)
+        {
+            ++_dropped;
+            return;
+        }
+        _pending.push_back(std::move(capture));
+    }
+    _wake.notify_one();
+}
+
+uint64 RuneCaptureLog::GetWritten() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _written;
+}
+
+uint64 RuneCaptureLog::GetDropped() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _dropped;
+}
+
+//writer thread: takes all pending records at once, one write per batch
+void RuneCaptureLog::_Run()
+{
+    std::vector<RuneCapture> batch;
+    std::string buffer;
+    std::unique_lock<std::mutex> guard(_lock);
+    while (true)
+    {
+        _wake.wait(guard, [this]() { return _stopping || !_pending.empty(); });
+        batch.swap(_pending);
+        bool stopping = _stopping;
+        guard.unlock();
+
+        buffer.clear();
+        for (RuneCapture const& capture : batch)
+            AppendRuneCapture(capture, buffer);
+        bool written = buffer.empty() || (std::fwrite(buffer.data(), buffer.size(), 1, _file) == 1 && !std::fflush(_file));
+        size_t count = batch.size();
+        batch.clear();
+
+        guard.lock();
+        (written ? _written : _dropped) += count;
+        if (stopping && _pending.empty())
+            break;
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_CAPTURE_H
+#define BOSS_RUNEWORDER_CAPTURE_H
+
+//Carve capture log (Runeworder.Capture.File)
+//Every computed rune is appended to a binary log: carve points, vertices, vertex angles, strokes,
+//matches and the roll, so a reported rune can be replayed offline (tools/runeworder_replay).
+//
+//Layout (little-endian):
+//  RuneCaptureFileHeader                 //once, when the file is created
+//  records, each:
+//    uint32 size                         //payload bytes
+//    uint32 checksum                     //FNV-1a of the payload
+//    RuneCaptureRecordHeader
+//    float points[pointCount][2]
+//    uint8 vertices[vertexCount]         //indices of the points kept as vertices
+//    int16 angles[angleCount]
+//    uint8 strokes[strokeCount]          //type | 0x80 if reversed
+//    RuneCaptureMatch matches[matchCount]
+//Records are only appended, a torn last record (crash) is detected by its size or checksum.
+
+#include "boss_runeworder_templates.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+constexpr uint32 RUNECAPTURE_MAGIC = 0x4C435752; //'RWCL'
+constexpr uint16 RUNECAPTURE_VERSION = 1;
+constexpr uint8 RUNECAPTURE_STROKE_REVERSE = 0x80;
+constexpr size_t RUNECAPTURE_MAX_PENDING = 4096; //records waiting for the writer, more are dropped
+
+enum RuneCaptureFlags : uint8
+{
+    RUNECAPTURE_FLAG_FORCED     = 0x01, //rune forced by a GM command, not rolled
+    RUNECAPTURE_FLAG_PACK       = 0x02  //matched against a pattern pack instead of the built-in patterns
+};
+
+struct RuneCaptureFileHeader
+{
+    uint32 magic;
+    uint16 version;
+    uint16 headerSize;
+};
+
+struct RuneCaptureRecordHeader
+{
+    uint64 time;        //unix ms
+    uint32 entry;       //runeworder creature entry
+    uint32 instanceId;
+    int32 roll;         //0 if not rolled
+    int32 rollMax;
+    uint16 mapId;
+    uint8 difficulty;
+    uint8 engine;       //RuneworderEngines
+    uint8 budget;       //error budget
+    uint8 rune;         //RuneTypes, RUNE_INVALID if none
+    uint8 flags;        //RuneCaptureFlags
+    uint8 pointCount;
+    uint8 vertexCount;
+    uint8 angleCount;
+    uint8 strokeCount;
+    uint8 matchCount;
+    uint32 reserved;
+};
+
+struct RuneCaptureMatch
+{
+    uint8 type;
+    uint8 errors;
+    uint8 offset;
+    uint8 coverage;
+    uint8 reversed;
+};
+
+static_assert(sizeof(RuneCaptureFileHeader) == 8, "capture file header layout changed, bump RUNECAPTURE_VERSION");
+static_assert(sizeof(RuneCaptureRecordHeader) == 40, "capture record layout changed, bump RUNECAPTURE_VERSION");
+static_assert(sizeof(RuneCaptureMatch) == 5, "capture match layout changed, bump RUNECAPTURE_VERSION");
+
+//One computed rune
+struct RuneCapture
+{
+    RuneCaptureRecordHeader header = { };
+    RuneTemplatePoints points;
+    std::vector<uint32> vertices;
+    std::vector<int32> angles;
+    Strokes strokes;
+    std::vector<RuneMatch> matches;     //sorted, best first
+};
+
+enum RuneCaptureReadResults
+{
+    RUNECAPTURE_READ_OK,
+    RUNECAPTURE_READ_END,           //no more records
+    RUNECAPTURE_READ_TRUNCATED,     //last record is incomplete, more data may follow
+    RUNECAPTURE_READ_CORRUPT        //bad checksum or counts
+};
+
+//appends the file header to buffer, for new files
+void AppendRuneCaptureFileHeader(std::string& buffer);
+//appends the length-prefixed record to buffer
+void AppendRuneCapture(RuneCapture const& capture, std::string& buffer);
+//parses the record at offset and moves offset past it if it was read
+RuneCaptureReadResults ReadRuneCapture(uint8 const* data, size_t size, size_t& offset, RuneCapture& capture);
+//checks the file header at the start of data, moves offset past it
+bool ReadRuneCaptureFileHeader(uint8 const* data, size_t size, size_t& offset, std::string& error);
+
+//Append-only capture file written by its own thread
+//Push only moves the record to the pending list, the writer thread serializes and writes
+//them in batches, so the map thread never waits for the disk.
+class RuneCaptureLog
+{
+public:
+    RuneCaptureLog() = default;
+    ~RuneCaptureLog() { Close(); }
+
+    RuneCaptureLog(RuneCaptureLog const&) = delete;
+    RuneCaptureLog& operator=(RuneCaptureLog const&) = delete;
+
+    //opens the file for appending and starts the writer, on failure returns false and fills error
+    bool Open(std::string const& fileName, std::string& error);
+    //writes the pending records and stops the writer
+    void Close();
+    bool IsOpen() const { return _file != nullptr; }
+
+    //queues a record, dropped if the writer fell behind
+    void Push(RuneCapture&& capture);
+
+    uint64 GetWritten() const;
+    uint64 GetDropped() const;
+
+private:
+    void _Run();
+
+    FILE* _file = nullptr;
+    std::thread _writer;
+    mutable std::mutex _lock;
+    std::condition_variable _wake;
+    std::vector<RuneCapture> _pending;
+    bool _stopping = false;
+    uint64 _written = 0;
+    uint64 _dropped = 0;
+};
+
+#endif
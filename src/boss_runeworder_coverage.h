@@ -0,0 +1,140 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_COVERAGE_H
+#define BOSS_RUNEWORDER_COVERAGE_H
+
+//Canonical coverage of rune patterns
+//A rune must match each of its canonical sequences with every matcher. A rune matching every canonical
+//of another one shadows it: the other one can never win alone. Built-in runes are checked at compile time
+//(boss_runeworder_tests.h), pack runes by tools/runeworder_packgen.
+
+#include "boss_runeworder_matchers.h"
+#include "boss_runeworder_patterns.h"
+#include <array>
+#include <bit>
+#include <utility>
+#include <vector>
+
+//Canonical sequences of a pattern, by number: every combination of dropped optional slots with each slot
+//on its lowest stroke type, then one sequence per other stroke type of each slot. Empty past the last one
+constexpr Strokes GetRuneCanonical(RunePattern const& pattern, size_t n)
+{
+    uint32 optional = 0;
+    for (uint32 k = 0; k < pattern.size; ++k)
+        if (pattern.strokeSequence[k] & STDEF_CAN_BE_EMPTY)
+            optional |= (1u << k);
+
+    uint32 dropped = 0;
+    int32 variantSlot = -1;
+    uint8 variantType = NO_STROKE;
+    size_t const combinations = size_t(1) << std::popcount(optional);
+    if (n < combinations)
+    {
+        //bits of n spread over the optional slots
+        for (uint32 bits = optional, bit = 0; bits; bits &= bits - 1, ++bit)
+            if (n & (size_t(1) << bit))
+                dropped |= bits & ~(bits - 1);
+    }
+    else
+    {
+        n -= combinations;
+        for (uint32 k = 0; k < pattern.size && variantSlot < 0; ++k)
+        {
+            uint32 types = pattern.strokeSequence[k] & ~(STDEF_CAN_BE_EMPTY | STDEF_REV);
+            for (types &= types - 1; types; types &= types - 1)
+            {
+                if (n--)
+                    continue;
+                variantSlot = int32(k);
+                variantType = uint8(std::countr_zero(types));
+                break;
+            }
+        }
+        if (variantSlot < 0)
+            return { };
+    }
+
+    Strokes sequence;
+    for (uint32 k = 0; k < pattern.size; ++k)
+    {
+        if (dropped & (1u << k))
+            continue;
+        uint32 types = pattern.strokeSequence[k] & ~(STDEF_CAN_BE_EMPTY | STDEF_REV);
+        sequence.push_back(Stroke(int32(k) == variantSlot ? variantType : uint8(std::countr_zero(types)), bool(pattern.strokeSequence[k] & STDEF_REV)));
+    }
+    return sequence;
+}
+
+//every matcher finds the pattern in each of its canonicals without errors, and the candidate index keeps it
+constexpr bool TestRuneCanonicals(RunePattern const& pattern, size_t index, RuneCandidateIndex const& candidates)
+{
+    RuneMatcherFunc const specialized = GetRuneMatcher(pattern);
+    size_t n = 0;
+    for (Strokes seq = GetRuneCanonical(pattern, n); !seq.empty(); seq = GetRuneCanonical(pattern, ++n))
+    {
+        RuneMatchScore score, specializedScore;
+        RuneEncodedSequence encoded;
+        if (!pattern.Matches(seq.data(), seq.size(), score) || score.errors)
+            return false;
+        if (!EncodeRuneSequence(seq.data(), seq.size(), encoded) || (specialized && (!specialized(encoded, specializedScore) || specializedScore.errors)))
+            return false;
+        if (pattern.GetMatchErrors(seq.data(), seq.size(), MAX_RUNE_MATCH_ERRORS))
+            return false;
+        if (!candidates.Candidates(seq).Test(index))
+            return false;
+    }
+    return n > 0;
+}
+
+//patterns matching every canonical of patterns[index] without errors, it can never win alone
+constexpr RunePatternBits GetRuneShadowing(RunePattern const* patterns, size_t count, size_t index)
+{
+    RunePattern const& pattern = patterns[index];
+    std::vector<Strokes> canonicals;
+    for (Strokes seq = GetRuneCanonical(pattern, 0); !seq.empty(); seq = GetRuneCanonical(pattern, canonicals.size()))
+        canonicals.push_back(seq);
+
+    RunePatternBits shadowing;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (i == index)
+            continue;
+
+        bool shadows = true;
+        for (size_t n = 0; shadows && n < canonicals.size(); ++n)
+        {
+            RuneMatchScore score;
+            shadows = patterns[i].Matches(canonicals[n].data(), canonicals[n].size(), score) && !score.errors;
+        }
+        if (shadows)
+            shadowing.Set(i);
+    }
+    return shadowing;
+}
+
+//known shadowing: shadowing pattern, shadowed pattern
+constexpr std::array<std::pair<RuneTypes, RuneTypes>, 16> RuneShadowAllowlist
+{{
+    //REUSE, same strokes
+    { RUNE_UM2, RUNE_UM3 }, { RUNE_UM3, RUNE_UM2 },
+    { RUNE_GUL1, RUNE_GUL2 }, { RUNE_GUL1, RUNE_GUL3 }, { RUNE_GUL2, RUNE_GUL1 },
+    { RUNE_GUL2, RUNE_GUL3 }, { RUNE_GUL3, RUNE_GUL1 }, { RUNE_GUL3, RUNE_GUL2 },
+    { RUNE_CHAM2, RUNE_CHAM3 }, { RUNE_CHAM3, RUNE_CHAM2 },
+    //same rune
+    { RUNE_ORT2, RUNE_ORT1 }, { RUNE_CHAM5, RUNE_CHAM4 },
+    //higher rune wins the tie (GetRuneWeightTier)
+    { RUNE_TIR2, RUNE_JAH3 }, { RUNE_TAL2, RUNE_JAH3 }, { RUNE_TAL1, RUNE_JAH4 }, { RUNE_TAL1, RUNE_JAH5 }
+}};
+
+constexpr bool IsRuneShadowAllowed(RuneTypes shadowing, RuneTypes shadowed)
+{
+    for (auto const& allowed : RuneShadowAllowlist)
+        if (allowed.first == shadowing && allowed.second == shadowed)
+            return true;
+    return false;
+}
+
+#endif
@@ -0,0 +1,311 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_ENCOUNTER_H
+#define BOSS_RUNEWORDER_ENCOUNTER_H
+
+//Encounter timers, phases and events of boss_runeworderAI and npc_rune_carverAI
+//Kept out of boss_runeworder.cpp so the headless encounter simulator (tools/runeworder_encounter)
+//steps the same state machine with the same timings: the event handlers and the melee/speed timers
+//below are templates over the AI, which provides the unit calls (casts, targets, summons), its EventMap and
+//the EventMap time type (Milliseconds, uint32 on older cores).
+
+#include "Define.h"
+#include "boss_runeworder_path.h"
+#include "boss_runeworder_patterns.h"
+
+constexpr uint32 POINT_PUT_DELAY = 2100; //expected time between carve points, see _GetPointStep()
+constexpr uint32 POINT_SAMPLE_INTERVAL = 300; //carver position polling, see RunePointSampler
+constexpr uint32 DEFAULT_RUNE_POINTS = 12;
+
+constexpr uint32 CAST_TIME_SUMMON_CARVER = 1000;
+constexpr uint32 CAST_TIME_ACTIVATE_RUNE = 2000;
+constexpr uint32 CAST_TIME_ACTIVATE_RUNEWORD = 6000;
+
+constexpr uint32 INCINERATE_CHECK_TIMER = 3000;
+constexpr uint32 SPEED_UPDATE_TIMER = 2000;
+
+constexpr float DIST_THRESHOLD = 0.25f;
+
+constexpr uint32 FRENZY_TIMER = 3 * 60 * 1000; //3 minutes
+constexpr float FRENZY_HP_THRESHOLD = 20.f;
+
+enum CarverSpells
+{
+    SPELL_FLAMES                            = 500094
+};
+
+enum RuneworderTexts
+{
+    SAY_AGGRO       = 0,
+    SAY_KILL        = 1,
+    SAY_DEATH       = 2,
+    SAY_RUNEWORD    = 3,
+    SAY_FRENZY      = 4,
+    SAY_RUNE_FAIL   = 5
+};
+
+enum CarverEvents
+{
+    EVENT_FLAMES                = 1
+};
+
+enum RuneworderPhases
+{
+    PHASE_NONE                  = 0,
+    PHASE_FRENZY                = 1
+};
+
+enum RuneworderEvents
+{
+    EVENT_CARVER                = 1,
+    EVENT_POINT_PUT             = 2,
+    EVENT_RUNE_ASSEMBLE         = 3,
+    EVENT_POINTS_UNSUMMON       = 4,
+    EVENT_RUNEWORD_ASSEMBLE     = 5,
+    EVENT_FRENZY                = 6,
+    EVENT_RAIN_OF_FIRE          = 7,
+    EVENT_INCINERATE            = 8,
+    //runewords
+    EVENT_ENIGMA_TELEPORT       = 9,
+    MAX_RUNEWORDER_EVENTS
+};
+
+//RuneworderEncounterAI::_ExecuteEncounterEvent outcome, errors are logged by the AI
+enum RuneworderEventResults
+{
+    RUNEWORDER_EVENT_DONE,
+    RUNEWORDER_EVENT_UNKNOWN,
+    RUNEWORDER_EVENT_NOT_IN_FRENZY  //EVENT_INCINERATE outside frenzy
+};
+
+//spells the boss waits for, others are instant or triggered
+constexpr uint32 GetRuneworderCastTime(uint32 spellId)
+{
+    switch (spellId)
+    {
+        case SPELL_LAUNCH_RUNE_CARVER:  return CAST_TIME_SUMMON_CARVER;
+        case SPELL_ACTIVATE_RUNE:       return CAST_TIME_ACTIVATE_RUNE;
+        case SPELL_RUNEWORD:            return CAST_TIME_ACTIVATE_RUNEWORD;
+        default:                        return 0;
+    }
+}
+
+//boss_runeworderAI state machine
+//AI provides: _Urand(min, max), _Talk(text), _CastSelf(spellId, triggered), _CastOnRandomTarget(spellId) (false
+//without a target), _HasCarver(), _GetCarverPosition(x, y), _DespawnCarver(), _SummonCarvePoint(x, y) (false if
+//not summoned), _GetCarvePointsCount(), _UnsummonPoints(), _GetPointStep(), _ComputateRuneType(),
+//_ComputateRunewordType(), _HasRunewordType(), _GetHealthPct(), _EnigmaTeleport(), and for the timers
+//_IsVictimInMelee(), _SetWalkSpeed(walk), _MeleeAttack(diff), _GetVictimDistance(), _SwitchToNearestTarget(),
+//_IncinerateVictim()
+template<typename AI, typename Events, typename Delay>
+class RuneworderEncounterAI
+{
+protected:
+    //JustEngagedWith
+    void _ScheduleCombatEvents()
+    {
+        _events.Reset();
+        _events.ScheduleEvent(EVENT_CARVER, Delay(_Ai()._Urand(3000, 5000)));
+        _events.ScheduleEvent(EVENT_RAIN_OF_FIRE, Delay(_Ai()._Urand(30000, 40000)));
+        _events.ScheduleEvent(EVENT_FRENZY, Delay(FRENZY_TIMER));
+    }
+
+    RuneworderEventResults _ExecuteEncounterEvent(uint32 eventId)
+    {
+        AI& ai = _Ai();
+        switch (eventId)
+        {
+            case EVENT_CARVER:
+                if (_myphase == PHASE_FRENZY)
+                    break;
+                if (ai._HasCarver() || ai._GetCarvePointsCount())
+                {
+                    //already in progress
+                    _events.ScheduleEvent(EVENT_CARVER, Delay(2000));
+                    break;
+                }
+                if (ai._CastOnRandomTarget(SPELL_LAUNCH_RUNE_CARVER))
+                {
+                    //rune is as long as rune points evenly spaced
+                    float step = ai._GetPointStep();
+                    _carveSampler.Reset(step, step * DIST_THRESHOLD, _runePoints - 1);
+                    _carvePath.Reset(step * DIST_THRESHOLD);
+                    //initial point
+                    _events.ScheduleEvent(EVENT_POINT_PUT, Delay(CAST_TIME_SUMMON_CARVER + 500));
+                    break;
+                }
+                //next attempt
+                _events.ScheduleEvent(EVENT_CARVER, Delay(2000));
+                break;
+            case EVENT_POINT_PUT:
+            {
+                if (!ai._HasCarver())
+                {
+                    _events.ScheduleEvent(EVENT_POINT_PUT, Delay(500));
+                    break;
+                }
+                //adaptive: a path point when the carver traveled a step or turned, summoned unless on a straight run
+                float x, y;
+                ai._GetCarverPosition(x, y);
+                RuneSamples sample = _carveSampler.Update(POINT_SAMPLE_INTERVAL, x, y);
+                if (sample != RUNE_SAMPLE_NONE)
+                    _carvePath.Add(x, y);
+                if (sample == RUNE_SAMPLE_POINT)
+                    ai._SummonCarvePoint(x, y);
+                if (_carveSampler.IsDone())
+                {
+                    ai._DespawnCarver();
+                    _events.ScheduleEvent(EVENT_RUNE_ASSEMBLE, Delay(1000));
+                    break;
+                }
+                _events.ScheduleEvent(EVENT_POINT_PUT, Delay(POINT_SAMPLE_INTERVAL));
+                break;
+            }
+            case EVENT_RUNE_ASSEMBLE:
+                ai._ComputateRuneType();
+                ai._CastSelf(SPELL_ACTIVATE_RUNE, false);
+                _events.ScheduleEvent(EVENT_POINTS_UNSUMMON, Delay(CAST_TIME_ACTIVATE_RUNE + 1000));
+                break;
+            case EVENT_POINTS_UNSUMMON:
+                ai._UnsummonPoints();
+                ai._ComputateRunewordType();
+                if (ai._HasRunewordType())
+                    _events.ScheduleEvent(EVENT_RUNEWORD_ASSEMBLE, Delay(2000));
+                else
+                    _events.ScheduleEvent(EVENT_CARVER, Delay(2000));
+                break;
+            case EVENT_RUNEWORD_ASSEMBLE:
+                ai._Talk(SAY_RUNEWORD);
+                ai._CastSelf(SPELL_RUNEWORD, false);
+                _events.ScheduleEvent(EVENT_CARVER, Delay(CAST_TIME_ACTIVATE_RUNEWORD + 2000));
+                break;
+            case EVENT_FRENZY:
+                if (ai._GetHealthPct() > FRENZY_HP_THRESHOLD)
+                {
+                    //not yet
+                    _events.ScheduleEvent(EVENT_FRENZY, Delay(3000));
+                    break;
+                }
+                _myphase = PHASE_FRENZY;
+                ai._CastSelf(SPELL_FRENZY, true);
+                ai._Talk(SAY_FRENZY);
+                // do not do runes if already in frenzy, fire will do the rest
+                _events.Reset();
+                if (ai._HasCarver())
+                    ai._DespawnCarver();
+                if (ai._GetCarvePointsCount())
+                    ai._UnsummonPoints();
+                // spells active in frenzy
+                _events.ScheduleEvent(EVENT_RAIN_OF_FIRE, Delay(1000));
+                _events.ScheduleEvent(EVENT_INCINERATE, Delay(5000));
+                break;
+            case EVENT_RAIN_OF_FIRE:
+                if (ai._CastOnRandomTarget(SPELL_RAIN_OF_FIRE))
+                {
+                    _events.ScheduleEvent(EVENT_RAIN_OF_FIRE, Delay(_myphase == PHASE_FRENZY ? 6000 : 20000));
+                    break;
+                }
+                _events.ScheduleEvent(EVENT_RAIN_OF_FIRE, Delay(2000)); //delay next attempt
+                break;
+            case EVENT_INCINERATE:
+                if (_myphase != PHASE_FRENZY)
+                    return RUNEWORDER_EVENT_NOT_IN_FRENZY;
+                ai._CastSelf(SPELL_INCINERATE, false);
+                _events.ScheduleEvent(EVENT_INCINERATE, Delay(10000));
+                break;
+            case EVENT_ENIGMA_TELEPORT:
+                ai._EnigmaTeleport();
+                break;
+            default:
+                return RUNEWORDER_EVENT_UNKNOWN;
+        }
+        return RUNEWORDER_EVENT_DONE;
+    }
+
+    //lovely additions: walk in melee, melee attacks or AoE if no nearby target
+    void _UpdateEncounterTimers(uint32 diff)
+    {
+        AI& ai = _Ai();
+        bool inMelee = ai._IsVictimInMelee();
+        if (inMelee || _speedUpdateTimer >= SPEED_UPDATE_TIMER)
+        {
+            _speedUpdateTimer = 0;
+            if (_isWalking != inMelee)
+            {
+                ai._SetWalkSpeed(inMelee && _myphase != PHASE_FRENZY);
+                _isWalking = inMelee;
+            }
+        }
+        else
+            _speedUpdateTimer += diff;
+
+        if (inMelee)
+        {
+            ai._MeleeAttack(diff);
+            _incinerateTimer = 0;
+        }
+        else if (_incinerateFirstDelay > 10000)
+        {
+            if (_incinerateTimer >= INCINERATE_CHECK_TIMER)
+            {
+                _incinerateTimer = 0;
+                bool toofar = ai._GetVictimDistance() > 15.f;
+                if (toofar && ai._SwitchToNearestTarget())
+                    return;
+                if (toofar)
+                    ai._IncinerateVictim();
+            }
+            else
+                _incinerateTimer += diff;
+        }
+        else
+            _incinerateFirstDelay += diff;
+    }
+
+    Events _events;
+    uint32 _myphase = PHASE_NONE;
+    uint32 _runePoints = DEFAULT_RUNE_POINTS;
+    uint32 _incinerateTimer = 0;
+    uint32 _incinerateFirstDelay = 0;
+    uint32 _speedUpdateTimer = 0;
+    bool _isWalking = false;
+    RunePathSimplifier _carvePath;
+    RunePointSampler _carveSampler;
+
+private:
+    AI& _Ai() { return static_cast<AI&>(*this); }
+};
+
+//npc_rune_carverAI events
+//AI provides: _IsStandingInMelee(victim), _CastFlames()
+template<typename AI, typename Events, typename Delay>
+class RuneCarverEncounterAI
+{
+protected:
+    //IsSummonedBy
+    void _ScheduleCarverEvents()
+    {
+        _events.ScheduleEvent(EVENT_FLAMES, Delay(2000));
+    }
+
+    //false for unknown events
+    template<typename Victim>
+    bool _ExecuteEncounterEvent(uint32 eventId, Victim victim)
+    {
+        if (eventId != EVENT_FLAMES)
+            return false;
+
+        AI& ai = static_cast<AI&>(*this);
+        if (ai._IsStandingInMelee(victim))
+            ai._CastFlames();
+        _events.ScheduleEvent(EVENT_FLAMES, Delay(1000));
+        return true;
+    }
+
+    Events _events;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_MATCHERS_H
+#define BOSS_RUNEWORDER_MATCHERS_H
+
+//Per-pattern specialized matchers
+//Every built-in rune gets its own RunePattern::Matches: slots are unrolled at compile time, masks are immediates
+//and optional slot branches only exist where the slot is optional. Runes without optional slots use the
+//word-level RuneFixedMatch on constant masks. Results are the same as the generic matcher (RUNE_MATCHER_DIFF_TESTS,
+//tools/runeworder_fuzz.cpp). Pack runes use them only if their strokes are the built-in ones.
+
+#include "boss_runeworder_patterns.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+typedef bool (*RuneMatcherFunc)(RuneEncodedSequence const& seq, RuneMatchScore& score);
+
+template<size_t I>
+struct RuneSpecializedMatcher
+{
+    static constexpr RunePattern const& Pattern = RunePatterns[I];
+    static constexpr int32 Size = Pattern.size;
+    static constexpr int32 MinSize = Pattern.minSize;
+    static constexpr bool HasOptional = MinSize < Size;
+
+    static constexpr uint32 GetMask(int32 k) { return Pattern.strokeSequence[k]; }
+
+    static constexpr bool Matches(RuneEncodedSequence const& seq, RuneMatchScore& score)
+    {
+        int32 seqsize = seq.size;
+        if (MinSize > seqsize)
+            return false; //impossible
+
+        if constexpr (!HasOptional)
+            return _MatchesFixed(seq, score);
+
+        //positions of each slot's types, once for all starts
+        std::array<uint64, Size> const types = [&]<int32... K>(std::integer_sequence<int32, K...>)
+        {
+            return std::array<uint64, Size>{ _GetTypes<GetMask(K) & ~STDEF_REV>(seq)... };
+        }(std::make_integer_sequence<int32, Size>());
+
+        uint64 const first = types[0];
+        bool found = false;
+        bool reverseMatch = false;
+        RuneMatchScore reverseScore;
+        for (int32 i = 0; i + MinSize <= seqsize; ++i)
+        {
+            if (first & (uint64(1) << i))
+            {
+                found = true;
+                if (_MatchFrom<1>(seq, types, i, score))
+                    return true;
+            }
+
+            int32 r = seqsize - 1 - i;
+            if (!reverseMatch && (first & (uint64(1) << r)))
+                reverseMatch = _MatchFrom<-1>(seq, types, r, reverseScore);
+
+            if (found && reverseMatch)
+            {
+                score = reverseScore;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    enum SlotResult
+    {
+        SLOT_NEXT,      //go on with the next slot
+        SLOT_END,       //sequence ended before the slot
+        SLOT_FAIL
+    };
+
+    //RunePattern::_MatchesFrom, one call per slot so the unrolled code stays linear in pattern size
+    template<int32 Step>
+    static constexpr bool _MatchFrom(RuneEncodedSequence const& seq, std::array<uint64, Size> const& types, int32 start, RuneMatchScore& score)
+    {
+        int32 j = start + Step;
+        uint32 unmatchCount = 0;
+        int32 coverage = Size;
+        SlotResult result = SLOT_NEXT;
+        [&]<int32... K>(std::integer_sequence<int32, K...>)
+        {
+            ((result == SLOT_NEXT && (result = _MatchSlot<K + 1, Step>(seq, types, j, unmatchCount)) == SLOT_END ? (coverage = K + 1) : 0), ...);
+        }(std::make_integer_sequence<int32, Size - 1>());
+
+        if (result == SLOT_FAIL)
+            return false;
+
+        score.errors = uint8(unmatchCount);
+        score.offset = uint8(j - Step);
+        score.coverage = uint8(coverage);
+        score.reversed = Step < 0;
+        return true;
+    }
+
+    //sequence positions of the mask types (stroke mask bits, empty stroke included)
+    template<uint32 Mask>
+    static constexpr uint64 _GetTypes(RuneEncodedSequence const& seq)
+    {
+        uint64 positions = 0;
+        [&]<uint8... T>(std::integer_sequence<uint8, T...>)
+        {
+            ((positions |= (Mask & (1 << T)) ? seq.positions[T] : 0), ...);
+        }(std::make_integer_sequence<uint8, TURN_REVERSE>());
+        return positions;
+    }
+
+    //GetRuneAcceptedPositions unrolled over the slot types
+    template<int32 K>
+    static constexpr uint64 _GetAccepted(RuneEncodedSequence const& seq)
+    {
+        uint64 accepted = _GetTypes<GetMask(K) & ~STDEF_CAN_BE_EMPTY>(seq);
+        if constexpr (K == 0)
+            return accepted;
+        else if constexpr (bool(GetMask(K) & STDEF_REV))
+            return accepted & seq.reversed;
+        else
+            return accepted & ~seq.reversed;
+    }
+
+    //RuneFixedMatch with the slot masks as constants
+    static constexpr bool _MatchesFixed(RuneEncodedSequence const& seq, RuneMatchScore& score)
+    {
+        RuneFixedMatch match(seq, Size);
+        match.SetFirst(_GetAccepted<0>(seq));
+        [&]<int32... K>(std::integer_sequence<int32, K...>)
+        {
+            (match.AddSlot(K + 1, _GetAccepted<K + 1>(seq)), ...);
+        }(std::make_integer_sequence<int32, Size - 1>());
+        return match.GetScore(score);
+    }
+
+    //j is the sequence index checked against slot K, moves on unless the slot is skipped
+    template<int32 K, int32 Step>
+    static constexpr SlotResult _MatchSlot(RuneEncodedSequence const& seq, std::array<uint64, Size> const& types, int32& j, uint32& unmatchCount)
+    {
+        int32 seqsize = seq.size;
+        if (j < 0 || j >= seqsize)
+            return SLOT_END;
+
+        constexpr uint32 thisMask = GetMask(K) & ~STDEF_REV;
+        constexpr bool thisRev = GetMask(K) & STDEF_REV;
+        constexpr bool optional = thisMask & STDEF_CAN_BE_EMPTY;
+        uint64 const position = uint64(1) << j;
+
+        //we may want to skip current node in own sequence
+        if constexpr (optional && K < Size - 1)
+            if (seqsize < Size && (types[K + 1] & position))
+                return SLOT_NEXT;
+
+        //reversing alterations
+        bool revEqCur = thisRev == bool(seq.reversed & position);
+        if (!revEqCur || !(types[K] & position))
+        {
+            //can skip point in own sequence
+            if constexpr (optional)
+                if (bool(thisMask & ST_LINETYPES) || revEqCur)
+                    return SLOT_NEXT;
+
+            //same stroke types as the reference check
+            if ((seq.positions[LINE_REV] | seq.positions[CURVE_M]) & position) //(1 << ST_LINE) | (1 << ST_LINE_REV)
+                return SLOT_FAIL;
+            if (++unmatchCount > UNMATCH_THRESHOLD)
+                return SLOT_FAIL;
+        }
+
+        j += Step;
+        return SLOT_NEXT;
+    }
+};
+
+static_assert([]
+{
+    for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+        if (RunePatterns[i].type != i)
+            return false;
+    return true;
+}(), "built-in patterns must follow rune types");
+
+template<size_t... I>
+constexpr std::array<RuneMatcherFunc, sizeof...(I)> BuildRuneMatchers(std::index_sequence<I...>)
+{
+    return { &RuneSpecializedMatcher<I>::Matches... };
+}
+
+//by built-in pattern index
+constexpr std::array<RuneMatcherFunc, MAX_RUNE_TYPES> RuneMatchers = BuildRuneMatchers(std::make_index_sequence<MAX_RUNE_TYPES>());
+
+//specialized matcher if the pattern is a built-in one, nullptr otherwise
+constexpr RuneMatcherFunc GetRuneMatcher(RunePattern const& pattern)
+{
+    if (pattern.type >= MAX_RUNE_TYPES)
+        return nullptr;
+
+    RunePattern const& builtIn = RunePatterns[pattern.type];
+    if (builtIn.type != pattern.type || builtIn.size != pattern.size || builtIn.minSize != pattern.minSize)
+        return nullptr;
+    for (uint8 k = 0; k < pattern.size; ++k)
+        if (builtIn.strokeSequence[k] != pattern.strokeSequence[k])
+            return nullptr;
+    return RuneMatchers[pattern.type];
+}
+
+#endif
@@ -0,0 +1,319 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#include "boss_runeworder_pack.h"
+#include <cstring>
+
+#ifdef _WIN32
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+RunePack::~RunePack()
+{
+    _Unmap();
+}
+
+bool RunePack::Load(std::string const& fileName, std::string& error)
+{
+    _Unmap();
+
+    if (!_Map(fileName, error))
+        return false;
+
+    if (!_Validate(error))
+    {
+        _Unmap();
+        return false;
+    }
+
+    return true;
+}
+
+bool RunePack::_Map(std::string const& fileName, std::string& error)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < LONGLONG(sizeof(RunePackHeader)))
+    {
+        CloseHandle(file);
+        error = "file is too small";
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void const* data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data)
+    {
+        if (mapping)
+            CloseHandle(mapping);
+        CloseHandle(file);
+        error = "cannot map file";
+        return false;
+    }
+
+    _file = file;
+    _mapping = mapping;
+    _data = static_cast<uint8 const*>(data);
+    _size = size_t(fileSize.QuadPart);
+#else
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = "cannot open file";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(RunePackHeader)))
+    {
+        close(fd);
+        error = "file is too small";
+        return false;
+    }
+
+    //shared read-only mapping, pages are shared between all processes mapping the same file
+    void* data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        error = "cannot map file";
+        return false;
+    }
+
+    _data = static_cast<uint8 const*>(data);
+    _size = size_t(st.st_size);
+#endif
+
+    return true;
+}
+
+void RunePack::_Unmap()
+{
+    _runes.clear();
+    _runewords.clear();
+    _runeNames.clear();
+    _runewordNames.clear();
+    _candidates = RuneCandidateIndex();
+    _runewordIndex = RunewordRuneIndex();
+    _matchTable = RuneMatchTable();
+    _strings = nullptr;
+
+    if (!_data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(_data);
+    CloseHandle(HANDLE(_mapping));
+    CloseHandle(HANDLE(_file));
+    _mapping = nullptr;
+    _file = nullptr;
+#else
+    munmap(const_cast<uint8*>(_data), _size);
+#endif
+
+    _data = nullptr;
+    _size = 0;
+}
+
+bool RunePack::_IsSection(uint32 offset, uint64 count, size_t elemSize) const
+{
+    return offset % 8 == 0 && offset >= sizeof(RunePackHeader) && offset <= _size &&
+        count <= (_size - offset) / elemSize;
+}
+
+bool RunePack::_Validate(std::string& error)
+{
+    RunePackHeader const* header = reinterpret_cast<RunePackHeader const*>(_data);
+
+    if (header->magic != RUNEPACK_MAGIC)
+    {
+        error = "not a rune pattern pack";
+        return false;
+    }
+    if (header->version != RUNEPACK_VERSION || header->headerSize != sizeof(RunePackHeader))
+    {
+        error = "unsupported pack version " + std::to_string(header->version) + ", expected " + std::to_string(RUNEPACK_VERSION);
+        return false;
+    }
+    if (header->fileSize != _size)
+    {
+        error = "file size mismatch";
+        return false;
+    }
+    if (header->checksum != RunePackChecksum(_data + sizeof(RunePackHeader), _size - sizeof(RunePackHeader)))
+    {
+        error = "checksum mismatch";
+        return false;
+    }
+
+    if (!header->runeCount || header->runeCount > MAX_RUNE_PATTERNS || header->runewordCount > MAX_RUNE_PATTERNS ||
+        !_IsSection(header->runeOffset, header->runeCount, sizeof(RunePackRune)) ||
+        !_IsSection(header->runewordOffset, header->runewordCount, sizeof(RunePackRuneword)) ||
+        !_IsSection(header->maskOffset, header->maskCount, sizeof(uint16)) ||
+        !_IsSection(header->spellOffset, header->spellCount, sizeof(uint32)) ||
+        !_IsSection(header->stringsOffset, header->stringsSize, 1) ||
+        !header->stringsSize || _data[header->stringsOffset + header->stringsSize - 1] != '\0')
+    {
+        error = "malformed section table";
+        return false;
+    }
+
+    RunePackRune const* runes = reinterpret_cast<RunePackRune const*>(_data + header->runeOffset);
+    RunePackRuneword const* runewords = reinterpret_cast<RunePackRuneword const*>(_data + header->runewordOffset);
+    StrokeTypeDefs const* masks = reinterpret_cast<StrokeTypeDefs const*>(_data + header->maskOffset);
+    RuneworderSpells const* spells = reinterpret_cast<RuneworderSpells const*>(_data + header->spellOffset);
+
+    _runes.reserve(header->runeCount);
+    _runeNames.reserve(header->runeCount);
+    for (uint32 i = 0; i < header->runeCount; ++i)
+    {
+        RunePackRune const& rune = runes[i];
+        if (rune.type >= MAX_RUNE_TYPES || rune.size < MIN_RUNE_PATTERN_LENGTH || rune.size > MAX_RUNE_PATTERN_LENGTH ||
+            rune.maskIndex > header->maskCount || rune.size > header->maskCount - rune.maskIndex ||
+            rune.nameOffset >= header->stringsSize)
+        {
+            error = "malformed rune " + std::to_string(i);
+            return false;
+        }
+
+        StrokeTypeDefs const* sequence = masks + rune.maskIndex;
+        uint8 minSize = 0;
+        for (uint8 j = 0; j < rune.size; ++j)
+            if (!(sequence[j] & STDEF_CAN_BE_EMPTY))
+                ++minSize;
+
+        if (minSize != rune.minSize || (sequence[0] & (STDEF_REV | STDEF_CAN_BE_EMPTY)))
+        {
+            error = "malformed rune " + std::to_string(i);
+            return false;
+        }
+
+        _runes.emplace_back(rune.type, sequence, rune.size, rune.minSize);
+        _runeNames.push_back(rune.nameOffset);
+    }
+
+    _runewords.reserve(header->runewordCount);
+    _runewordNames.reserve(header->runewordCount);
+    for (uint32 i = 0; i < header->runewordCount; ++i)
+    {
+        RunePackRuneword const& runeword = runewords[i];
+        if (runeword.type >= MAX_RUNEWORD_TYPES || runeword.size < MIN_RUNEWORD_LENGTH || runeword.size > MAX_RUNEWORD_LENGTH ||
+            runeword.spellIndex > header->spellCount || runeword.size > header->spellCount - runeword.spellIndex ||
+            runeword.nameOffset >= header->stringsSize)
+        {
+            error = "malformed runeword " + std::to_string(i);
+            return false;
+        }
+
+        for (uint32 j = 0; j < runeword.size; ++j)
+        {
+            if (!IsRuneSpell(spells[runeword.spellIndex + j]))
+            {
+                error = "malformed runeword " + std::to_string(i);
+                return false;
+            }
+        }
+
+        _runewords.emplace_back(runeword.type, spells + runeword.spellIndex, runeword.size);
+        _runewordNames.push_back(runeword.nameOffset);
+    }
+
+    //candidate bits index the runes and their matchers, so never take them from the file
+    _candidates = BuildCandidateIndex(_runes.data(), _runes.size());
+    _runewordIndex = BuildRunewordRuneIndex(_runewords.data(), _runewords.size());
+    _strings = reinterpret_cast<char const*>(_data + header->stringsOffset);
+    return _ValidateTable(error);
+}
+
+bool RunePack::_ValidateTable(std::string& error)
+{
+    RunePackHeader const* header = reinterpret_cast<RunePackHeader const*>(_data);
+    if (!header->tableOffset)
+        return true;
+
+    if (!_IsSection(header->tableOffset, 1, sizeof(RunePackTable)))
+    {
+        error = "malformed match table";
+        return false;
+    }
+
+    RunePackTable const* table = reinterpret_cast<RunePackTable const*>(_data + header->tableOffset);
+    if (table->minLength < MIN_RUNE_PATTERN_LENGTH || table->maxLength > MAX_RUNE_TABLE_LENGTH || table->minLength > table->maxLength)
+    {
+        error = "malformed match table";
+        return false;
+    }
+
+    uint64 wordCount = GetRuneTableWords(table->minLength, table->maxLength);
+    if (!_IsSection(table->wordsOffset, wordCount, sizeof(uint64)) ||
+        !_IsSection(table->ranksOffset, wordCount / RUNE_TABLE_RANK_WORDS + 1, sizeof(uint32)) ||
+        !_IsSection(table->matchSetsOffset, table->matchCount, sizeof(uint16)) ||
+        !_IsSection(table->setsOffset, table->setCount, sizeof(RunePatternBits)))
+    {
+        error = "malformed match table";
+        return false;
+    }
+
+    //lookups trust ranks and set indices, check them once here
+    uint64 const* words = reinterpret_cast<uint64 const*>(_data + table->wordsOffset);
+    uint32 const* ranks = reinterpret_cast<uint32 const*>(_data + table->ranksOffset);
+    uint16 const* matchSets = reinterpret_cast<uint16 const*>(_data + table->matchSetsOffset);
+    RunePatternBits const* sets = reinterpret_cast<RunePatternBits const*>(_data + table->setsOffset);
+    uint64 rank = 0;
+    for (uint64 i = 0; i < wordCount; ++i)
+    {
+        if (i % RUNE_TABLE_RANK_WORDS == 0 && ranks[i / RUNE_TABLE_RANK_WORDS] != rank)
+        {
+            error = "malformed match table ranks";
+            return false;
+        }
+        rank += uint64(std::popcount(words[i]));
+    }
+    if (rank != table->matchCount)
+    {
+        error = "malformed match table ranks";
+        return false;
+    }
+
+    for (uint32 i = 0; i < table->matchCount; ++i)
+    {
+        if (matchSets[i] >= table->setCount)
+        {
+            error = "malformed match table sets";
+            return false;
+        }
+    }
+
+    for (uint32 i = 0; i < table->setCount; ++i)
+    {
+        bool outOfRange = false;
+        sets[i].ForEach([&](size_t rune) { outOfRange |= rune >= _runes.size(); });
+        if (outOfRange)
+        {
+            error = "malformed match table sets";
+            return false;
+        }
+    }
+
+    _matchTable.minLength = table->minLength;
+    _matchTable.maxLength = table->maxLength;
+    _matchTable.words = words;
+    _matchTable.ranks = ranks;
+    _matchTable.matchSets = matchSets;
+    _matchTable.sets = sets;
+    return true;
+}
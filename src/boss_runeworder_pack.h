@@ -0,0 +1,145 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_PACK_H
+#define BOSS_RUNEWORDER_PACK_H
+
+//Binary pattern pack
+//Compiled rune and runeword tables, mapped read-only so several worldservers
+//on one host share the same physical pages. Built offline by tools/runeworder_packgen.
+//
+//Layout (little-endian, every section 8-byte aligned):
+//  RunePackHeader
+//  RunePackRune[runeCount]
+//  RunePackRuneword[runewordCount]
+//  uint16 masks[maskCount]               //StrokeTypeDefs, referenced by runes
+//  uint32 spells[spellCount]             //RuneworderSpells, referenced by runewords
+//  char strings[stringsSize]             //NUL-terminated descriptors
+//  RunePackTable, words, ranks, matchSets, sets    //optional exhaustive match table (boss_runeworder_table.h)
+//The candidate and runeword indexes are rebuilt from the runes at load, not trusted from the file.
+
+#include "boss_runeworder_patterns.h"
+#include "boss_runeworder_table.h"
+#include <string>
+#include <type_traits>
+
+constexpr uint32 RUNEPACK_MAGIC = 0x4B505752; //'RWPK'
+constexpr uint16 RUNEPACK_VERSION = 7; //2: runewords up to 6 runes, 3: candidate index, 4: patterns up to 32 strokes, 5: match table, 6: uint16 masks,
+                                       //7: candidate index dropped, rebuilt at load
+
+struct RunePackHeader
+{
+    uint32 magic;
+    uint16 version;
+    uint16 headerSize;
+    uint32 fileSize;
+    uint32 checksum; //FNV-1a of everything past the header
+    uint32 runeCount;
+    uint32 runeOffset;
+    uint32 runewordCount;
+    uint32 runewordOffset;
+    uint32 maskCount;
+    uint32 maskOffset;
+    uint32 spellCount;
+    uint32 spellOffset;
+    uint32 reserved;      //candidate index offset before version 7
+    uint32 stringsSize;
+    uint32 stringsOffset;
+    uint32 tableOffset; //RunePackTable, 0 if the pack has no match table
+};
+
+struct RunePackRune
+{
+    uint8 type;
+    uint8 size;
+    uint8 minSize;
+    uint8 reserved;
+    uint32 maskIndex;
+    uint32 nameOffset;
+};
+
+struct RunePackRuneword
+{
+    uint8 type;
+    uint8 size;
+    uint16 reserved;
+    uint32 spellIndex;
+    uint32 nameOffset;
+};
+
+struct RunePackTable
+{
+    uint8 minLength;
+    uint8 maxLength;
+    uint16 setCount;
+    uint32 matchCount;
+    uint32 wordsOffset;     //uint64[wordCount], wordCount = ceil(sequences / 64)
+    uint32 ranksOffset;     //uint32[wordCount / RUNE_TABLE_RANK_WORDS + 1]
+    uint32 matchSetsOffset; //uint16[matchCount]
+    uint32 setsOffset;      //RunePatternBits[setCount]
+};
+
+static_assert(sizeof(RunePackHeader) == 64, "pack header layout changed, bump RUNEPACK_VERSION");
+static_assert(sizeof(RunePackRune) == 12, "pack rune layout changed, bump RUNEPACK_VERSION");
+static_assert(sizeof(RunePackRuneword) == 12, "pack runeword layout changed, bump RUNEPACK_VERSION");
+static_assert(sizeof(RunePackTable) == 24, "pack table layout changed, bump RUNEPACK_VERSION");
+static_assert(sizeof(StrokeTypeDefs) == sizeof(uint16), "masks are stored as uint16");
+static_assert(sizeof(RuneworderSpells) == sizeof(uint32), "spells are stored as uint32");
+static_assert(std::is_trivially_copyable_v<RunePatternBits> && sizeof(RunePatternBits) % 8 == 0, "match sets are stored raw");
+
+constexpr uint32 RunePackChecksum(uint8 const* data, size_t size)
+{
+    uint32 hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+        hash = (hash ^ data[i]) * 16777619u;
+    return hash;
+}
+
+//Read-only mapping of a pattern pack, patterns point straight into the mapped pages
+class RunePack
+{
+public:
+    RunePack() = default;
+    ~RunePack();
+
+    RunePack(RunePack const&) = delete;
+    RunePack& operator=(RunePack const&) = delete;
+
+    //maps and validates the file, on failure returns false and fills error
+    bool Load(std::string const& fileName, std::string& error);
+
+    std::vector<RunePattern> const& GetRunePatterns() const { return _runes; }
+    std::vector<RunewordPattern> const& GetRunewordPatterns() const { return _runewords; }
+    RuneCandidateIndex const& GetCandidateIndex() const { return _candidates; }
+    RunewordRuneIndex const& GetRunewordIndex() const { return _runewordIndex; }
+    RuneMatchTable const& GetMatchTable() const { return _matchTable; }
+    char const* GetRuneName(size_t i) const { return _strings + _runeNames[i]; }
+    char const* GetRunewordName(size_t i) const { return _strings + _runewordNames[i]; }
+
+private:
+    bool _Map(std::string const& fileName, std::string& error);
+    bool _IsSection(uint32 offset, uint64 count, size_t elemSize) const;
+    bool _Validate(std::string& error);
+    bool _ValidateTable(std::string& error);
+    void _Unmap();
+
+    uint8 const* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+
+    std::vector<RunePattern> _runes;
+    std::vector<RunewordPattern> _runewords;
+    std::vector<uint32> _runeNames;
+    std::vector<uint32> _runewordNames;
+    RuneCandidateIndex _candidates;
+    RunewordRuneIndex _runewordIndex;
+    RuneMatchTable _matchTable;
+    char const* _strings = nullptr;
+};
+
+#endif
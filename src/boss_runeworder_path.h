@@ -0,0 +1,219 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_PATH_H
+#define BOSS_RUNEWORDER_PATH_H
+
+#include "Define.h"
+#include <cmath>
+#include <vector>
+
+constexpr uint32 RUNE_SAMPLE_MIN_DELAY = 700;
+constexpr uint32 RUNE_SAMPLE_MAX_DELAY = 4200; //per step of carve length, a stalled carver still ends the carve
+constexpr float RUNE_SAMPLE_TURN_DEGREES = 40.f; //heading change (from last segment) placing a point early
+constexpr float RUNE_SAMPLE_TURN_DIST = 0.5f; //part of a step to travel before a turn counts
+constexpr float RUNE_SAMPLE_HEADING_DIST = 0.1f; //part of a step the carver heading is measured over
+constexpr float RUNE_SAMPLE_LINE_DEGREES = 9.f; //heading change (from last summoned point) still on a line, see LINE
+
+struct RunePathPoint
+{
+    float x;
+    float y;
+};
+
+typedef std::vector<RunePathPoint> RunePathPoints;
+
+//Streaming radial-distance simplification of the carve path
+//A sampled point becomes a vertex only if it is far enough from the last vertex, so clustered points
+//(carver stopped, rooted or kited in place) collapse into one vertex. Vertices never change once added,
+//lines are kept (no collinearity pass), they are strokes of their own.
+class RunePathSimplifier
+{
+public:
+    void Reset(float tolerance)
+    {
+        _tolerance = tolerance;
+        _points.clear();
+        _vertices.clear();
+    }
+
+    //returns true if the point was kept as vertex
+    bool Add(float x, float y)
+    {
+        _points.push_back({ x, y });
+        if (!_vertices.empty())
+        {
+            float dx = x - _lastX, dy = y - _lastY;
+            if (dx * dx + dy * dy < _tolerance * _tolerance)
+                return false;
+        }
+
+        _vertices.push_back(uint32(_points.size() - 1));
+        _lastX = x;
+        _lastY = y;
+        return true;
+    }
+
+    //every sampled point of the carve, the rune is recognized from these, not from the summoned ones
+    RunePathPoints const& GetPoints() const { return _points; }
+    //indices of the points kept as vertices
+    std::vector<uint32> const& GetVertices() const { return _vertices; }
+
+private:
+    RunePathPoints _points;
+    std::vector<uint32> _vertices;
+    float _tolerance = 0.f;
+    float _lastX = 0.f;
+    float _lastY = 0.f;
+};
+
+enum RuneSamples
+{
+    RUNE_SAMPLE_NONE            = 0,
+    RUNE_SAMPLE_VERTEX          = 1, //path point on a straight run, nothing to summon
+    RUNE_SAMPLE_POINT           = 2  //path point summoned as carve point
+};
+
+//Adaptive carve point sampling, polled while the carver moves
+//A path point is due once the carver traveled a full step (lines are strokes, so straight runs keep one per step),
+//or once it turned away from the last segment: the point is then put on the corner (previous tracked position),
+//so a turn lands on one vertex instead of being split between two.
+//Only the start, the corners, the end and path points off the line from the last summoned point are summoned,
+//a straight run is one segment. The carve ends once the carver traveled steps * step, or after max delay per step.
+class RunePointSampler
+{
+public:
+    void Reset(float step, float minDist, uint32 steps)
+    {
+        _step = step;
+        _minDist = minDist;
+        _length = step * steps;
+        _traveled = 0.f;
+        _maxTime = steps * RUNE_SAMPLE_MAX_DELAY;
+        _time = 0;
+        _elapsed = 0;
+        _points = 0;
+        _done = false;
+    }
+
+    //sample due now, x and y are moved to the point position
+    RuneSamples Update(uint32 diff, float& x, float& y)
+    {
+        if (_done)
+            return RUNE_SAMPLE_NONE;
+
+        _time += diff;
+        _elapsed += diff;
+        if (!_points)
+            return _Summon(x, y);
+
+        float tx = x - _trackX, ty = y - _trackY;
+        _traveled += std::sqrt(tx * tx + ty * ty);
+        _trackX = x;
+        _trackY = y;
+        if (_traveled >= _length || _time >= _maxTime)
+        {
+            //last point
+            _done = true;
+            return _Summon(x, y);
+        }
+
+        float mx = x - _prevX, my = y - _prevY;
+        float headingDist = _step * RUNE_SAMPLE_HEADING_DIST;
+        if (mx * mx + my * my < headingDist * headingDist) //not moving
+            return RUNE_SAMPLE_NONE;
+
+        bool due = false;
+        if (_elapsed >= RUNE_SAMPLE_MIN_DELAY)
+        {
+            float cx = _prevX - _lastX, cy = _prevY - _lastY;
+            float chord = std::sqrt(cx * cx + cy * cy);
+            if (chord >= _minDist && chord >= _step * RUNE_SAMPLE_TURN_DIST &&
+                GetHeadingChange(std::atan2(cy, cx), std::atan2(my, mx)) >= RUNE_SAMPLE_TURN_DEGREES)
+            {
+                //corner
+                float fromX = x, fromY = y;
+                x = _prevX;
+                y = _prevY;
+                _Summon(x, y);
+                _prevX = fromX;
+                _prevY = fromY;
+                return RUNE_SAMPLE_POINT;
+            }
+
+            float dx = x - _lastX, dy = y - _lastY;
+            due = dx * dx + dy * dy >= _step * _step;
+        }
+
+        if (due)
+        {
+            //still heading along the line from the last summoned point
+            float sx = x - _summonX, sy = y - _summonY;
+            if (GetHeadingChange(std::atan2(sy, sx), std::atan2(my, mx)) < RUNE_SAMPLE_LINE_DEGREES)
+            {
+                _Place(x, y);
+                return RUNE_SAMPLE_VERTEX;
+            }
+            return _Summon(x, y);
+        }
+
+        _prevX = x;
+        _prevY = y;
+        return RUNE_SAMPLE_NONE;
+    }
+
+    //last point is sampled
+    bool IsDone() const { return _done; }
+
+    //degrees between two headings (radians)
+    static float GetHeadingChange(float from, float to)
+    {
+        return std::fabs(std::remainder(to - from, 2.f * PI)) * 180.f / PI;
+    }
+
+private:
+    static constexpr float PI = 3.14159265f;
+
+    void _Place(float x, float y)
+    {
+        if (!_points)
+        {
+            _trackX = x;
+            _trackY = y;
+        }
+        _lastX = _prevX = x;
+        _lastY = _prevY = y;
+        _elapsed = 0;
+        ++_points;
+    }
+
+    RuneSamples _Summon(float x, float y)
+    {
+        _Place(x, y);
+        _summonX = x;
+        _summonY = y;
+        return RUNE_SAMPLE_POINT;
+    }
+
+    float _step = 0.f;
+    float _minDist = 0.f;
+    float _length = 0.f;
+    float _traveled = 0.f;
+    float _trackX = 0.f;
+    float _trackY = 0.f;
+    float _summonX = 0.f;
+    float _summonY = 0.f;
+    float _lastX = 0.f;
+    float _lastY = 0.f;
+    float _prevX = 0.f;
+    float _prevY = 0.f;
+    uint32 _maxTime = 0;
+    uint32 _time = 0;
+    uint32 _elapsed = 0;
+    uint32 _points = 0;
+    bool _done = false;
+};
+
+#endif
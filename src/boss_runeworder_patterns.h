@@ -0,0 +1,2293 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_PATTERNS_H
+#define BOSS_RUNEWORDER_PATTERNS_H
+
+//Rune and runeword pattern tables, kept free of game core dependencies
+//so offline tools (pack generator) can share them with the module
+
+#include "Define.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+constexpr uint32 UNMATCH_THRESHOLD = 1;
+constexpr uint32 MAX_RUNE_MATCH_ERRORS = 4; //approximate matcher error budget cap
+
+constexpr uint32 WEIGHT_RUNE_LOW = 2;
+constexpr uint32 WEIGHT_RUNE_MID = 3;
+constexpr uint32 WEIGHT_RUNE_HI = 4;
+
+constexpr size_t MIN_RUNE_PATTERN_LENGTH = 5;
+constexpr size_t MAX_RUNE_PATTERN_LENGTH = 32; //approximate matcher keeps one bit per slot
+constexpr size_t MAX_RUNE_POINTS = 64;
+constexpr size_t MAX_RUNE_SEQUENCE_LENGTH = MAX_RUNE_POINTS - 2; //longest stroke sequence checked against patterns
+static_assert(MAX_RUNE_PATTERN_LENGTH <= 32 && MAX_RUNE_POINTS <= 255, "slot bits and match offsets are uint32 and uint8");
+
+constexpr size_t MIN_RUNEWORD_LENGTH = 2;
+constexpr size_t MAX_RUNEWORD_LENGTH = 6;
+
+enum RuneworderSpells : uint32
+{
+    SPELL_COSMETIC_SCALE                    = 500096, //scale aura, visual only
+    SPELL_COSMETIC_FLAMES                   = 500097, //dummy aura, visual only
+    SPELL_FRENZY                            = 500098, //spelldam/attspeed/scale 75%/150%/25%
+    SPELL_RUNIC_WITHDRAWAL                  = 500000, //enrage physdam/attspeed 25%/15%, stacks
+    SPELL_LAUNCH_RUNE_CARVER                = 500001,
+    SPELL_ACTIVATE_RUNE                     = 500002,
+    SPELL_RUNEWORD                          = 500003,
+    SPELL_VISUAL_RUNE_ACTIVATION            = 500004,
+    SPELL_INCINERATE                        = 500005,
+    SPELL_RAIN_OF_FIRE                      = 500095,
+    SPELL_VISUAL_RUNE_CHANNEL               = 500006,
+
+    //runes
+    //All rune base spells should hit caster, add dummy eff if necessary
+    SPELL_EL_SELF                           = 500007,//chance to hit +10%, +20% armor
+    SPELL_ELD_SELF                          = 500008,//block +20%
+    SPELL_TIR_SELF                          = 500009,//dummy
+    SPELL_NEF_SELF                          = 500010,//ranged dam taken -15%, (ctc knockback + stun 25% notstackable)
+    SPELL_ETH_SELF                          = 500011,//+20% armor pen
+    SPELL_ITH_SELF                          = 500012,//+500 damage, +100 spell dam
+    SPELL_TAL_SELF                          = 500013,//natu res +100
+    SPELL_RAL_SELF                          = 500014,//fire res +100
+    SPELL_ORT_SELF                          = 500015,//arca res +100
+    SPELL_THUL_SELF                         = 500016,//cold res +100
+    SPELL_AMN_SELF                          = 500017,//heal 2% max hp on hit, thorns 125
+    SPELL_SOL_SELF                          = 500018,//+750 damage, +150 spell dam
+    SPELL_SHAEL_SELF                        = 500019,//attspeed +30%
+    SPELL_DOL_SELF                          = 500020,//regen 1% hp/5 sec, (ctc fear when hit / being hit 20% notstackable)
+    SPELL_HEL_SELF                          = 500021,//allstats +20%
+    SPELL_IO_SELF                           = 500022,//maxhp +30%
+    SPELL_LUM_SELF                          = 500023,//(maxmana +20%) dummy
+    SPELL_KO_SELF                           = 500024,//dodge +10%
+    SPELL_FAL_SELF                          = 500025,//parry +10%
+    SPELL_LEM_SELF                          = 500026,//dummy
+    SPELL_PUL_SELF                          = 500027,//expertise +8
+    SPELL_UM_SELF                           = 500028,//all res +150
+    SPELL_MAL_SELF                          = 500029,//spell dam taken -15%
+    SPELL_IST_SELF                          = 500030,//resist magic/curse/disease 20%
+    SPELL_GUL_SELF                          = 500031,//+50% AP
+    SPELL_VEX_SELF                          = 500032,//20% reflect fire/shadow
+    SPELL_OHM_SELF                          = 500033,//20% reflect frost/nature
+    SPELL_LO_SELF                           = 500034,//20% reflect arcane/holy, crit +20%
+    SPELL_SUR_SELF                          = 500035,//(ctc blind when hit 10% notstackable)
+    SPELL_BER_SELF                          = 500036,//phys damage taken -20%, 35% ctc cast hp damage 12.5%
+    SPELL_JAH_SELF                          = 500037,//maxhp +50%
+    SPELL_CHAM_SELF                         = 500038,//ctc AOE Freeze when damage done
+    SPELL_ZOD_SELF                          = 500039,//damage taken -500, unkillable
+
+    SPELL_EL_TARGETS                        = 500207,//e chance to hit -10%
+    SPELL_ELD_TARGETS                       = 500208,//e block -20%
+    SPELL_TIR_TARGETS                       = 500209,//e spell cost +10%, periodic leech 100/5s
+    //SPELL_NEF_TARGETS                       = 500210,//
+    SPELL_ETH_TARGETS                       = 500211,//e mana regen -20% (from spirit)
+    SPELL_ITH_TARGETS                       = 500212,//e damage -5%
+    SPELL_TAL_TARGETS                       = 500213,//e periodic natu damage
+    SPELL_RAL_TARGETS                       = 500214,//e periodic fire damage
+    SPELL_ORT_TARGETS                       = 500215,//e periodic arca damage
+    SPELL_THUL_TARGETS                      = 500216,//e periodic cold damage
+    //SPELL_AMN_TARGETS                       = 500217,//
+    SPELL_SOL_TARGETS                       = 500218,//e damage -10%
+    SPELL_SHAEL_TARGETS                     = 500219,//e crit chance taken +5%
+    //SPELL_DOL_TARGETS                       = 500220,//
+    SPELL_HEL_TARGETS                       = 500221,//e allstats -10%
+    SPELL_IO_TARGETS                        = 500222,//e maxhp -5%
+    SPELL_LUM_TARGETS                       = 500223,//e maxmana -8%
+    SPELL_KO_TARGETS                        = 500224,//e dodge -10%
+    SPELL_FAL_TARGETS                       = 500225,//e parry -10%
+    SPELL_LEM_TARGETS                       = 500226,//e expertise -8
+    SPELL_PUL_TARGETS                       = 500227,//e defense -50
+    SPELL_UM_TARGETS                        = 500228,//e all res -150, bleed
+    SPELL_MAL_TARGETS                       = 500229,//e spell dam taken +10%, healing taken -15%
+    //SPELL_IST_TARGETS                       = 500230,//
+    SPELL_GUL_TARGETS                       = 500231,//e -20% AP, -20% ranged AP
+    SPELL_VEX_TARGETS                       = 500232,//e periodic leech 200/5s
+    SPELL_OHM_TARGETS                       = 500233,//e damage -15%
+    SPELL_LO_TARGETS                        = 500234,//e crit -10%
+    SPELL_SUR_TARGETS                       = 500235,//e maxmana -15%
+    //SPELL_BER_TARGETS                       = 500236,//
+    SPELL_JAH_TARGETS                       = 500237,//e maxhp -10%, defense -100
+    //SPELL_CHAM_TARGETS                      = 500238,//
+    SPELL_ZOD_TARGETS                       = 500239,//e armor -10000, crit dam taken +50%, ct die on hit
+
+    //triggered/additional spells
+    //SPELL_NEF_TRIGGERED                     = 500050,//knockback, triggered (not casted in script)
+    //SPELL_AMN_TRIGGERED                     = 500051,//heal 1% max hp, triggered (not casted in script)
+    //SPELL_DOL_TRIGGERED                     = 500052,//fear, triggered (not casted in script)
+    //SPELL_SUR_TRIGGERED                     = 500053,//blind, triggered (not casted in script)
+    SPELL_CRUSHING_BLOW_TRIGGERED           = 500054,//crushing blow, triggered, SCRIPTED
+    //SPELL_CHAM_TRIGGERED                    = 500055,//aoe freeze, triggered, (not casted in script)
+    //SPELL_ZOD_TRIGGERED                     = 500056,//instakill, triggered, (not casted in script)
+    //runewords
+    SPELL_MALICE_TRIGGERED                  = 500057,//self periodic pct damage, hidden, (casted in script)
+    SPELL_LIFESTEAL                         = 500058,//life steal X%, (casted in script)
+    SPELL_THORNS_AURA                       = 500059,//damage pct reflect, SCRIPTED
+    SPELL_THORNS_AURA_DAMAGE                = 500060,//thorns damage blank, (casted in script)
+    //SPELL_CHILLED_TRIGGERED                 = 500061,//all speeds -15%, rhyme triggered, (not casted in script)
+    //SPELL_HOWL_TRIGGERED                    = 500062,//AoE fear 6 sec, myth triggered, (not casted in script)
+    //SPELL_BONE_ARMOR_TRIGGERED              = 500063,//absorb 200k physical dam, white triggered, (not casted in script)
+    //SPELL_DECREPIFY_TRIGGERED               = 500064,//slow all 50%, armor -50%, lawbringer triggered, (not casted in script)
+    //SPELL_FLAME_TRIGGERED                   = 500065,//fire dam ~3k, enlightenment triggered, (not casted in script)
+    //SPELL_BLAZE_PERIODIC_TRIGGERED          = 500066,//small AoE med fire dam, enlightenment triggered, (not casted in script)
+    SPELL_STATIC_FIELD_TRIGGERED            = 500067,//static field, triggered, SCRIPTED
+    //SPELL_BONE_ARMOR_TRIGGERED              = 500069,//absorb 200k spell dam, rain triggered, (not casted in script)
+    //SPELL_VENOM_TRIGGERED                   = 500070,//nat dam ~3k, venom triggered, (not casted in script)
+    //SPELL_POISON_CLOUD_PERIODIC_TRIGGERED   = 500071,//small AoE med nat dam, venom triggered, (not casted in script)
+    //SPELL_IMPENDING_DELIRIUM_PERIODIC_TRIGGERED = 500072,//AoE sha dam, delirium triggered, (not casted in script)
+    //SPELL_DELIRIUM_PERIODIC_TRIGGERED       = 500073,//8 sec stun, delirium periodic triggered, (not casted in script)
+    //SPELL_DELIRIUM_PERIODIC_TRIGGERED2      = 500074,//dummy, delirium periodic triggered, (not casted in script)
+    //SPELL_WHIRLWIND_PERIODIC_TRIGGERED      = 500075,//trigger, chaos triggered, (not casted in script)
+    //SPELL_WHIRLWIND_TRIGGERED               = 500076,//125% weap dam AoE, whirlwind periodic triggered, (not casted in script)
+    //SPELL_FLAME_BREATH_PERIODIC_TRIGGERED   = 500077,//med fire dam AoE big cone, incr fire dam taken, dragon triggered, (not casted in script)
+    //SPELL_SLEEP_PERIODIC_TRIGGERED          = 500078,//sleep AoE 6 targets, dragon triggered, (not casted in script)
+    SPELL_TELEPORT                          = 500079,//tp to random spot clearing threat, enigma triggered, (casted in script)
+    SPELL_TELEPORT_ROOT                     = 500080,//root 1.5s, (casted in script)
+    SPELL_PERIODIC_TELEPORT_DUMMY           = 500081,//dummy, (checked in script)
+
+    //runewords
+    //All runeword spells should hit caster, add dummy eff if necessary
+    SPELL_STEEL                             = 500100,//25% haste, phys damage +20% +200
+    SPELL_NADIR                             = 500101,//-35% chance to get hit
+    SPELL_MALICE                            = 500102,//+33% phys damage, ignore 5k armor
+    SPELL_STEALTH                           = 500103,//+25% chance to hit, mag damage taken -450
+    SPELL_LEAF                              = 500104,//fire dam +50%, frost dam taken -50%, armor +7500
+    SPELL_ZEPHYR                            = 500105,//25% haste, phys damage +33%
+    SPELL_ANCIENTS_PLEDGE                   = 500106,//armor +50%, nat,fir,arc res +100, hol,fro,sha res +300
+    SPELL_STRENGTH                          = 500107,//phys dam +35%, life steal 70%, 25% crushing blow
+    SPELL_EDGE                              = 500108,//35% haste, life steal 70%, thorns 10%
+    SPELL_KINGS_GRACE                       = 500109,//phys dam +100%, life steal 70%, 15% cth
+    SPELL_RADIANCE                          = 500110,//armor +50%, mag damage taken -300, max hp +10%
+    SPELL_LORE                              = 500111,//all dam +50%
+    SPELL_RHYME                             = 500112,//all res +250, parry +20%, attackers -15% attack/cast speeds
+    SPELL_PEACE                             = 500113,//crit +25%, all dam +30%, ranged dam taken -33%
+    SPELL_MYTH                              = 500114,//all dam +30%, regen 1% hp/4 sec, ctc AoE fear
+    SPELL_BLACK                             = 500115,//phys dam +120%, att speed +15%, 40% crushing blow
+    SPELL_WHITE                             = 500116,//40% haste, mag damage taken -400, periodic Bone Armor 500063
+    SPELL_SMOKE                             = 500117,//armor +75%, all res +500, ranged dam taken -60%
+    SPELL_SPLENDOR                          = 500118,//armor +100%, all dam +20%
+    SPELL_MELODY                            = 500119,//armor +50%, all dam +45%, mag damage taken -700
+    SPELL_LIONHEART                         = 500120,//all dam +25%, all dam taken -25%, health +25%
+    SPELL_TREACHERY                         = 500121,//45% haste, all dam +30%, ct be hit by spells -75% (186)
+    SPELL_WEALTH                            = 500122,//100% crit
+    SPELL_LAWBRINGER                        = 500123,//armor pen +50%, ranged dam taken -50%, 20% ctc AoE Decrepify
+    SPELL_ENLIGHTENMENT                     = 500124,//all dam +30%, fire dam on attack, Blaze
+    SPELL_CRESCENT_MOON                     = 500125,//phys dam +200%, mag damage taken -1000, ctc Static Field
+    SPELL_DURESS                            = 500126,//armor +175%, att speed +30%, 15% crushing blow
+    SPELL_GLOOM                             = 500127,//armor +230%, all res +300, Dim Vision aura
+    SPELL_PRUDENCE                          = 500128,//armor +150%, all res +300, mag damage taken -1500
+    SPELL_RAIN                              = 500129,//all dam +30%, periodic Cyclone Armor 500069
+    SPELL_VENOM                             = 500130,//nat dam on attack, periodic Poison Cloud 500071
+    SPELL_SANCTUARY                         = 500131,//armor +250%, all res +700, parry +50%
+    SPELL_DELIRIUM                          = 500132,//all dam +30%, periodic Impending Delirium 500072
+    SPELL_PRINCIPLE                         = 500133,//all dam +30%, max hp +20%
+    SPELL_CHAOS                             = 500134,//35% haste, phys dam +225%, periodic Whirlwind  500075
+    SPELL_WIND                              = 500135,//55% haste, phys dam +200%
+    SPELL_DRAGON                            = 500136,//all dam taken -50%, periodic Flame Breath 500077
+    SPELL_DREAM                             = 500137,//dodge +33%, periodic AoE Sleep 500078
+    SPELL_FURY                              = 500138,//60% haste, crit +33%, expertise +60
+    SPELL_ENIGMA                            = 500139,//all dam +75%, all dam taken -35%, periodic Teleport 500079
+    //no spell data yet, disabled on startup until added
+    SPELL_BONE                              = 500140,
+    SPELL_PATTERN                           = 500141,
+    SPELL_PLAGUE                            = 500142,
+    SPELL_WISDOM                            = 500143,
+    SPELL_FLICKERING_FLAME                  = 500144,
+    SPELL_SPIRIT                            = 500145,
+    SPELL_INSIGHT                           = 500146,
+    SPELL_HARMONY                           = 500147,
+    SPELL_RIFT                              = 500148,
+    SPELL_PASSION                           = 500149,
+    SPELL_KINGSLAYER                        = 500150,
+    SPELL_HEART_OF_THE_OAK                  = 500151,
+    SPELL_PRIDE                             = 500152,
+    SPELL_MEMORY                            = 500153,
+    SPELL_OATH                              = 500154,
+    SPELL_HOLY_THUNDER                      = 500155,
+    SPELL_HAND_OF_JUSTICE                   = 500156,
+    SPELL_FORTITUDE                         = 500157,
+    SPELL_FAMINE                            = 500158,
+    SPELL_FAITH                             = 500159,
+    SPELL_VOICE_OF_REASON                   = 500160,
+    SPELL_BRAMBLE                           = 500161,
+    SPELL_CHAINS_OF_HONOR                   = 500162,
+    SPELL_ICE                               = 500163,
+    SPELL_INFINITY                          = 500164,
+    SPELL_PHOENIX                           = 500165,
+    SPELL_BRAND                             = 500166,
+    SPELL_EXILE                             = 500167,
+    SPELL_STONE                             = 500168,
+    SPELL_WRATH                             = 500169,
+    SPELL_HONOR                             = 500170,
+    SPELL_DESTRUCTION                       = 500171,
+    SPELL_DOOM                              = 500172,
+    SPELL_CALL_TO_ARMS                      = 500173,
+    SPELL_BEAST                             = 500174,
+    SPELL_DEATH                             = 500175,
+    SPELL_ETERNITY                          = 500176,
+    SPELL_GRIEF                             = 500177,
+    SPELL_OBEDIENCE                         = 500178,
+    SPELL_SILENCE                           = 500179,
+    SPELL_LAST_WISH                         = 500180,
+    SPELL_BREATH_OF_THE_DYING               = 500181,
+    SPELL_OBSESSION                         = 500182,
+    SPELL_UNBENDING_WILL                    = 500183
+};
+
+enum StrokeTypes : uint8
+{
+    NO_STROKE                   = 0,
+    LINE                        = 1, //171-180
+    LINE_REV                    = 2, //0-15
+    CURVE_L                     = 3, //141-170
+    CURVE_M /*sharper*/         = 4, //121-140
+    CURVE_H /*even sharper*/    = 5, //101-120
+    TURN_CUBIC                  = 6, //81-100
+    TURN_SHARP                  = 7, //16-80
+    TURN_REVERSE                = 8  //marker
+};
+
+enum StrokeTypeDefs : uint16
+{
+    STDEF_CAN_BE_EMPTY          = (1 << (NO_STROKE)), //should not come 2+ in a row, only with lines
+    STDEF_LINE                  = (1 << (LINE)),
+    STDEF_LINE_REV              = (1 << (LINE_REV)),
+    STDEF_CURVE_L               = (1 << (CURVE_L)),
+    STDEF_CURVE_M               = (1 << (CURVE_M)),
+    STDEF_CURVE_H               = (1 << (CURVE_H)),
+    STDEF_TURN_CUBIC            = (1 << (TURN_CUBIC)),
+    STDEF_TURN_SHARP            = (1 << (TURN_SHARP)),
+    STDEF_REV                   = (1 << (TURN_REVERSE)), //should not combine with line-based
+
+    //DO NOT add any new combinations
+    ST_LINE                     = (STDEF_LINE),
+    ST_LINE_OR_NOTHING          = (STDEF_LINE | STDEF_CAN_BE_EMPTY),
+
+    ST_LINE_REV /*YES*/         = (STDEF_LINE_REV),
+
+    ST_LINE_OR_CURVE_L          = (STDEF_LINE | STDEF_CURVE_L),
+    ST_LINE_OR_CURVE_M          = (STDEF_LINE | STDEF_CURVE_M),
+    ST_LINE_OR_CURVE_LM         = (STDEF_LINE | STDEF_CURVE_L | STDEF_CURVE_M),
+
+    ST_CURVE_L                  = (STDEF_CURVE_L),
+    ST_CURVE_L_R                = (STDEF_CURVE_L | STDEF_REV),
+    ST_CURVE_LM                 = (STDEF_CURVE_L | STDEF_CURVE_M),
+    ST_CURVE_LM_R               = (STDEF_CURVE_L | STDEF_CURVE_M | STDEF_REV),
+    ST_CURVE_M                  = (STDEF_CURVE_M),
+    ST_CURVE_M_R                = (STDEF_CURVE_M | STDEF_REV),
+    ST_CURVE_MH                 = (STDEF_CURVE_M | STDEF_CURVE_H),
+    ST_CURVE_MH_R               = (STDEF_CURVE_M | STDEF_CURVE_H | STDEF_REV),
+    ST_CURVE_H                  = (STDEF_CURVE_H),
+    ST_CURVE_H_R                = (STDEF_CURVE_H | STDEF_REV),
+    ST_CUBIC                    = (STDEF_TURN_CUBIC),
+    ST_CUBIC_R                  = (STDEF_TURN_CUBIC | STDEF_REV),
+    ST_CUBIC_OR_CURVE_M         = (STDEF_TURN_CUBIC | STDEF_CURVE_M),
+    ST_CUBIC_OR_CURVE_M_R       = (STDEF_TURN_CUBIC | STDEF_CURVE_M | STDEF_REV),
+    ST_CUBIC_OR_CURVE_H         = (STDEF_TURN_CUBIC | STDEF_CURVE_H),
+    ST_CUBIC_OR_CURVE_H_R       = (STDEF_TURN_CUBIC | STDEF_CURVE_H | STDEF_REV),
+    ST_CUBIC_OR_SHARP           = (STDEF_TURN_CUBIC | STDEF_TURN_SHARP),
+    ST_CUBIC_OR_SHARP_R         = (STDEF_TURN_CUBIC | STDEF_TURN_SHARP | STDEF_REV),
+    ST_SHARP                    = (STDEF_TURN_SHARP),
+    ST_SHARP_R                  = (STDEF_TURN_SHARP | STDEF_REV),
+
+    ST_CURVE_LMH                = (ST_CURVE_L | ST_CURVE_M | ST_CURVE_H),
+    ST_CURVE_LMH_R              = (ST_CURVE_LMH | STDEF_REV),
+    ST_CURVE_CMH                = (STDEF_TURN_CUBIC | STDEF_CURVE_M | STDEF_CURVE_H),
+    ST_CURVE_CMH_R              = (ST_CURVE_CMH | STDEF_REV),
+    ST_CURVE_CLMH               = (ST_CURVE_L | ST_CURVE_M | ST_CURVE_H | ST_CUBIC),
+    ST_CURVE_CLMH_R             = (ST_CURVE_CLMH | STDEF_REV),
+    ST_CURVE_ANY                = (ST_CURVE_L | ST_CURVE_M | ST_CURVE_H | ST_CUBIC | ST_SHARP),
+    ST_CURVE_ANY_R              = (ST_CURVE_ANY | STDEF_REV),
+
+    ST_LINETYPES                = (ST_LINE | ST_LINE_REV)
+};
+
+enum RuneTypes : uint32
+{
+    RUNE_EL1                    = 0, // do not edit, used as index
+    RUNE_EL2,
+    RUNE_ELD1,
+    RUNE_ELD2,
+    RUNE_TIR1,
+    RUNE_TIR2,
+    RUNE_NEF,
+    RUNE_ETH1,
+    RUNE_ETH2,
+    RUNE_ITH1,
+    RUNE_ITH2,
+    RUNE_TAL1,
+    RUNE_TAL2,
+    RUNE_TAL3,
+    RUNE_RAL,
+    RUNE_ORT1,
+    RUNE_ORT2,
+    RUNE_ORT3,
+    RUNE_THUL,
+    RUNE_AMN,
+    RUNE_SOL,
+    RUNE_SHAEL1,
+    RUNE_SHAEL2,
+    RUNE_DOL1,
+    RUNE_DOL2,
+    RUNE_HEL1,
+    RUNE_HEL2,
+    RUNE_IO1,
+    RUNE_IO2,
+    RUNE_IO3,
+    RUNE_LUM,
+    RUNE_KO,
+    RUNE_FAL1,
+    RUNE_FAL2,
+    RUNE_FAL3,
+    RUNE_FAL4,
+    RUNE_FAL5,
+    RUNE_FAL6,
+    RUNE_LEM1,
+    RUNE_LEM2,
+    RUNE_LEM3,
+    RUNE_LEM4,
+    RUNE_PUL,
+    RUNE_UM1,
+    RUNE_UM2,
+    RUNE_UM3,
+    RUNE_MAL1,
+    RUNE_MAL2,
+    RUNE_IST,
+    RUNE_GUL1,
+    RUNE_GUL2,
+    RUNE_GUL3,
+    RUNE_VEX1,
+    RUNE_VEX2,
+    RUNE_VEX3,
+    RUNE_VEX4,
+    RUNE_VEX5,
+    RUNE_VEX6,
+    RUNE_OHM,
+    RUNE_LO1,
+    RUNE_LO2,
+    RUNE_LO3,
+    RUNE_LO4,
+    RUNE_SUR1,
+    RUNE_SUR2,
+    RUNE_BER,
+    RUNE_JAH1,
+    RUNE_JAH2,
+    RUNE_JAH3,
+    RUNE_JAH4,
+    RUNE_JAH5,
+    RUNE_CHAM1,
+    RUNE_CHAM2,
+    RUNE_CHAM3,
+    RUNE_CHAM4,
+    RUNE_CHAM5,
+    RUNE_CHAM6,
+    RUNE_CHAM7,
+    RUNE_CHAM8,
+    RUNE_CHAM9,
+    RUNE_ZOD1,
+    RUNE_ZOD2,
+
+    MAX_RUNE_TYPES,
+
+    RUNE_INVALID                = 255
+};
+
+enum RunewordTypes : uint32
+{
+    //full catalog, 2 to 6 runes, repeating runes are counted by rune aura stacks
+    //runeword spell is always SPELL_STEEL + type
+    RUNEWORD_STEEL              = 0, // tirel, do not edit, used as index
+    RUNEWORD_NADIR, //neftir
+    RUNEWORD_MALICE, //itheleth
+    RUNEWORD_STEALTH, //taleth
+    RUNEWORD_LEAF, //tirral
+    RUNEWORD_ZEPHYR, //orteth
+    RUNEWORD_ANCIENTS_PLEDGE, //ralorttal
+    RUNEWORD_STRENGTH, //amntir
+    RUNEWORD_EDGE, //tirtalamn
+    RUNEWORD_KINGS_GRACE, //amnralthul
+    RUNEWORD_RADIANCE, //nefsolith
+    RUNEWORD_LORE, //ortsol
+    RUNEWORD_RHYME, //shaeleth
+    RUNEWORD_PEACE, //shaelthulamn
+    RUNEWORD_MYTH, //helamnnef
+    RUNEWORD_BLACK, //thulionef
+    RUNEWORD_WHITE, //dolio
+    RUNEWORD_SMOKE, //neflum
+    RUNEWORD_SPLENDOR, //ethlum
+    RUNEWORD_MELODY, //shaelkonef
+    RUNEWORD_LIONHEART, //hellumfal
+    RUNEWORD_TREACHERY, //shaelthullem
+    RUNEWORD_WEALTH, //lemkotir
+    RUNEWORD_LAWBRINGER, //amnlemko
+    RUNEWORD_ENLIGHTENMENT, //pulralsol
+    RUNEWORD_CRESCENT_MOON, //shaelumtir
+    RUNEWORD_DURESS, //shaelumthul
+    RUNEWORD_GLOOM, //falumpul
+    RUNEWORD_PRUDENCE, //maltir
+    RUNEWORD_RAIN, //ortmalith
+    RUNEWORD_VENOM, //taldolmal
+    RUNEWORD_SANCTUARY, //kokomal
+    RUNEWORD_DELIRIUM, //lemistio
+    RUNEWORD_PRINCIPLE, //ralguleld
+    RUNEWORD_CHAOS, //falohmum
+    RUNEWORD_WIND, //surel
+    RUNEWORD_DRAGON, //surlosol
+    RUNEWORD_DREAM, //iojahpul
+    RUNEWORD_FURY, //jahguleth
+    RUNEWORD_ENIGMA, //jahithber
+    RUNEWORD_BONE, //solumum
+    RUNEWORD_PATTERN, //talortthul
+    RUNEWORD_PLAGUE, //chamshaelum
+    RUNEWORD_WISDOM, //pulitheld
+    RUNEWORD_FLICKERING_FLAME, //nefpulvex
+    RUNEWORD_SPIRIT, //talthulortamn
+    RUNEWORD_INSIGHT, //raltirtalsol
+    RUNEWORD_HARMONY, //tirithsolko
+    RUNEWORD_RIFT, //helkolemgul
+    RUNEWORD_PASSION, //dolorteldlem
+    RUNEWORD_KINGSLAYER, //malumgulfal
+    RUNEWORD_HEART_OF_THE_OAK, //kovexpulthul
+    RUNEWORD_PRIDE, //chamsuriolo
+    RUNEWORD_MEMORY, //lumiosoleth
+    RUNEWORD_OATH, //shaelpulmallum
+    RUNEWORD_HOLY_THUNDER, //ethralorttal
+    RUNEWORD_HAND_OF_JUSTICE, //surchamamnlo
+    RUNEWORD_FORTITUDE, //elsoldollo
+    RUNEWORD_FAMINE, //falohmortjah
+    RUNEWORD_FAITH, //ohmjahlemeld
+    RUNEWORD_VOICE_OF_REASON, //lemkoeleld
+    RUNEWORD_BRAMBLE, //ralohmsureth
+    RUNEWORD_CHAINS_OF_HONOR, //dolumberist
+    RUNEWORD_ICE, //amnshaeljahlo
+    RUNEWORD_INFINITY, //bermalberist
+    RUNEWORD_PHOENIX, //vexvexlojah
+    RUNEWORD_BRAND, //jahlomalgul
+    RUNEWORD_EXILE, //vexohmistdol
+    RUNEWORD_STONE, //shaelumpullum
+    RUNEWORD_WRATH, //pullumbermal
+    RUNEWORD_HONOR, //amnelithtirsol
+    RUNEWORD_DESTRUCTION, //vexloberjahko
+    RUNEWORD_DOOM, //helohmumlocham
+    RUNEWORD_CALL_TO_ARMS, //amnralmalistohm
+    RUNEWORD_BEAST, //bertirummallum
+    RUNEWORD_DEATH, //helelvexortgul
+    RUNEWORD_ETERNITY, //amnberistsolsur
+    RUNEWORD_GRIEF, //ethtirlomalral
+    RUNEWORD_OBEDIENCE, //helkothulethfal
+    RUNEWORD_SILENCE, //doleldhelisttirvex
+    RUNEWORD_LAST_WISH, //jahmaljahsurjahber
+    RUNEWORD_BREATH_OF_THE_DYING, //vexheleleldzodeth
+    RUNEWORD_OBSESSION, //zodistlemlumionef
+    RUNEWORD_UNBENDING_WILL, //falioitheldelhel
+
+    MAX_RUNEWORD_TYPES,
+
+    RUNEWORD_INVALID            = 255
+};
+
+struct Stroke
+{
+public:
+    explicit constexpr Stroke(uint8 type, bool reverse) : type(type), reverse(reverse)
+    {
+        if ((type == LINE || type == LINE_REV) && reverse)
+            throw -1;
+    }
+    uint8 type;
+    bool reverse;
+};
+
+typedef std::vector<Stroke> Strokes;
+
+//How well a sequence matched a pattern
+struct RuneMatchScore
+{
+    uint8 errors = 0;       //mismatched strokes
+    uint8 offset = 0;       //sequence index of the last aligned stroke
+    uint8 coverage = 0;     //pattern slots checked against the sequence, unchecked trailing slots count as matched
+    bool reversed = false;  //sequence was read backwards
+};
+
+template<size_t N>
+using StrokeTypeDefsArray = std::array<StrokeTypeDefs, N>;
+
+constexpr size_t RUNE_STROKE_BITS = 4; //3-bit type, reverse bit
+constexpr size_t RUNE_STROKES_PER_WORD = 64 / RUNE_STROKE_BITS;
+
+//stroke as packed nibble
+constexpr uint64 GetRuneStrokeNibble(Stroke const& stroke)
+{
+    return (stroke.type & 7) | (stroke.reverse ? 8 : 0);
+}
+
+//Stroke sequence encoded once for all patterns: packed strokes (a rune of up to 16 strokes is one word)
+//and bitplanes, one bit per sequence position for each stroke type and for the reverse flag
+struct RuneEncodedSequence
+{
+    //pattern mask of a stroke (type bit and STDEF_REV)
+    constexpr StrokeTypeDefs GetMask(uint32 i) const
+    {
+        uint32 nibble = uint32(strokes[i / RUNE_STROKES_PER_WORD] >> (i % RUNE_STROKES_PER_WORD * RUNE_STROKE_BITS)) & 0xF;
+        return StrokeTypeDefs((1 << (nibble & 7)) | ((nibble & 8) << (TURN_REVERSE - 3)));
+    }
+
+    std::array<uint64, (MAX_RUNE_SEQUENCE_LENGTH + RUNE_STROKES_PER_WORD - 1) / RUNE_STROKES_PER_WORD> strokes = { };
+    std::array<uint64, TURN_REVERSE> positions = { };
+    uint64 reversed = 0;
+    int32 size = 0;
+};
+
+static_assert(MAX_RUNE_SEQUENCE_LENGTH <= 64, "sequence positions are uint64 bits");
+static_assert(TURN_REVERSE == 8 && STDEF_REV == (1 << 8), "stroke type takes 3 bits of a nibble");
+
+//false if the sequence is too long to be checked
+constexpr bool EncodeRuneSequence(Stroke const* compSeq, size_t compSize, RuneEncodedSequence& seq)
+{
+    if (compSize > MAX_RUNE_SEQUENCE_LENGTH)
+        return false;
+
+    for (size_t i = 0; i < compSize; ++i)
+    {
+        seq.strokes[i / RUNE_STROKES_PER_WORD] |= GetRuneStrokeNibble(compSeq[i]) << (i % RUNE_STROKES_PER_WORD * RUNE_STROKE_BITS);
+        if (compSeq[i].type < TURN_REVERSE)
+            seq.positions[compSeq[i].type] |= uint64(1) << i;
+        if (compSeq[i].reverse)
+            seq.reversed |= uint64(1) << i;
+    }
+    seq.size = int32(compSize);
+    return true;
+}
+
+//sequence positions accepted by a slot, first slot ignores the reverse flag (first stroke is normalized)
+constexpr uint64 GetRuneAcceptedPositions(RuneEncodedSequence const& seq, uint32 mask, bool first)
+{
+    uint64 accepted = 0;
+    for (uint32 types = mask & (STDEF_REV - 1) & ~STDEF_CAN_BE_EMPTY; types; types &= types - 1)
+        accepted |= seq.positions[std::countr_zero(types)];
+    if (first)
+        return accepted;
+    return accepted & ((mask & STDEF_REV) ? seq.reversed : ~seq.reversed);
+}
+
+//Word-level match of a pattern without optional slots, every start at once (one bit per start)
+//Slot k of forward start s is sequence position s + k, of backward start r it is r - k, and every start
+//the single-pass loop tries fits the sequence. The loop order then picks the result: forward start at step i,
+//or the first backward one once a forward start exists.
+struct RuneFixedMatch
+{
+    constexpr RuneFixedMatch(RuneEncodedSequence const& seq, int32 patternSize) : seqsize(seq.size), size(patternSize),
+        lineStrokes(seq.positions[LINE_REV] | seq.positions[CURVE_M]) //(1 << ST_LINE) | (1 << ST_LINE_REV), as the reference
+    {
+        uint64 starts = ~uint64(0) >> (64 - (seqsize - size + 1)); //i + minSize <= seqsize
+        forward = starts;
+        backward = starts << (size - 1);
+    }
+
+    //first slot
+    constexpr void SetFirst(uint64 accepted)
+    {
+        forward &= accepted;
+        backward &= accepted;
+    }
+
+    //slot k > 0: starts with one mismatch, failed with a second one or a mismatched line
+    constexpr void AddSlot(int32 k, uint64 accepted)
+    {
+        uint64 const mismatched = ~accepted;
+        uint64 const forwardSlot = mismatched >> k, backwardSlot = mismatched << k;
+        forwardFailed |= (forwardErrors & forwardSlot) | (forwardSlot & (lineStrokes >> k));
+        forwardErrors |= forwardSlot;
+        backwardFailed |= (backwardErrors & backwardSlot) | (backwardSlot & (lineStrokes << k));
+        backwardErrors |= backwardSlot;
+    }
+
+    constexpr bool GetScore(RuneMatchScore& score) const
+    {
+        uint64 forwardMatches = forward & ~forwardFailed;
+        uint64 backwardMatches = backward & ~backwardFailed;
+        int32 forwardStep = forwardMatches ? std::countr_zero(forwardMatches) : seqsize;
+        int32 foundStep = forward ? std::countr_zero(forward) : seqsize;
+        int32 backwardStep = backwardMatches ? seqsize - 1 - (63 - std::countl_zero(backwardMatches)) : seqsize;
+        int32 reverseStep = std::max(foundStep, backwardStep);
+        if (forwardStep < seqsize && forwardStep <= reverseStep)
+        {
+            score.errors = uint8((forwardErrors >> forwardStep) & 1);
+            score.offset = uint8(forwardStep + size - 1);
+            score.reversed = false;
+        }
+        else if (reverseStep < seqsize)
+        {
+            int32 r = seqsize - 1 - backwardStep;
+            score.errors = uint8((backwardErrors >> r) & 1);
+            score.offset = uint8(r - (size - 1));
+            score.reversed = true;
+        }
+        else
+            return false;
+
+        score.coverage = uint8(size);
+        return true;
+    }
+
+    int32 seqsize;
+    int32 size;
+    uint64 lineStrokes;
+    uint64 forward = 0;         //starts whose first slot matches
+    uint64 backward = 0;
+    uint64 forwardErrors = 0;
+    uint64 backwardErrors = 0;
+    uint64 forwardFailed = 0;
+    uint64 backwardFailed = 0;
+};
+
+static_assert(UNMATCH_THRESHOLD == 1, "word-level match counts one error per start");
+
+//Stroke pattern notation
+//Space-separated slots, each slot is a set of accepted strokes:
+//  I - line, V - line reversed, L/M/H - curve (low/mid/high), C - cubic turn, S - sharp turn, * - any turn (LMHCS)
+//  suffix /r - turn is reversed, suffix ? - slot can be empty
+//e.g. "MH LM CH/r S/r I LM LM"
+//Only the ST_* combinations above are accepted
+enum RuneStrokeParseError : uint8
+{
+    RSPE_NONE                   = 0,
+    RSPE_EMPTY_PATTERN,
+    RSPE_UNKNOWN_LETTER,
+    RSPE_DUPLICATE_LETTER,
+    RSPE_BAD_SUFFIX,
+    RSPE_UNKNOWN_COMBINATION,
+    RSPE_TOO_MANY_STROKES
+};
+
+struct RuneStrokeParseResult
+{
+    size_t size;
+    RuneStrokeParseError error;
+    size_t errorPos; //offending token
+    size_t errorLen;
+};
+
+constexpr StrokeTypeDefs RuneStrokeCombinations[] =
+{
+    ST_LINE, ST_LINE_OR_NOTHING, ST_LINE_REV, ST_LINE_OR_CURVE_L, ST_LINE_OR_CURVE_M, ST_LINE_OR_CURVE_LM,
+    ST_CURVE_L, ST_CURVE_L_R, ST_CURVE_LM, ST_CURVE_LM_R, ST_CURVE_M, ST_CURVE_M_R, ST_CURVE_MH, ST_CURVE_MH_R,
+    ST_CURVE_H, ST_CURVE_H_R, ST_CUBIC, ST_CUBIC_R, ST_CUBIC_OR_CURVE_M, ST_CUBIC_OR_CURVE_M_R,
+    ST_CUBIC_OR_CURVE_H, ST_CUBIC_OR_CURVE_H_R, ST_CUBIC_OR_SHARP, ST_CUBIC_OR_SHARP_R, ST_SHARP, ST_SHARP_R,
+    ST_CURVE_LMH, ST_CURVE_LMH_R, ST_CURVE_CMH, ST_CURVE_CMH_R, ST_CURVE_CLMH, ST_CURVE_CLMH_R,
+    ST_CURVE_ANY, ST_CURVE_ANY_R, ST_LINETYPES
+};
+
+constexpr uint32 GetRuneStrokeLetter(char c)
+{
+    switch (c)
+    {
+        case 'I': return STDEF_LINE;
+        case 'V': return STDEF_LINE_REV;
+        case 'L': return STDEF_CURVE_L;
+        case 'M': return STDEF_CURVE_M;
+        case 'H': return STDEF_CURVE_H;
+        case 'C': return STDEF_TURN_CUBIC;
+        case 'S': return STDEF_TURN_SHARP;
+        case '*': return ST_CURVE_ANY;
+        default:  return 0;
+    }
+}
+
+//Parses a slot list into out (up to maxSize slots, out can be null to only count them).
+//constexpr so the pattern tables are built at compile time and runtime loaders share the same rules
+constexpr RuneStrokeParseResult ParseRuneStrokes(std::string_view text, StrokeTypeDefs* out, size_t maxSize)
+{
+    size_t count = 0;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        if (text[pos] == ' ' || text[pos] == '\t')
+        {
+            ++pos;
+            continue;
+        }
+
+        size_t const begin = pos;
+        while (pos < text.size() && text[pos] != ' ' && text[pos] != '\t')
+            ++pos;
+        std::string_view const token = text.substr(begin, pos - begin);
+
+        size_t i = 0;
+        uint32 mask = 0;
+        for (; i < token.size() && token[i] != '/' && token[i] != '?'; ++i)
+        {
+            uint32 const letter = GetRuneStrokeLetter(token[i]);
+            if (!letter)
+                return { count, RSPE_UNKNOWN_LETTER, begin, token.size() };
+            if (mask & letter)
+                return { count, RSPE_DUPLICATE_LETTER, begin, token.size() };
+            mask |= letter;
+        }
+
+        if (!mask)
+            return { count, RSPE_UNKNOWN_LETTER, begin, token.size() };
+
+        if (token.substr(i, 2) == "/r")
+        {
+            mask |= STDEF_REV;
+            i += 2;
+        }
+        if (token.substr(i, 1) == "?")
+        {
+            mask |= STDEF_CAN_BE_EMPTY;
+            i += 1;
+        }
+        if (i != token.size())
+            return { count, RSPE_BAD_SUFFIX, begin, token.size() };
+
+        bool known = false;
+        for (StrokeTypeDefs combination : RuneStrokeCombinations)
+            if (uint32(combination) == mask)
+                known = true;
+        if (!known)
+            return { count, RSPE_UNKNOWN_COMBINATION, begin, token.size() };
+
+        if (out)
+        {
+            if (count >= maxSize)
+                return { count, RSPE_TOO_MANY_STROKES, begin, token.size() };
+            out[count] = StrokeTypeDefs(mask);
+        }
+        ++count;
+    }
+
+    if (!count)
+        return { 0, RSPE_EMPTY_PATTERN, 0, 0 };
+
+    return { count, RSPE_NONE, 0, 0 };
+}
+
+template<size_t N>
+struct RuneStrokeText
+{
+    consteval RuneStrokeText(char const (&str)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            text[i] = str[i];
+    }
+
+    constexpr std::string_view View() const { return std::string_view(text, N - 1); }
+
+    char text[N];
+};
+
+//never defined, instantiated with the offending token so it shows up in the compiler error
+template<RuneStrokeText Token, RuneStrokeParseError Error>
+struct RuneStrokeSyntaxError;
+
+template<RuneStrokeText Text, size_t Pos, size_t Len>
+consteval auto GetRuneStrokeToken()
+{
+    char token[Len + 1] = { };
+    for (size_t i = 0; i < Len; ++i)
+        token[i] = Text.text[Pos + i];
+    return RuneStrokeText<Len + 1>(token);
+}
+
+//RuneStrokes<"MH LM CH/r S/r I LM LM">() -> StrokeTypeDefsArray<7>
+template<RuneStrokeText Text>
+consteval auto RuneStrokes()
+{
+    constexpr RuneStrokeParseResult result = ParseRuneStrokes(Text.View(), nullptr, 0);
+    if constexpr (result.error != RSPE_NONE)
+        return RuneStrokeSyntaxError<GetRuneStrokeToken<Text, result.errorPos, result.errorLen>(), result.error>{};
+    else
+    {
+        StrokeTypeDefsArray<result.size> strokes = { };
+        ParseRuneStrokes(Text.View(), strokes.data(), result.size);
+        return strokes;
+    }
+}
+
+//(type, reverse) classes of carved strokes: 7 types, 5 of them can be reversed (lines cannot)
+constexpr uint32 MAX_STROKE_SYMBOLS = 12;
+
+//symbol of a stroke, MAX_STROKE_SYMBOLS if it cannot fill a slot
+constexpr uint32 GetStrokeSymbol(uint8 type, bool reverse)
+{
+    if (type == NO_STROKE || type >= TURN_REVERSE || (reverse && type < CURVE_L))
+        return MAX_STROKE_SYMBOLS;
+    return reverse ? uint32(type - CURVE_L) + TURN_SHARP : uint32(type - LINE);
+}
+
+static_assert(GetStrokeSymbol(TURN_SHARP, false) == TURN_SHARP - 1 && GetStrokeSymbol(TURN_SHARP, true) == MAX_STROKE_SYMBOLS - 1, "stroke symbols");
+
+typedef std::array<uint32, MAX_STROKE_SYMBOLS + 1> RuneSlotMasks;
+
+//slots bitmask per stroke symbol, first slot ignores reverse flag (first stroke is normalized)
+constexpr RuneSlotMasks BuildRuneSlotMasks(StrokeTypeDefs const* strokes, size_t size)
+{
+    RuneSlotMasks masks = { };
+    for (uint8 type = LINE; type < TURN_REVERSE; ++type)
+    {
+        for (uint32 reverse = 0; reverse < 2; ++reverse)
+        {
+            uint32 symbol = GetStrokeSymbol(type, reverse);
+            if (symbol == MAX_STROKE_SYMBOLS)
+                continue;
+
+            for (uint32 k = 0; k < size && k < MAX_RUNE_PATTERN_LENGTH; ++k)
+                if ((strokes[k] & (1 << type)) && (k == 0 || bool(strokes[k] & STDEF_REV) == bool(reverse)))
+                    masks[symbol] |= 1u << k;
+        }
+    }
+    return masks;
+}
+
+struct RunePattern
+{
+private:
+    template<size_t N>
+    inline static constexpr uint32 get_min_size(StrokeTypeDefsArray<N> const& m_strokes)
+    {
+        uint32 minsize = 0;
+        for (size_t i = 0; i < N; ++i)
+            if (!(m_strokes[i] & STDEF_CAN_BE_EMPTY))
+                ++minsize;
+        return minsize;
+    }
+
+    constexpr bool _MatchesFrom(RuneEncodedSequence const& seq, int32 start, int32 step, RuneMatchScore& score) const;
+
+public:
+    template<size_t N>
+    explicit constexpr RunePattern(const uint8 m_type, StrokeTypeDefsArray<N> const& m_strokes) :
+        type(m_type), size(N), minSize(get_min_size(m_strokes)), strokeSequence(m_strokes.data()),
+        slotMasks(BuildRuneSlotMasks(m_strokes.data(), N))
+    {
+        if (size < MIN_RUNE_PATTERN_LENGTH || size > MAX_RUNE_PATTERN_LENGTH)
+            throw -1;
+
+        if (strokeSequence[0] & STDEF_REV)
+            throw -2;
+
+        if (strokeSequence[0] & STDEF_CAN_BE_EMPTY)
+            throw -3;
+    }
+
+    //runtime patterns (pattern pack, arena), sequence is validated by the loader
+    explicit constexpr RunePattern(uint8 m_type, StrokeTypeDefs const* m_strokes, uint8 m_size, uint8 m_minSize) :
+        type(m_type), size(m_size), minSize(m_minSize), strokeSequence(m_strokes), slotMasks(BuildRuneSlotMasks(m_strokes, m_size))
+    {
+    }
+
+    bool Matches(Strokes const& compSeq) const;
+    constexpr bool Matches(Stroke const* compSeq, size_t compSize) const;
+    //same as Matches, also fills score of the accepted alignment
+    constexpr bool Matches(Stroke const* compSeq, size_t compSize, RuneMatchScore& score) const;
+    //same as Matches on a sequence encoded once for all patterns (EncodeRuneSequence)
+    constexpr bool MatchesEncoded(RuneEncodedSequence const& seq, RuneMatchScore& score) const;
+
+    template<size_t N>
+    static constexpr bool Matches(std::array<Stroke, N> const& compSeq, RunePattern const& pattern);
+
+    //original two-pass matcher, Matches must give the same results (see tools/runeworder_fuzz.cpp)
+    template<size_t N>
+    static constexpr bool MatchesReference(std::array<Stroke, N> const& compSeq, RunePattern const& pattern);
+
+    //Bit-parallel approximate match (Wu-Manber), sequence is read both ways.
+    //Slots are stroke classes, up to maxErrors strokes can be substituted (never lines, never the first slot),
+    //optional slots are skipped for free. Returns the minimal error count, or maxErrors + 1 if there is no match
+    constexpr uint32 GetMatchErrors(Stroke const* compSeq, size_t compSize, uint32 maxErrors, RuneMatchScore* score = nullptr) const;
+
+//private:
+    const uint8 type;
+    const uint8 size;
+    const uint8 minSize;
+    StrokeTypeDefs const* strokeSequence;
+    //slots accepting each stroke symbol (GetStrokeSymbol), for GetMatchErrors
+    RuneSlotMasks slotMasks;
+};
+
+constexpr size_t MAX_RUNE_MATCHES = 4; //best matches kept for the weighted roll
+
+struct RuneMatch
+{
+    uint8 type = RUNE_INVALID;
+    RuneMatchScore score;
+};
+
+constexpr uint32 GetRuneWeightTier(uint32 type)
+{
+    return type <= RUNE_THUL ? WEIGHT_RUNE_LOW : type <= RUNE_LEM4 ? WEIGHT_RUNE_MID : WEIGHT_RUNE_HI;
+}
+
+//fewer errors, then more slots checked, then higher rune
+constexpr bool IsBetterRuneMatch(RuneMatch const& a, RuneMatch const& b)
+{
+    if (a.score.errors != b.score.errors)
+        return a.score.errors < b.score.errors;
+    if (a.score.coverage != b.score.coverage)
+        return a.score.coverage > b.score.coverage;
+    return GetRuneWeightTier(a.type) > GetRuneWeightTier(b.type);
+}
+
+//roll weight, tier scaled by squared error margin: a clean low rune beats a sloppy high one
+constexpr uint32 GetRuneMatchWeight(RuneMatch const& match, uint32 errorBudget)
+{
+    uint32 margin = errorBudget >= match.score.errors ? errorBudget + 1 - match.score.errors : 0;
+    return GetRuneWeightTier(match.type) * margin * margin;
+}
+
+//Bounded top-k selection, worst kept match is on top of the heap
+template<size_t K>
+class RuneMatchHeap
+{
+public:
+    constexpr void Push(RuneMatch const& match)
+    {
+        if (_size < K)
+        {
+            _matches[_size++] = match;
+            std::push_heap(_matches.begin(), _matches.begin() + _size, IsBetterRuneMatch);
+            return;
+        }
+
+        if (!IsBetterRuneMatch(match, _matches[0]))
+            return;
+
+        std::pop_heap(_matches.begin(), _matches.end(), IsBetterRuneMatch);
+        _matches[K - 1] = match;
+        std::push_heap(_matches.begin(), _matches.end(), IsBetterRuneMatch);
+    }
+
+    //best first, heap is unusable afterwards
+    constexpr void Sort() { std::sort_heap(_matches.begin(), _matches.begin() + _size, IsBetterRuneMatch); }
+
+    constexpr bool empty() const { return !_size; }
+    constexpr size_t size() const { return _size; }
+    constexpr RuneMatch const* begin() const { return _matches.data(); }
+    constexpr RuneMatch const* end() const { return _matches.data() + _size; }
+
+private:
+    std::array<RuneMatch, K> _matches = { };
+    size_t _size = 0;
+};
+
+typedef std::vector<RuneworderSpells> RuneSpellVec;
+
+template<size_t N>
+using RuneSpellsArray = std::array<RuneworderSpells, N>;
+
+//rune self spells are consecutive, stacks are indexed by spell - SPELL_EL_SELF
+constexpr size_t MAX_RUNE_SPELLS = SPELL_ZOD_SELF - SPELL_EL_SELF + 1;
+
+typedef std::array<uint8, MAX_RUNE_SPELLS> RuneStacks;
+
+constexpr bool IsRuneSpell(uint32 spellId)
+{
+    return spellId >= SPELL_EL_SELF && spellId <= SPELL_ZOD_SELF;
+}
+
+constexpr void AddRuneStacks(RuneStacks& stacks, uint32 spellId, uint32 count)
+{
+    if (!IsRuneSpell(spellId))
+        return;
+
+    uint8& stack = stacks[spellId - SPELL_EL_SELF];
+    stack = uint8(std::min<uint32>(stack + count, 255));
+}
+
+constexpr RuneworderSpells GetRunewordSpell(uint32 type)
+{
+    return RuneworderSpells(SPELL_STEEL + type);
+}
+
+struct RunewordPattern
+{
+public:
+    template<size_t N>
+    explicit constexpr RunewordPattern(uint32 m_type, RuneSpellsArray<N> const& m_runes) :
+    type(m_type), size(N), runeSpellList(m_runes.data())
+    {
+        if (size < MIN_RUNEWORD_LENGTH || size > MAX_RUNEWORD_LENGTH)
+            throw -4;
+
+        for (size_t i = 0; i < N; ++i)
+            if (!IsRuneSpell(runeSpellList[i]))
+                throw -5;
+    }
+
+    //runtime patterns (pattern pack), rune list is validated by the loader
+    explicit RunewordPattern(uint32 m_type, RuneworderSpells const* m_runes, uint32 m_size) :
+    type(m_type), size(m_size), runeSpellList(m_runes)
+    {
+    }
+
+    bool Contains(RuneSpellVec const& compSeq) const;
+    //every rune of the word is present, repeating runes need as many stacks
+    constexpr bool Contains(RuneStacks const& stacks) const;
+
+    template<size_t M, size_t N>
+    static constexpr bool Contains(std::array<RuneworderSpells, N> const& compSeq, RunewordPattern const& pattern);
+
+    uint8 GetSize() const { return size; }
+    RuneworderSpells const* GetRuneSpellList() const { return runeSpellList; }
+
+//private:
+    const uint32 type;
+    const uint32 size;
+    RuneworderSpells const* runeSpellList;
+};
+
+//EL
+constexpr auto RuneStrokesEL1 = RuneStrokes<"MH LM CH/r S/r I LM LM">();
+constexpr auto RuneStrokesEL2 = RuneStrokes<"MH LMH/r S/r ILM LMH">();
+constexpr RunePattern Rune_EL1 = RunePattern(RUNE_EL1, RuneStrokesEL1);
+constexpr RunePattern Rune_EL2 = RunePattern(RUNE_EL2, RuneStrokesEL2);
+//ELD
+constexpr auto RuneStrokesELD1 = RuneStrokes<"L V I LM MH V LM S">();
+constexpr auto RuneStrokesELD2 = RuneStrokes<"L V IL MH LM">();
+constexpr RunePattern Rune_ELD1 = RunePattern(RUNE_ELD1, RuneStrokesELD1);
+constexpr RunePattern Rune_ELD2 = RunePattern(RUNE_ELD2, RuneStrokesELD2);
+//TIR
+constexpr auto RuneStrokesTIR1 = RuneStrokes<"S I S/r I S/r S/r LM MH L">();
+constexpr auto RuneStrokesTIR2 = RuneStrokes<"S I? S/r I? S/r S I?">();
+constexpr RunePattern Rune_TIR1 = RunePattern(RUNE_TIR1, RuneStrokesTIR1);
+constexpr RunePattern Rune_TIR2 = RunePattern(RUNE_TIR2, RuneStrokesTIR2);
+//NEF
+constexpr auto RuneStrokesNEF = RuneStrokes<"CS IL V CS LMH/r">();
+constexpr RunePattern Rune_NEF = RunePattern(RUNE_NEF, RuneStrokesNEF);
+//ETH
+constexpr auto RuneStrokesETH1 = RuneStrokes<"ILM V CS/r CS/r CS/r">();
+constexpr auto RuneStrokesETH2 = RuneStrokes<"ILM V CS CS/r CS/r">();
+constexpr RunePattern Rune_ETH1 = RunePattern(RUNE_ETH1, RuneStrokesETH1);
+constexpr RunePattern Rune_ETH2 = RunePattern(RUNE_ETH2, RuneStrokesETH2);
+//ITH
+constexpr auto RuneStrokesITH1 = RuneStrokes<"MH I? S S/r S/r I? MH">();
+constexpr auto RuneStrokesITH2 = RuneStrokes<"MH I? CS MH/r CS/r I? MH">();
+constexpr RunePattern Rune_ITH1 = RunePattern(RUNE_ITH1, RuneStrokesITH1);
+constexpr RunePattern Rune_ITH2 = RunePattern(RUNE_ITH2, RuneStrokesITH2);
+//TAL
+constexpr auto RuneStrokesTAL1 = RuneStrokes<"S I S/r S I">();
+constexpr auto RuneStrokesTAL2 = RuneStrokes<"I S S I S/r">();
+constexpr auto RuneStrokesTAL3 = RuneStrokes<"S S I S/r S">();
+constexpr RunePattern Rune_TAL1 = RunePattern(RUNE_TAL1, RuneStrokesTAL1);
+constexpr RunePattern Rune_TAL2 = RunePattern(RUNE_TAL2, RuneStrokesTAL2);
+constexpr RunePattern Rune_TAL3 = RunePattern(RUNE_TAL3, RuneStrokesTAL3);
+//RAL
+constexpr auto RuneStrokesRAL = RuneStrokes<"LMH LMH/r MH LMH MH">();
+constexpr RunePattern Rune_RAL = RunePattern(RUNE_RAL, RuneStrokesRAL);
+//ORT
+constexpr auto RuneStrokesORT1 = RuneStrokes<"LM MH/r S/r CH/r S/r CH/r S/r MH/r LM/r">();
+constexpr auto RuneStrokesORT2 = RuneStrokes<"LMH S/r CH/r S/r CH/r S/r LMH/r">();
+constexpr auto RuneStrokesORT3 = RuneStrokes<"LMH S/r LM/r I? LM S/r LMH/r">();
+constexpr RunePattern Rune_ORT1 = RunePattern(RUNE_ORT1, RuneStrokesORT1);
+constexpr RunePattern Rune_ORT2 = RunePattern(RUNE_ORT2, RuneStrokesORT2);
+constexpr RunePattern Rune_ORT3 = RunePattern(RUNE_ORT3, RuneStrokesORT3);
+//THUL
+constexpr auto RuneStrokesTHUL = RuneStrokes<"I S I? S/r S/r I?">();
+constexpr RunePattern Rune_THUL = RunePattern(RUNE_THUL, RuneStrokesTHUL);
+//AMN
+constexpr auto RuneStrokesAMN = RuneStrokes<"CH LMH MH CS CS/r IL">();
+constexpr RunePattern Rune_AMN = RunePattern(RUNE_AMN, RuneStrokesAMN);
+//SOL
+constexpr auto RuneStrokesSOL = RuneStrokes<"S CS/r LMH LMH */r">();
+constexpr RunePattern Rune_SOL = RunePattern(RUNE_SOL, RuneStrokesSOL);
+//SHAEL
+constexpr auto RuneStrokesSHAEL1 = RuneStrokes<"MH CS V I V CS/r */r">();
+constexpr auto RuneStrokesSHAEL2 = RuneStrokes<"CH CH V I V CS/r">();
+constexpr RunePattern Rune_SHAEL1 = RunePattern(RUNE_SHAEL1, RuneStrokesSHAEL1);
+constexpr RunePattern Rune_SHAEL2 = RunePattern(RUNE_SHAEL2, RuneStrokesSHAEL2);
+//DOL
+constexpr auto RuneStrokesDOL1 = RuneStrokes<"LMH LMH LMH CS I I">();
+constexpr auto RuneStrokesDOL2 = RuneStrokes<"CS LMH CH MH IL IL">();
+constexpr RunePattern Rune_DOL1 = RunePattern(RUNE_DOL1, RuneStrokesDOL1);
+constexpr RunePattern Rune_DOL2 = RunePattern(RUNE_DOL2, RuneStrokesDOL2);
+//HEL
+constexpr auto RuneStrokesHEL1 = RuneStrokes<"M M M M M M">();
+constexpr auto RuneStrokesHEL2 = RuneStrokes<"H H H H H">();
+constexpr RunePattern Rune_HEL1 = RunePattern(RUNE_HEL1, RuneStrokesHEL1);
+constexpr RunePattern Rune_HEL2 = RunePattern(RUNE_HEL2, RuneStrokesHEL2);
+//IO
+constexpr auto RuneStrokesIO1 = RuneStrokes<"CH LM/r CH/r V CH/r S/r V I CH">();
+constexpr auto RuneStrokesIO2 = RuneStrokes<"MH CS LMH/r CH/r S IL S/r IL CH/r">();
+constexpr auto RuneStrokesIO3 = RuneStrokes<"* IL CH S LMH V IL CH">();
+constexpr RunePattern Rune_IO1 = RunePattern(RUNE_IO1, RuneStrokesIO1);
+constexpr RunePattern Rune_IO2 = RunePattern(RUNE_IO2, RuneStrokesIO2);
+constexpr RunePattern Rune_IO3 = RunePattern(RUNE_IO3, RuneStrokesIO3);
+//LUM
+constexpr auto RuneStrokesLUM = RuneStrokes<"MH C LM LMH */r">();
+constexpr RunePattern Rune_LUM = RunePattern(RUNE_LUM, RuneStrokesLUM);
+//KO
+constexpr auto RuneStrokesKO = RuneStrokes<"CS LMH V IL CS LMH LMH/r">();
+constexpr RunePattern Rune_KO = RunePattern(RUNE_KO, RuneStrokesKO);
+//FAL
+constexpr auto RuneStrokesFAL1 = RuneStrokes<"S I CMH/r CS CMH I">();
+constexpr auto RuneStrokesFAL2 = RuneStrokes<"I CMH CS CMH I S/r">();
+constexpr auto RuneStrokesFAL3 = RuneStrokes<"CMH CS CMH I S/r S">();
+constexpr auto RuneStrokesFAL4 = RuneStrokes<"CS CMH I S/r S I">();
+constexpr auto RuneStrokesFAL5 = RuneStrokes<"CMH I S/r S I CMH/r">();
+constexpr auto RuneStrokesFAL6 = RuneStrokes<"I S S I CMH/r CS">();
+constexpr RunePattern Rune_FAL1 = RunePattern(RUNE_FAL1, RuneStrokesFAL1);
+constexpr RunePattern Rune_FAL2 = RunePattern(RUNE_FAL2, RuneStrokesFAL2);
+constexpr RunePattern Rune_FAL3 = RunePattern(RUNE_FAL3, RuneStrokesFAL3);
+constexpr RunePattern Rune_FAL4 = RunePattern(RUNE_FAL4, RuneStrokesFAL4);
+constexpr RunePattern Rune_FAL5 = RunePattern(RUNE_FAL5, RuneStrokesFAL5);
+constexpr RunePattern Rune_FAL6 = RunePattern(RUNE_FAL6, RuneStrokesFAL6);
+//LEM
+constexpr auto RuneStrokesLEM1 = RuneStrokes<"CH V I V C/r C/r V I">();
+constexpr auto RuneStrokesLEM2 = RuneStrokes<"CH V IL V IL V IL">();
+constexpr auto RuneStrokesLEM3 = RuneStrokes<"IL V IL V IL V CH">();
+constexpr auto RuneStrokesLEM4 = RuneStrokes<"IL V IL V IL V CH/r">();
+constexpr RunePattern Rune_LEM1 = RunePattern(RUNE_LEM1, RuneStrokesLEM1);
+constexpr RunePattern Rune_LEM2 = RunePattern(RUNE_LEM2, RuneStrokesLEM2);
+constexpr RunePattern Rune_LEM3 = RunePattern(RUNE_LEM3, RuneStrokesLEM3);
+constexpr RunePattern Rune_LEM4 = RunePattern(RUNE_LEM4, RuneStrokesLEM4);
+//PUL
+constexpr auto RuneStrokesPUL = RuneStrokes<"LM CS CMH S CMH CS LM">();
+constexpr RunePattern Rune_PUL = RunePattern(RUNE_PUL, RuneStrokesPUL);
+//UM
+constexpr auto RuneStrokesUM1 = RuneStrokes<"CMH S/r S/r V LM S">();
+constexpr auto RuneStrokesUM2 = RuneStrokes<"CMH S/r S/r S/r LM/r S">();
+constexpr auto RuneStrokesUM3 = RuneStrokes<"CMH S/r S/r S/r LM/r S">(); //REUSE
+constexpr RunePattern Rune_UM1 = RunePattern(RUNE_UM1, RuneStrokesUM1);
+constexpr RunePattern Rune_UM2 = RunePattern(RUNE_UM2, RuneStrokesUM2);
+constexpr RunePattern Rune_UM3 = RunePattern(RUNE_UM3, RuneStrokesUM3);
+//MAL
+constexpr auto RuneStrokesMAL1 = RuneStrokes<"S S/r IL V LM">();
+constexpr auto RuneStrokesMAL2 = RuneStrokes<"S S/r IL S/r LM/r">();
+constexpr RunePattern Rune_MAL1 = RunePattern(RUNE_MAL1, RuneStrokesMAL1);
+constexpr RunePattern Rune_MAL2 = RunePattern(RUNE_MAL2, RuneStrokesMAL2);
+//IST
+constexpr auto RuneStrokesIST = RuneStrokes<"LM LM CS CMH/r CMH/r">();
+constexpr RunePattern Rune_IST = RunePattern(RUNE_IST, RuneStrokesIST);
+//GUL
+constexpr auto RuneStrokesGUL1 = RuneStrokes<"M MH/r V LMH I?">();
+constexpr auto RuneStrokesGUL2 = RuneStrokes<"M MH/r V LMH I?">(); //REUSE
+//"M MH/r S LMH I?"
+constexpr auto RuneStrokesGUL3 = RuneStrokes<"M MH/r V LMH I?">(); //REUSE
+//"M MH/r S/r LMH/r I?"
+constexpr RunePattern Rune_GUL1 = RunePattern(RUNE_GUL1, RuneStrokesGUL1);
+constexpr RunePattern Rune_GUL2 = RunePattern(RUNE_GUL2, RuneStrokesGUL2);
+constexpr RunePattern Rune_GUL3 = RunePattern(RUNE_GUL3, RuneStrokesGUL3);
+//VEX
+constexpr auto RuneStrokesVEX1 = RuneStrokes<"CH I CH V CH/r CH S">();
+constexpr auto RuneStrokesVEX2 = RuneStrokes<"CH I CH V CH/r CH S/r">();
+constexpr auto RuneStrokesVEX3 = RuneStrokes<"CH I CH V CH/r CH V">();
+constexpr auto RuneStrokesVEX4 = RuneStrokes<"CH CH S CH CH">();
+constexpr auto RuneStrokesVEX5 = RuneStrokes<"CH CH S/r CH/r CH">();
+constexpr auto RuneStrokesVEX6 = RuneStrokes<"CH CH V CH CH">();
+constexpr RunePattern Rune_VEX1 = RunePattern(RUNE_VEX1, RuneStrokesVEX1);
+constexpr RunePattern Rune_VEX2 = RunePattern(RUNE_VEX2, RuneStrokesVEX2);
+constexpr RunePattern Rune_VEX3 = RunePattern(RUNE_VEX3, RuneStrokesVEX3);
+constexpr RunePattern Rune_VEX4 = RunePattern(RUNE_VEX4, RuneStrokesVEX4);
+constexpr RunePattern Rune_VEX5 = RunePattern(RUNE_VEX5, RuneStrokesVEX5);
+constexpr RunePattern Rune_VEX6 = RunePattern(RUNE_VEX6, RuneStrokesVEX6);
+//OHM
+constexpr auto RuneStrokesOHM = RuneStrokes<"S CS/r CS/r LM MH">();
+constexpr RunePattern Rune_OHM = RunePattern(RUNE_OHM, RuneStrokesOHM);
+//LO
+constexpr auto RuneStrokesLO1 = RuneStrokes<"CS V CS V CS V CS">();
+constexpr auto RuneStrokesLO2 = RuneStrokes<"CS S/r CS/r S/r CS/r S/r CS/r">();
+constexpr auto RuneStrokesLO3 = RuneStrokes<"S I S I S I S I S">();
+constexpr auto RuneStrokesLO4 = RuneStrokes<"I S I S I S I S I">();
+constexpr RunePattern Rune_LO1 = RunePattern(RUNE_LO1, RuneStrokesLO1);
+constexpr RunePattern Rune_LO2 = RunePattern(RUNE_LO2, RuneStrokesLO2);
+constexpr RunePattern Rune_LO3 = RunePattern(RUNE_LO3, RuneStrokesLO3);
+constexpr RunePattern Rune_LO4 = RunePattern(RUNE_LO4, RuneStrokesLO4);
+//SUR
+constexpr auto RuneStrokesSUR1 = RuneStrokes<"CH S/r V LM S/r CS/r">();
+constexpr auto RuneStrokesSUR2 = RuneStrokes<"CH S/r S/r LM/r S/r CS/r">();
+constexpr RunePattern Rune_SUR1 = RunePattern(RUNE_SUR1, RuneStrokesSUR1);
+constexpr RunePattern Rune_SUR2 = RunePattern(RUNE_SUR2, RuneStrokesSUR2);
+//BER
+constexpr auto RuneStrokesBER = RuneStrokes<"CH C V I? IL V C CH">();
+constexpr RunePattern Rune_BER = RunePattern(RUNE_BER, RuneStrokesBER);
+//JAH
+constexpr auto RuneStrokesJAH1 = RuneStrokes<"S I S/r I V M I">();
+constexpr auto RuneStrokesJAH2 = RuneStrokes<"S I M V I S/r I">();
+constexpr auto RuneStrokesJAH3 = RuneStrokes<"I S S I S/r I">();
+constexpr auto RuneStrokesJAH4 = RuneStrokes<"I S I S/r S I">();
+constexpr auto RuneStrokesJAH5 = RuneStrokes<"S I S/r S I M">();
+constexpr RunePattern Rune_JAH1 = RunePattern(RUNE_JAH1, RuneStrokesJAH1);
+constexpr RunePattern Rune_JAH2 = RunePattern(RUNE_JAH2, RuneStrokesJAH2);
+constexpr RunePattern Rune_JAH3 = RunePattern(RUNE_JAH3, RuneStrokesJAH3);
+constexpr RunePattern Rune_JAH4 = RunePattern(RUNE_JAH4, RuneStrokesJAH4);
+constexpr RunePattern Rune_JAH5 = RunePattern(RUNE_JAH5, RuneStrokesJAH5);
+//CHAM
+constexpr auto RuneStrokesCHAM1 = RuneStrokes<"CS I I? CS S S/r S/r S/r">();
+constexpr auto RuneStrokesCHAM2 = RuneStrokes<"I I? CS S S/r S/r S/r S/r">();
+constexpr auto RuneStrokesCHAM3 = RuneStrokes<"I I? CS S S/r S/r S/r S/r">(); //REUSE
+constexpr auto RuneStrokesCHAM4 = RuneStrokes<"CS S S/r S/r S/r S/r CS I">();
+constexpr auto RuneStrokesCHAM5 = RuneStrokes<"S S/r S/r S/r S/r CS I I?">();
+constexpr auto RuneStrokesCHAM6 = RuneStrokes<"S S/r S/r S/r CS I I? CS">();
+constexpr auto RuneStrokesCHAM7 = RuneStrokes<"S S/r S/r CS I I? CS S">();
+constexpr auto RuneStrokesCHAM8 = RuneStrokes<"S S/r CS I I? CS S S/r">();
+constexpr auto RuneStrokesCHAM9 = RuneStrokes<"S CS I I? CS S S/r S/r">();
+constexpr RunePattern Rune_CHAM1 = RunePattern(RUNE_CHAM1, RuneStrokesCHAM1);
+constexpr RunePattern Rune_CHAM2 = RunePattern(RUNE_CHAM2, RuneStrokesCHAM2);
+constexpr RunePattern Rune_CHAM3 = RunePattern(RUNE_CHAM3, RuneStrokesCHAM3);
+constexpr RunePattern Rune_CHAM4 = RunePattern(RUNE_CHAM4, RuneStrokesCHAM4);
+constexpr RunePattern Rune_CHAM5 = RunePattern(RUNE_CHAM5, RuneStrokesCHAM5);
+constexpr RunePattern Rune_CHAM6 = RunePattern(RUNE_CHAM6, RuneStrokesCHAM6);
+constexpr RunePattern Rune_CHAM7 = RunePattern(RUNE_CHAM7, RuneStrokesCHAM7);
+constexpr RunePattern Rune_CHAM8 = RunePattern(RUNE_CHAM8, RuneStrokesCHAM8);
+constexpr RunePattern Rune_CHAM9 = RunePattern(RUNE_CHAM9, RuneStrokesCHAM9);
+//ZOD
+constexpr auto RuneStrokesZOD1 = RuneStrokes<"S S/r S/r CH/r S/r LMH LMH/r">();
+constexpr auto RuneStrokesZOD2 = RuneStrokes<"S S/r S/r CS/r S/r LMH LMH/r">();
+constexpr RunePattern Rune_ZOD1 = RunePattern(RUNE_ZOD1, RuneStrokesZOD1);
+constexpr RunePattern Rune_ZOD2 = RunePattern(RUNE_ZOD2, RuneStrokesZOD2);
+
+//Runewords
+constexpr uint32 RUNEWORD_SIZE_STEEL = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_STEEL> RunesSTEEL = { SPELL_TIR_SELF, SPELL_EL_SELF };
+constexpr RunewordPattern Runeword_STEEL = RunewordPattern(RUNEWORD_STEEL, RunesSTEEL);
+constexpr uint32 RUNEWORD_SIZE_NADIR = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_NADIR> RunesNADIR = { SPELL_NEF_SELF, SPELL_TIR_SELF };
+constexpr RunewordPattern Runeword_NADIR = RunewordPattern(RUNEWORD_NADIR, RunesNADIR);
+constexpr uint32 RUNEWORD_SIZE_MALICE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_MALICE> RunesMALICE = { SPELL_ITH_SELF, SPELL_EL_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_MALICE = RunewordPattern(RUNEWORD_MALICE, RunesMALICE);
+constexpr uint32 RUNEWORD_SIZE_STEALTH = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_STEALTH> RunesSTEALTH = { SPELL_TAL_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_STEALTH = RunewordPattern(RUNEWORD_STEALTH, RunesSTEALTH);
+constexpr uint32 RUNEWORD_SIZE_LEAF = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_LEAF> RunesLEAF = { SPELL_TIR_SELF, SPELL_RAL_SELF };
+constexpr RunewordPattern Runeword_LEAF = RunewordPattern(RUNEWORD_LEAF, RunesLEAF);
+constexpr uint32 RUNEWORD_SIZE_ZEPHYR = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_ZEPHYR> RunesZEPHYR = { SPELL_ORT_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_ZEPHYR = RunewordPattern(RUNEWORD_ZEPHYR, RunesZEPHYR);
+constexpr uint32 RUNEWORD_SIZE_ANCIENTS_PLEDGE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_ANCIENTS_PLEDGE> RunesANCIENTS_PLEDGE = { SPELL_RAL_SELF, SPELL_ORT_SELF, SPELL_TAL_SELF };
+constexpr RunewordPattern Runeword_ANCIENTS_PLEDGE = RunewordPattern(RUNEWORD_ANCIENTS_PLEDGE, RunesANCIENTS_PLEDGE);
+constexpr uint32 RUNEWORD_SIZE_STRENGTH = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_STRENGTH> RunesSTRENGTH = { SPELL_AMN_SELF, SPELL_TIR_SELF };
+constexpr RunewordPattern Runeword_STRENGTH = RunewordPattern(RUNEWORD_STRENGTH, RunesSTRENGTH);
+constexpr uint32 RUNEWORD_SIZE_EDGE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_EDGE> RunesEDGE = { SPELL_TIR_SELF, SPELL_TAL_SELF, SPELL_AMN_SELF };
+constexpr RunewordPattern Runeword_EDGE = RunewordPattern(RUNEWORD_EDGE, RunesEDGE);
+constexpr uint32 RUNEWORD_SIZE_KINGS_GRACE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_KINGS_GRACE> RunesKINGS_GRACE = { SPELL_AMN_SELF, SPELL_RAL_SELF, SPELL_THUL_SELF };
+constexpr RunewordPattern Runeword_KINGS_GRACE = RunewordPattern(RUNEWORD_KINGS_GRACE, RunesKINGS_GRACE);
+constexpr uint32 RUNEWORD_SIZE_RADIANCE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_RADIANCE> RunesRADIANCE = { SPELL_NEF_SELF, SPELL_SOL_SELF, SPELL_ITH_SELF };
+constexpr RunewordPattern Runeword_RADIANCE = RunewordPattern(RUNEWORD_RADIANCE, RunesRADIANCE);
+constexpr uint32 RUNEWORD_SIZE_LORE = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_LORE> RunesLORE = { SPELL_ORT_SELF, SPELL_SOL_SELF };
+constexpr RunewordPattern Runeword_LORE = RunewordPattern(RUNEWORD_LORE, RunesLORE);
+constexpr uint32 RUNEWORD_SIZE_RHYME = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_RHYME> RunesRHYME = { SPELL_SHAEL_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_RHYME = RunewordPattern(RUNEWORD_RHYME, RunesRHYME);
+constexpr uint32 RUNEWORD_SIZE_PEACE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PEACE> RunesPEACE = { SPELL_SHAEL_SELF, SPELL_THUL_SELF, SPELL_AMN_SELF };
+constexpr RunewordPattern Runeword_PEACE = RunewordPattern(RUNEWORD_PEACE, RunesPEACE);
+constexpr uint32 RUNEWORD_SIZE_MYTH = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_MYTH> RunesMYTH = { SPELL_HEL_SELF, SPELL_AMN_SELF, SPELL_NEF_SELF };
+constexpr RunewordPattern Runeword_MYTH = RunewordPattern(RUNEWORD_MYTH, RunesMYTH);
+constexpr uint32 RUNEWORD_SIZE_BLACK = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_BLACK> RunesBLACK = { SPELL_THUL_SELF, SPELL_IO_SELF, SPELL_NEF_SELF };
+constexpr RunewordPattern Runeword_BLACK = RunewordPattern(RUNEWORD_BLACK, RunesBLACK);
+constexpr uint32 RUNEWORD_SIZE_WHITE = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_WHITE> RunesWHITE = { SPELL_DOL_SELF, SPELL_IO_SELF };
+constexpr RunewordPattern Runeword_WHITE = RunewordPattern(RUNEWORD_WHITE, RunesWHITE);
+constexpr uint32 RUNEWORD_SIZE_SMOKE = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_SMOKE> RunesSMOKE = { SPELL_NEF_SELF, SPELL_LUM_SELF };
+constexpr RunewordPattern Runeword_SMOKE = RunewordPattern(RUNEWORD_SMOKE, RunesSMOKE);
+constexpr uint32 RUNEWORD_SIZE_SPLENDOR = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_SPLENDOR> RunesSPLENDOR = { SPELL_ETH_SELF, SPELL_LUM_SELF };
+constexpr RunewordPattern Runeword_SPLENDOR = RunewordPattern(RUNEWORD_SPLENDOR, RunesSPLENDOR);
+constexpr uint32 RUNEWORD_SIZE_MELODY = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_MELODY> RunesMELODY = { SPELL_SHAEL_SELF, SPELL_KO_SELF, SPELL_NEF_SELF };
+constexpr RunewordPattern Runeword_MELODY = RunewordPattern(RUNEWORD_MELODY, RunesMELODY);
+constexpr uint32 RUNEWORD_SIZE_LIONHEART = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_LIONHEART> RunesLIONHEART = { SPELL_HEL_SELF, SPELL_LUM_SELF, SPELL_FAL_SELF };
+constexpr RunewordPattern Runeword_LIONHEART = RunewordPattern(RUNEWORD_LIONHEART, RunesLIONHEART);
+constexpr uint32 RUNEWORD_SIZE_TREACHERY = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_TREACHERY> RunesTREACHERY = { SPELL_SHAEL_SELF, SPELL_THUL_SELF, SPELL_LEM_SELF };
+constexpr RunewordPattern Runeword_TREACHERY = RunewordPattern(RUNEWORD_TREACHERY, RunesTREACHERY);
+constexpr uint32 RUNEWORD_SIZE_WEALTH = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_WEALTH> RunesWEALTH = { SPELL_LEM_SELF, SPELL_KO_SELF, SPELL_TIR_SELF };
+constexpr RunewordPattern Runeword_WEALTH = RunewordPattern(RUNEWORD_WEALTH, RunesWEALTH);
+constexpr uint32 RUNEWORD_SIZE_LAWBRINGER = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_LAWBRINGER> RunesLAWBRINGER = { SPELL_AMN_SELF, SPELL_LEM_SELF, SPELL_KO_SELF };
+constexpr RunewordPattern Runeword_LAWBRINGER = RunewordPattern(RUNEWORD_LAWBRINGER, RunesLAWBRINGER);
+constexpr uint32 RUNEWORD_SIZE_ENLIGHTENMENT = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_ENLIGHTENMENT> RunesENLIGHTENMENT = { SPELL_PUL_SELF, SPELL_RAL_SELF, SPELL_SOL_SELF };
+constexpr RunewordPattern Runeword_ENLIGHTENMENT = RunewordPattern(RUNEWORD_ENLIGHTENMENT, RunesENLIGHTENMENT);
+constexpr uint32 RUNEWORD_SIZE_CRESCENT_MOON = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_CRESCENT_MOON> RunesCRESCENT_MOON = { SPELL_SHAEL_SELF, SPELL_UM_SELF, SPELL_TIR_SELF };
+constexpr RunewordPattern Runeword_CRESCENT_MOON = RunewordPattern(RUNEWORD_CRESCENT_MOON, RunesCRESCENT_MOON);
+constexpr uint32 RUNEWORD_SIZE_DURESS = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DURESS> RunesDURESS = { SPELL_SHAEL_SELF, SPELL_LUM_SELF, SPELL_THUL_SELF };
+constexpr RunewordPattern Runeword_DURESS = RunewordPattern(RUNEWORD_DURESS, RunesDURESS);
+constexpr uint32 RUNEWORD_SIZE_GLOOM = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_GLOOM> RunesGLOOM = { SPELL_FAL_SELF, SPELL_UM_SELF, SPELL_PUL_SELF };
+constexpr RunewordPattern Runeword_GLOOM = RunewordPattern(RUNEWORD_GLOOM, RunesGLOOM);
+constexpr uint32 RUNEWORD_SIZE_PRUDENCE = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PRUDENCE> RunesPRUDENCE = { SPELL_MAL_SELF, SPELL_TIR_SELF };
+constexpr RunewordPattern Runeword_PRUDENCE = RunewordPattern(RUNEWORD_PRUDENCE, RunesPRUDENCE);
+constexpr uint32 RUNEWORD_SIZE_RAIN = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_RAIN> RunesRAIN = { SPELL_ORT_SELF, SPELL_MAL_SELF, SPELL_ITH_SELF };
+constexpr RunewordPattern Runeword_RAIN = RunewordPattern(RUNEWORD_RAIN, RunesRAIN);
+constexpr uint32 RUNEWORD_SIZE_VENOM = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_VENOM> RunesVENOM = { SPELL_TAL_SELF, SPELL_DOL_SELF, SPELL_MAL_SELF };
+constexpr RunewordPattern Runeword_VENOM = RunewordPattern(RUNEWORD_VENOM, RunesVENOM);
+constexpr uint32 RUNEWORD_SIZE_SANCTUARY = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_SANCTUARY> RunesSANCTUARY = { SPELL_KO_SELF, SPELL_KO_SELF, SPELL_MAL_SELF };
+constexpr RunewordPattern Runeword_SANCTUARY = RunewordPattern(RUNEWORD_SANCTUARY, RunesSANCTUARY);
+constexpr uint32 RUNEWORD_SIZE_DELIRIUM = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DELIRIUM> RunesDELIRIUM = { SPELL_LEM_SELF, SPELL_IST_SELF, SPELL_IO_SELF };
+constexpr RunewordPattern Runeword_DELIRIUM = RunewordPattern(RUNEWORD_DELIRIUM, RunesDELIRIUM);
+constexpr uint32 RUNEWORD_SIZE_PRINCIPLE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PRINCIPLE> RunesPRINCIPLE = { SPELL_RAL_SELF, SPELL_GUL_SELF, SPELL_ELD_SELF };
+constexpr RunewordPattern Runeword_PRINCIPLE = RunewordPattern(RUNEWORD_PRINCIPLE, RunesPRINCIPLE);
+constexpr uint32 RUNEWORD_SIZE_CHAOS = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_CHAOS> RunesCHAOS = { SPELL_FAL_SELF, SPELL_OHM_SELF, SPELL_UM_SELF };
+constexpr RunewordPattern Runeword_CHAOS = RunewordPattern(RUNEWORD_CHAOS, RunesCHAOS);
+constexpr uint32 RUNEWORD_SIZE_WIND = 2;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_WIND> RunesWIND = { SPELL_SUR_SELF, SPELL_EL_SELF };
+constexpr RunewordPattern Runeword_WIND = RunewordPattern(RUNEWORD_WIND, RunesWIND);
+constexpr uint32 RUNEWORD_SIZE_DRAGON = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DRAGON> RunesDRAGON = { SPELL_SUR_SELF, SPELL_LO_SELF, SPELL_SOL_SELF };
+constexpr RunewordPattern Runeword_DRAGON = RunewordPattern(RUNEWORD_DRAGON, RunesDRAGON);
+constexpr uint32 RUNEWORD_SIZE_DREAM = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DREAM> RunesDREAM = { SPELL_IO_SELF, SPELL_JAH_SELF, SPELL_PUL_SELF };
+constexpr RunewordPattern Runeword_DREAM = RunewordPattern(RUNEWORD_DREAM, RunesDREAM);
+constexpr uint32 RUNEWORD_SIZE_FURY = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_FURY> RunesFURY = { SPELL_JAH_SELF, SPELL_GUL_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_FURY = RunewordPattern(RUNEWORD_FURY, RunesFURY);
+constexpr uint32 RUNEWORD_SIZE_ENIGMA = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_ENIGMA> RunesENIGMA = { SPELL_JAH_SELF, SPELL_ITH_SELF, SPELL_BER_SELF };
+constexpr RunewordPattern Runeword_ENIGMA = RunewordPattern(RUNEWORD_ENIGMA, RunesENIGMA);
+constexpr uint32 RUNEWORD_SIZE_BONE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_BONE> RunesBONE = { SPELL_SOL_SELF, SPELL_UM_SELF, SPELL_UM_SELF };
+constexpr RunewordPattern Runeword_BONE = RunewordPattern(RUNEWORD_BONE, RunesBONE);
+constexpr uint32 RUNEWORD_SIZE_PATTERN = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PATTERN> RunesPATTERN = { SPELL_TAL_SELF, SPELL_ORT_SELF, SPELL_THUL_SELF };
+constexpr RunewordPattern Runeword_PATTERN = RunewordPattern(RUNEWORD_PATTERN, RunesPATTERN);
+constexpr uint32 RUNEWORD_SIZE_PLAGUE = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PLAGUE> RunesPLAGUE = { SPELL_CHAM_SELF, SPELL_SHAEL_SELF, SPELL_UM_SELF };
+constexpr RunewordPattern Runeword_PLAGUE = RunewordPattern(RUNEWORD_PLAGUE, RunesPLAGUE);
+constexpr uint32 RUNEWORD_SIZE_WISDOM = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_WISDOM> RunesWISDOM = { SPELL_PUL_SELF, SPELL_ITH_SELF, SPELL_ELD_SELF };
+constexpr RunewordPattern Runeword_WISDOM = RunewordPattern(RUNEWORD_WISDOM, RunesWISDOM);
+constexpr uint32 RUNEWORD_SIZE_FLICKERING_FLAME = 3;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_FLICKERING_FLAME> RunesFLICKERING_FLAME = { SPELL_NEF_SELF, SPELL_PUL_SELF, SPELL_VEX_SELF };
+constexpr RunewordPattern Runeword_FLICKERING_FLAME = RunewordPattern(RUNEWORD_FLICKERING_FLAME, RunesFLICKERING_FLAME);
+constexpr uint32 RUNEWORD_SIZE_SPIRIT = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_SPIRIT> RunesSPIRIT = { SPELL_TAL_SELF, SPELL_THUL_SELF, SPELL_ORT_SELF, SPELL_AMN_SELF };
+constexpr RunewordPattern Runeword_SPIRIT = RunewordPattern(RUNEWORD_SPIRIT, RunesSPIRIT);
+constexpr uint32 RUNEWORD_SIZE_INSIGHT = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_INSIGHT> RunesINSIGHT = { SPELL_RAL_SELF, SPELL_TIR_SELF, SPELL_TAL_SELF, SPELL_SOL_SELF };
+constexpr RunewordPattern Runeword_INSIGHT = RunewordPattern(RUNEWORD_INSIGHT, RunesINSIGHT);
+constexpr uint32 RUNEWORD_SIZE_HARMONY = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_HARMONY> RunesHARMONY = { SPELL_TIR_SELF, SPELL_ITH_SELF, SPELL_SOL_SELF, SPELL_KO_SELF };
+constexpr RunewordPattern Runeword_HARMONY = RunewordPattern(RUNEWORD_HARMONY, RunesHARMONY);
+constexpr uint32 RUNEWORD_SIZE_RIFT = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_RIFT> RunesRIFT = { SPELL_HEL_SELF, SPELL_KO_SELF, SPELL_LEM_SELF, SPELL_GUL_SELF };
+constexpr RunewordPattern Runeword_RIFT = RunewordPattern(RUNEWORD_RIFT, RunesRIFT);
+constexpr uint32 RUNEWORD_SIZE_PASSION = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PASSION> RunesPASSION = { SPELL_DOL_SELF, SPELL_ORT_SELF, SPELL_ELD_SELF, SPELL_LEM_SELF };
+constexpr RunewordPattern Runeword_PASSION = RunewordPattern(RUNEWORD_PASSION, RunesPASSION);
+constexpr uint32 RUNEWORD_SIZE_KINGSLAYER = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_KINGSLAYER> RunesKINGSLAYER = { SPELL_MAL_SELF, SPELL_UM_SELF, SPELL_GUL_SELF, SPELL_FAL_SELF };
+constexpr RunewordPattern Runeword_KINGSLAYER = RunewordPattern(RUNEWORD_KINGSLAYER, RunesKINGSLAYER);
+constexpr uint32 RUNEWORD_SIZE_HEART_OF_THE_OAK = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_HEART_OF_THE_OAK> RunesHEART_OF_THE_OAK = { SPELL_KO_SELF, SPELL_VEX_SELF, SPELL_PUL_SELF, SPELL_THUL_SELF };
+constexpr RunewordPattern Runeword_HEART_OF_THE_OAK = RunewordPattern(RUNEWORD_HEART_OF_THE_OAK, RunesHEART_OF_THE_OAK);
+constexpr uint32 RUNEWORD_SIZE_PRIDE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PRIDE> RunesPRIDE = { SPELL_CHAM_SELF, SPELL_SUR_SELF, SPELL_IO_SELF, SPELL_LO_SELF };
+constexpr RunewordPattern Runeword_PRIDE = RunewordPattern(RUNEWORD_PRIDE, RunesPRIDE);
+constexpr uint32 RUNEWORD_SIZE_MEMORY = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_MEMORY> RunesMEMORY = { SPELL_LUM_SELF, SPELL_IO_SELF, SPELL_SOL_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_MEMORY = RunewordPattern(RUNEWORD_MEMORY, RunesMEMORY);
+constexpr uint32 RUNEWORD_SIZE_OATH = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_OATH> RunesOATH = { SPELL_SHAEL_SELF, SPELL_PUL_SELF, SPELL_MAL_SELF, SPELL_LUM_SELF };
+constexpr RunewordPattern Runeword_OATH = RunewordPattern(RUNEWORD_OATH, RunesOATH);
+constexpr uint32 RUNEWORD_SIZE_HOLY_THUNDER = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_HOLY_THUNDER> RunesHOLY_THUNDER = { SPELL_ETH_SELF, SPELL_RAL_SELF, SPELL_ORT_SELF, SPELL_TAL_SELF };
+constexpr RunewordPattern Runeword_HOLY_THUNDER = RunewordPattern(RUNEWORD_HOLY_THUNDER, RunesHOLY_THUNDER);
+constexpr uint32 RUNEWORD_SIZE_HAND_OF_JUSTICE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_HAND_OF_JUSTICE> RunesHAND_OF_JUSTICE = { SPELL_SUR_SELF, SPELL_CHAM_SELF, SPELL_AMN_SELF, SPELL_LO_SELF };
+constexpr RunewordPattern Runeword_HAND_OF_JUSTICE = RunewordPattern(RUNEWORD_HAND_OF_JUSTICE, RunesHAND_OF_JUSTICE);
+constexpr uint32 RUNEWORD_SIZE_FORTITUDE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_FORTITUDE> RunesFORTITUDE = { SPELL_EL_SELF, SPELL_SOL_SELF, SPELL_DOL_SELF, SPELL_LO_SELF };
+constexpr RunewordPattern Runeword_FORTITUDE = RunewordPattern(RUNEWORD_FORTITUDE, RunesFORTITUDE);
+constexpr uint32 RUNEWORD_SIZE_FAMINE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_FAMINE> RunesFAMINE = { SPELL_FAL_SELF, SPELL_OHM_SELF, SPELL_ORT_SELF, SPELL_JAH_SELF };
+constexpr RunewordPattern Runeword_FAMINE = RunewordPattern(RUNEWORD_FAMINE, RunesFAMINE);
+constexpr uint32 RUNEWORD_SIZE_FAITH = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_FAITH> RunesFAITH = { SPELL_OHM_SELF, SPELL_JAH_SELF, SPELL_LEM_SELF, SPELL_ELD_SELF };
+constexpr RunewordPattern Runeword_FAITH = RunewordPattern(RUNEWORD_FAITH, RunesFAITH);
+constexpr uint32 RUNEWORD_SIZE_VOICE_OF_REASON = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_VOICE_OF_REASON> RunesVOICE_OF_REASON = { SPELL_LEM_SELF, SPELL_KO_SELF, SPELL_EL_SELF, SPELL_ELD_SELF };
+constexpr RunewordPattern Runeword_VOICE_OF_REASON = RunewordPattern(RUNEWORD_VOICE_OF_REASON, RunesVOICE_OF_REASON);
+constexpr uint32 RUNEWORD_SIZE_BRAMBLE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_BRAMBLE> RunesBRAMBLE = { SPELL_RAL_SELF, SPELL_OHM_SELF, SPELL_SUR_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_BRAMBLE = RunewordPattern(RUNEWORD_BRAMBLE, RunesBRAMBLE);
+constexpr uint32 RUNEWORD_SIZE_CHAINS_OF_HONOR = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_CHAINS_OF_HONOR> RunesCHAINS_OF_HONOR = { SPELL_DOL_SELF, SPELL_UM_SELF, SPELL_BER_SELF, SPELL_IST_SELF };
+constexpr RunewordPattern Runeword_CHAINS_OF_HONOR = RunewordPattern(RUNEWORD_CHAINS_OF_HONOR, RunesCHAINS_OF_HONOR);
+constexpr uint32 RUNEWORD_SIZE_ICE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_ICE> RunesICE = { SPELL_AMN_SELF, SPELL_SHAEL_SELF, SPELL_JAH_SELF, SPELL_LO_SELF };
+constexpr RunewordPattern Runeword_ICE = RunewordPattern(RUNEWORD_ICE, RunesICE);
+constexpr uint32 RUNEWORD_SIZE_INFINITY = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_INFINITY> RunesINFINITY = { SPELL_BER_SELF, SPELL_MAL_SELF, SPELL_BER_SELF, SPELL_IST_SELF };
+constexpr RunewordPattern Runeword_INFINITY = RunewordPattern(RUNEWORD_INFINITY, RunesINFINITY);
+constexpr uint32 RUNEWORD_SIZE_PHOENIX = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_PHOENIX> RunesPHOENIX = { SPELL_VEX_SELF, SPELL_VEX_SELF, SPELL_LO_SELF, SPELL_JAH_SELF };
+constexpr RunewordPattern Runeword_PHOENIX = RunewordPattern(RUNEWORD_PHOENIX, RunesPHOENIX);
+constexpr uint32 RUNEWORD_SIZE_BRAND = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_BRAND> RunesBRAND = { SPELL_JAH_SELF, SPELL_LO_SELF, SPELL_MAL_SELF, SPELL_GUL_SELF };
+constexpr RunewordPattern Runeword_BRAND = RunewordPattern(RUNEWORD_BRAND, RunesBRAND);
+constexpr uint32 RUNEWORD_SIZE_EXILE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_EXILE> RunesEXILE = { SPELL_VEX_SELF, SPELL_OHM_SELF, SPELL_IST_SELF, SPELL_DOL_SELF };
+constexpr RunewordPattern Runeword_EXILE = RunewordPattern(RUNEWORD_EXILE, RunesEXILE);
+constexpr uint32 RUNEWORD_SIZE_STONE = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_STONE> RunesSTONE = { SPELL_SHAEL_SELF, SPELL_UM_SELF, SPELL_PUL_SELF, SPELL_LUM_SELF };
+constexpr RunewordPattern Runeword_STONE = RunewordPattern(RUNEWORD_STONE, RunesSTONE);
+constexpr uint32 RUNEWORD_SIZE_WRATH = 4;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_WRATH> RunesWRATH = { SPELL_PUL_SELF, SPELL_LUM_SELF, SPELL_BER_SELF, SPELL_MAL_SELF };
+constexpr RunewordPattern Runeword_WRATH = RunewordPattern(RUNEWORD_WRATH, RunesWRATH);
+constexpr uint32 RUNEWORD_SIZE_HONOR = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_HONOR> RunesHONOR = { SPELL_AMN_SELF, SPELL_EL_SELF, SPELL_ITH_SELF, SPELL_TIR_SELF, SPELL_SOL_SELF };
+constexpr RunewordPattern Runeword_HONOR = RunewordPattern(RUNEWORD_HONOR, RunesHONOR);
+constexpr uint32 RUNEWORD_SIZE_DESTRUCTION = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DESTRUCTION> RunesDESTRUCTION = { SPELL_VEX_SELF, SPELL_LO_SELF, SPELL_BER_SELF, SPELL_JAH_SELF, SPELL_KO_SELF };
+constexpr RunewordPattern Runeword_DESTRUCTION = RunewordPattern(RUNEWORD_DESTRUCTION, RunesDESTRUCTION);
+constexpr uint32 RUNEWORD_SIZE_DOOM = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DOOM> RunesDOOM = { SPELL_HEL_SELF, SPELL_OHM_SELF, SPELL_UM_SELF, SPELL_LO_SELF, SPELL_CHAM_SELF };
+constexpr RunewordPattern Runeword_DOOM = RunewordPattern(RUNEWORD_DOOM, RunesDOOM);
+constexpr uint32 RUNEWORD_SIZE_CALL_TO_ARMS = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_CALL_TO_ARMS> RunesCALL_TO_ARMS = { SPELL_AMN_SELF, SPELL_RAL_SELF, SPELL_MAL_SELF, SPELL_IST_SELF, SPELL_OHM_SELF };
+constexpr RunewordPattern Runeword_CALL_TO_ARMS = RunewordPattern(RUNEWORD_CALL_TO_ARMS, RunesCALL_TO_ARMS);
+constexpr uint32 RUNEWORD_SIZE_BEAST = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_BEAST> RunesBEAST = { SPELL_BER_SELF, SPELL_TIR_SELF, SPELL_UM_SELF, SPELL_MAL_SELF, SPELL_LUM_SELF };
+constexpr RunewordPattern Runeword_BEAST = RunewordPattern(RUNEWORD_BEAST, RunesBEAST);
+constexpr uint32 RUNEWORD_SIZE_DEATH = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_DEATH> RunesDEATH = { SPELL_HEL_SELF, SPELL_EL_SELF, SPELL_VEX_SELF, SPELL_ORT_SELF, SPELL_GUL_SELF };
+constexpr RunewordPattern Runeword_DEATH = RunewordPattern(RUNEWORD_DEATH, RunesDEATH);
+constexpr uint32 RUNEWORD_SIZE_ETERNITY = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_ETERNITY> RunesETERNITY = { SPELL_AMN_SELF, SPELL_BER_SELF, SPELL_IST_SELF, SPELL_SOL_SELF, SPELL_SUR_SELF };
+constexpr RunewordPattern Runeword_ETERNITY = RunewordPattern(RUNEWORD_ETERNITY, RunesETERNITY);
+constexpr uint32 RUNEWORD_SIZE_GRIEF = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_GRIEF> RunesGRIEF = { SPELL_ETH_SELF, SPELL_TIR_SELF, SPELL_LO_SELF, SPELL_MAL_SELF, SPELL_RAL_SELF };
+constexpr RunewordPattern Runeword_GRIEF = RunewordPattern(RUNEWORD_GRIEF, RunesGRIEF);
+constexpr uint32 RUNEWORD_SIZE_OBEDIENCE = 5;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_OBEDIENCE> RunesOBEDIENCE = { SPELL_HEL_SELF, SPELL_KO_SELF, SPELL_THUL_SELF, SPELL_ETH_SELF, SPELL_FAL_SELF };
+constexpr RunewordPattern Runeword_OBEDIENCE = RunewordPattern(RUNEWORD_OBEDIENCE, RunesOBEDIENCE);
+constexpr uint32 RUNEWORD_SIZE_SILENCE = 6;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_SILENCE> RunesSILENCE = { SPELL_DOL_SELF, SPELL_ELD_SELF, SPELL_HEL_SELF, SPELL_IST_SELF, SPELL_TIR_SELF, SPELL_VEX_SELF };
+constexpr RunewordPattern Runeword_SILENCE = RunewordPattern(RUNEWORD_SILENCE, RunesSILENCE);
+constexpr uint32 RUNEWORD_SIZE_LAST_WISH = 6;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_LAST_WISH> RunesLAST_WISH = { SPELL_JAH_SELF, SPELL_MAL_SELF, SPELL_JAH_SELF, SPELL_SUR_SELF, SPELL_JAH_SELF, SPELL_BER_SELF };
+constexpr RunewordPattern Runeword_LAST_WISH = RunewordPattern(RUNEWORD_LAST_WISH, RunesLAST_WISH);
+constexpr uint32 RUNEWORD_SIZE_BREATH_OF_THE_DYING = 6;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_BREATH_OF_THE_DYING> RunesBREATH_OF_THE_DYING = { SPELL_VEX_SELF, SPELL_HEL_SELF, SPELL_EL_SELF, SPELL_ELD_SELF, SPELL_ZOD_SELF, SPELL_ETH_SELF };
+constexpr RunewordPattern Runeword_BREATH_OF_THE_DYING = RunewordPattern(RUNEWORD_BREATH_OF_THE_DYING, RunesBREATH_OF_THE_DYING);
+constexpr uint32 RUNEWORD_SIZE_OBSESSION = 6;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_OBSESSION> RunesOBSESSION = { SPELL_ZOD_SELF, SPELL_IST_SELF, SPELL_LEM_SELF, SPELL_LUM_SELF, SPELL_IO_SELF, SPELL_NEF_SELF };
+constexpr RunewordPattern Runeword_OBSESSION = RunewordPattern(RUNEWORD_OBSESSION, RunesOBSESSION);
+constexpr uint32 RUNEWORD_SIZE_UNBENDING_WILL = 6;
+constexpr RuneSpellsArray<RUNEWORD_SIZE_UNBENDING_WILL> RunesUNBENDING_WILL = { SPELL_FAL_SELF, SPELL_IO_SELF, SPELL_ITH_SELF, SPELL_ELD_SELF, SPELL_EL_SELF, SPELL_HEL_SELF };
+constexpr RunewordPattern Runeword_UNBENDING_WILL = RunewordPattern(RUNEWORD_UNBENDING_WILL, RunesUNBENDING_WILL);
+
+//List, strokes are scattered, RunePatterns is the flattened copy
+constexpr RunePattern RunePatternDefs[MAX_RUNE_TYPES] =
+{
+    Rune_EL1,
+    Rune_EL2,
+    Rune_ELD1,
+    Rune_ELD2,
+    Rune_TIR1,
+    Rune_TIR2,
+    Rune_NEF,
+    Rune_ETH1,
+    Rune_ETH2,
+    Rune_ITH1,
+    Rune_ITH2,
+    Rune_TAL1,
+    Rune_TAL2,
+    Rune_TAL3,
+    Rune_RAL,
+    Rune_ORT1,
+    Rune_ORT2,
+    Rune_ORT3,
+    Rune_THUL,
+    Rune_AMN,
+    Rune_SOL,
+    Rune_SHAEL1,
+    Rune_SHAEL2,
+    Rune_DOL1,
+    Rune_DOL2,
+    Rune_HEL1,
+    Rune_HEL2,
+    Rune_IO1,
+    Rune_IO2,
+    Rune_IO3,
+    Rune_LUM,
+    Rune_KO,
+    Rune_FAL1,
+    Rune_FAL2,
+    Rune_FAL3,
+    Rune_FAL4,
+    Rune_FAL5,
+    Rune_FAL6,
+    Rune_LEM1,
+    Rune_LEM2,
+    Rune_LEM3,
+    Rune_LEM4,
+    Rune_PUL,
+    Rune_UM1,
+    Rune_UM2,
+    Rune_UM3,
+    Rune_MAL1,
+    Rune_MAL2,
+    Rune_IST,
+    Rune_GUL1,
+    Rune_GUL2,
+    Rune_GUL3,
+    Rune_VEX1,
+    Rune_VEX2,
+    Rune_VEX3,
+    Rune_VEX4,
+    Rune_VEX5,
+    Rune_VEX6,
+    Rune_OHM,
+    Rune_LO1,
+    Rune_LO2,
+    Rune_LO3,
+    Rune_LO4,
+    Rune_SUR1,
+    Rune_SUR2,
+    Rune_BER,
+    Rune_JAH1,
+    Rune_JAH2,
+    Rune_JAH3,
+    Rune_JAH4,
+    Rune_JAH5,
+    Rune_CHAM1,
+    Rune_CHAM2,
+    Rune_CHAM3,
+    Rune_CHAM4,
+    Rune_CHAM5,
+    Rune_CHAM6,
+    Rune_CHAM7,
+    Rune_CHAM8,
+    Rune_CHAM9,
+    Rune_ZOD1,
+    Rune_ZOD2
+};
+
+//Flattened pattern data
+//Masks of all built-in runes packed into one 64-byte aligned block in rune order, with an offset/length table.
+//RunePatterns point into it, so a recognition pass walks one contiguous block instead of a line per rune.
+constexpr size_t RUNE_ARENA_SIZE = []
+{
+    size_t size = 0;
+    for (RunePattern const& pattern : RunePatternDefs)
+        size += pattern.size;
+    return size;
+}();
+
+struct RuneArenaSpan
+{
+    uint16 offset;
+    uint8 size;
+    uint8 minSize;
+};
+
+struct RunePatternArena
+{
+    alignas(64) StrokeTypeDefs masks[RUNE_ARENA_SIZE] = { };
+    RuneArenaSpan spans[MAX_RUNE_TYPES] = { };
+};
+
+constexpr RunePatternArena BuildRunePatternArena()
+{
+    RunePatternArena arena;
+    uint16 offset = 0;
+    for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+    {
+        RunePattern const& pattern = RunePatternDefs[i];
+        if (pattern.type != i)
+            throw -1; //patterns must follow rune types
+
+        arena.spans[i] = { offset, pattern.size, pattern.minSize };
+        for (uint8 k = 0; k < pattern.size; ++k)
+            arena.masks[offset++] = pattern.strokeSequence[k];
+    }
+    return arena;
+}
+
+constexpr RunePatternArena RuneArena = BuildRunePatternArena();
+
+template<size_t... I>
+constexpr std::array<RunePattern, sizeof...(I)> BuildArenaPatterns(std::index_sequence<I...>)
+{
+    return { RunePattern(uint8(I), RuneArena.masks + RuneArena.spans[I].offset, RuneArena.spans[I].size, RuneArena.spans[I].minSize)... };
+}
+
+constexpr std::array<RunePattern, MAX_RUNE_TYPES> RunePatterns = BuildArenaPatterns(std::make_index_sequence<MAX_RUNE_TYPES>());
+
+static_assert(RUNE_ARENA_SIZE <= UINT16_MAX && alignof(RunePatternArena) == 64, "arena offsets are uint16, masks start a cache line");
+
+constexpr RunewordPattern RunewordPatterns[MAX_RUNEWORD_TYPES] =
+{
+    Runeword_STEEL,
+    Runeword_NADIR,
+    Runeword_MALICE,
+    Runeword_STEALTH,
+    Runeword_LEAF,
+    Runeword_ZEPHYR,
+    Runeword_ANCIENTS_PLEDGE,
+    Runeword_STRENGTH,
+    Runeword_EDGE,
+    Runeword_KINGS_GRACE,
+    Runeword_RADIANCE,
+    Runeword_LORE,
+    Runeword_RHYME,
+    Runeword_PEACE,
+    Runeword_MYTH,
+    Runeword_BLACK,
+    Runeword_WHITE,
+    Runeword_SMOKE,
+    Runeword_SPLENDOR,
+    Runeword_MELODY,
+    Runeword_LIONHEART,
+    Runeword_TREACHERY,
+    Runeword_WEALTH,
+    Runeword_LAWBRINGER,
+    Runeword_ENLIGHTENMENT,
+    Runeword_CRESCENT_MOON,
+    Runeword_DURESS,
+    Runeword_GLOOM,
+    Runeword_PRUDENCE,
+    Runeword_RAIN,
+    Runeword_VENOM,
+    Runeword_SANCTUARY,
+    Runeword_DELIRIUM,
+    Runeword_PRINCIPLE,
+    Runeword_CHAOS,
+    Runeword_WIND,
+    Runeword_DRAGON,
+    Runeword_DREAM,
+    Runeword_FURY,
+    Runeword_ENIGMA,
+    Runeword_BONE,
+    Runeword_PATTERN,
+    Runeword_PLAGUE,
+    Runeword_WISDOM,
+    Runeword_FLICKERING_FLAME,
+    Runeword_SPIRIT,
+    Runeword_INSIGHT,
+    Runeword_HARMONY,
+    Runeword_RIFT,
+    Runeword_PASSION,
+    Runeword_KINGSLAYER,
+    Runeword_HEART_OF_THE_OAK,
+    Runeword_PRIDE,
+    Runeword_MEMORY,
+    Runeword_OATH,
+    Runeword_HOLY_THUNDER,
+    Runeword_HAND_OF_JUSTICE,
+    Runeword_FORTITUDE,
+    Runeword_FAMINE,
+    Runeword_FAITH,
+    Runeword_VOICE_OF_REASON,
+    Runeword_BRAMBLE,
+    Runeword_CHAINS_OF_HONOR,
+    Runeword_ICE,
+    Runeword_INFINITY,
+    Runeword_PHOENIX,
+    Runeword_BRAND,
+    Runeword_EXILE,
+    Runeword_STONE,
+    Runeword_WRATH,
+    Runeword_HONOR,
+    Runeword_DESTRUCTION,
+    Runeword_DOOM,
+    Runeword_CALL_TO_ARMS,
+    Runeword_BEAST,
+    Runeword_DEATH,
+    Runeword_ETERNITY,
+    Runeword_GRIEF,
+    Runeword_OBEDIENCE,
+    Runeword_SILENCE,
+    Runeword_LAST_WISH,
+    Runeword_BREATH_OF_THE_DYING,
+    Runeword_OBSESSION,
+    Runeword_UNBENDING_WILL
+};
+
+//Descriptors (logs, pattern pack)
+constexpr char const* RuneTypeNames[MAX_RUNE_TYPES] =
+{
+    "EL1", "EL2", "ELD1", "ELD2", "TIR1", "TIR2", "NEF", "ETH1", "ETH2", "ITH1",
+    "ITH2", "TAL1", "TAL2", "TAL3", "RAL", "ORT1", "ORT2", "ORT3", "THUL", "AMN",
+    "SOL", "SHAEL1", "SHAEL2", "DOL1", "DOL2", "HEL1", "HEL2", "IO1", "IO2", "IO3",
+    "LUM", "KO", "FAL1", "FAL2", "FAL3", "FAL4", "FAL5", "FAL6", "LEM1", "LEM2",
+    "LEM3", "LEM4", "PUL", "UM1", "UM2", "UM3", "MAL1", "MAL2", "IST", "GUL1",
+    "GUL2", "GUL3", "VEX1", "VEX2", "VEX3", "VEX4", "VEX5", "VEX6", "OHM", "LO1",
+    "LO2", "LO3", "LO4", "SUR1", "SUR2", "BER", "JAH1", "JAH2", "JAH3", "JAH4",
+    "JAH5", "CHAM1", "CHAM2", "CHAM3", "CHAM4", "CHAM5", "CHAM6", "CHAM7", "CHAM8", "CHAM9",
+    "ZOD1", "ZOD2"
+};
+
+constexpr char const* RunewordTypeNames[MAX_RUNEWORD_TYPES] =
+{
+    "STEEL", "NADIR", "MALICE", "STEALTH", "LEAF", "ZEPHYR", "ANCIENTS_PLEDGE", "STRENGTH", "EDGE", "KINGS_GRACE",
+    "RADIANCE", "LORE", "RHYME", "PEACE", "MYTH", "BLACK", "WHITE", "SMOKE", "SPLENDOR", "MELODY", "LIONHEART",
+    "TREACHERY", "WEALTH", "LAWBRINGER", "ENLIGHTENMENT", "CRESCENT_MOON", "DURESS", "GLOOM", "PRUDENCE", "RAIN",
+    "VENOM", "SANCTUARY", "DELIRIUM", "PRINCIPLE", "CHAOS", "WIND", "DRAGON", "DREAM", "FURY", "ENIGMA", "BONE",
+    "PATTERN", "PLAGUE", "WISDOM", "FLICKERING_FLAME", "SPIRIT", "INSIGHT", "HARMONY", "RIFT", "PASSION", "KINGSLAYER",
+    "HEART_OF_THE_OAK", "PRIDE", "MEMORY", "OATH", "HOLY_THUNDER", "HAND_OF_JUSTICE", "FORTITUDE", "FAMINE", "FAITH",
+    "VOICE_OF_REASON", "BRAMBLE", "CHAINS_OF_HONOR", "ICE", "INFINITY", "PHOENIX", "BRAND", "EXILE", "STONE", "WRATH",
+    "HONOR", "DESTRUCTION", "DOOM", "CALL_TO_ARMS", "BEAST", "DEATH", "ETERNITY", "GRIEF", "OBEDIENCE", "SILENCE",
+    "LAST_WISH", "BREATH_OF_THE_DYING", "OBSESSION", "UNBENDING_WILL"
+};
+
+//Pattern index
+constexpr size_t MAX_RUNE_PATTERNS = 128;
+
+//set of pattern indexes
+struct RunePatternBits
+{
+    constexpr void Set(size_t i) { words[i / 64] |= (uint64(1) << (i % 64)); }
+    constexpr bool Test(size_t i) const { return words[i / 64] & (uint64(1) << (i % 64)); }
+    constexpr RunePatternBits& operator|=(RunePatternBits const& other)
+    {
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] |= other.words[i];
+        return *this;
+    }
+    constexpr RunePatternBits& operator&=(RunePatternBits const& other)
+    {
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] &= other.words[i];
+        return *this;
+    }
+    constexpr void Remove(RunePatternBits const& other)
+    {
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] &= ~other.words[i];
+    }
+
+    //calls func(index) for every set index in ascending order
+    template<typename F>
+    constexpr void ForEach(F&& func) const
+    {
+        for (size_t i = 0; i < words.size(); ++i)
+            for (uint64 bits = words[i]; bits; bits &= bits - 1)
+                func(i * 64 + size_t(std::countr_zero(bits)));
+    }
+
+    std::array<uint64, MAX_RUNE_PATTERNS / 64> words = {};
+};
+
+//Stroke type histogram, one byte per type (LINE..TURN_SHARP),
+//byte 0 counts the cubic-or-sharp class (slots accepting only TURN_CUBIC and/or TURN_SHARP)
+typedef uint64 RuneStrokeSignature;
+
+//Lower bound for pattern slots left without a stroke of their type.
+//Only non-empty single type (or cubic-or-sharp) slots are counted, every such slot
+//needs its own stroke unless it is one of the allowed mismatches
+constexpr uint32 GetSignatureDeficit(RuneStrokeSignature need, RuneStrokeSignature have)
+{
+    constexpr uint64 HIGH = 0x8080808080808080ull;
+    constexpr uint64 LOW = 0x7F7F7F7F7F7F7F7Full;
+    constexpr uint64 SINGLE_TYPES = 0x000000FFFFFFFF00ull; //LINE..CURVE_H
+
+    //per byte: 128 + need - have, counts are below 128 so no byte borrows from the next one
+    uint64 diff = (need | HIGH) - have;
+    uint64 deficit = diff & LOW & (((diff & HIGH) >> 7) * 0xFF); //max(need - have, 0)
+
+    uint32 single = uint32(((deficit & SINGLE_TYPES) * 0x0101010101010101ull) >> 56);
+    uint32 cubic = uint32(deficit >> (TURN_CUBIC * 8)) & 0xFF;
+    uint32 sharp = uint32(deficit >> (TURN_SHARP * 8)) & 0xFF;
+    uint32 cubicOrSharp = uint32(deficit) & 0xFF;
+    return single + std::max(cubic + sharp, cubicOrSharp);
+}
+
+constexpr RuneStrokeSignature GetStrokeSignature(Strokes const& compSeq)
+{
+    RuneStrokeSignature have = 0;
+    for (Stroke const& stroke : compSeq)
+        have += RuneStrokeSignature(1) << (stroke.type * 8);
+    have += ((have >> (TURN_CUBIC * 8)) & 0xFF) + ((have >> (TURN_SHARP * 8)) & 0xFF);
+    return have;
+}
+
+//Early rejection before RunePattern::Matches, a pattern stays a candidate if
+//- minSize fits into the sequence
+//- some stroke is accepted by its first slot
+//- stroke type histogram misses no more slots than UNMATCH_THRESHOLD plus optional slots
+//  (a slot behind skipped optional ones may be left unchecked when the sequence ends)
+struct RuneCandidateIndex
+{
+    //extraErrors: error budget above UNMATCH_THRESHOLD (approximate matcher)
+    constexpr RunePatternBits Candidates(Strokes const& compSeq, uint32 extraErrors = 0) const
+    {
+        RunePatternBits candidates;
+        for (Stroke const& stroke : compSeq)
+            candidates |= byStroke[stroke.type];
+        candidates &= byLength[std::min(compSeq.size(), MAX_RUNE_PATTERN_LENGTH)];
+
+        RuneStrokeSignature have = GetStrokeSignature(compSeq);
+        RunePatternBits result;
+        candidates.ForEach([&](size_t i)
+        {
+            if (GetSignatureDeficit(signatures[i], have) <= allowances[i] + extraErrors)
+                result.Set(i);
+        });
+        return result;
+    }
+
+    std::array<RunePatternBits, TURN_REVERSE> byStroke = {};
+    std::array<RunePatternBits, MAX_RUNE_PATTERN_LENGTH + 1> byLength = {};
+    std::array<RuneStrokeSignature, MAX_RUNE_PATTERNS> signatures = {};
+    std::array<uint8, MAX_RUNE_PATTERNS> allowances = {};
+};
+
+constexpr RuneCandidateIndex BuildCandidateIndex(RunePattern const* patterns, size_t count)
+{
+    RuneCandidateIndex index;
+    for (size_t i = 0; i < count && i < MAX_RUNE_PATTERNS; ++i)
+    {
+        RunePattern const& pattern = patterns[i];
+        for (uint8 type = LINE; type < TURN_REVERSE; ++type)
+            if (pattern.strokeSequence[0] & (1 << type))
+                index.byStroke[type].Set(i);
+
+        for (size_t length = pattern.minSize; length <= MAX_RUNE_PATTERN_LENGTH; ++length)
+            index.byLength[length].Set(i);
+
+        uint32 optional = 0;
+        for (size_t k = 0; k < pattern.size; ++k)
+        {
+            uint32 mask = pattern.strokeSequence[k] & ~(STDEF_REV | STDEF_CAN_BE_EMPTY);
+            if (pattern.strokeSequence[k] & STDEF_CAN_BE_EMPTY)
+                ++optional;
+            else
+            {
+                if (std::has_single_bit(mask))
+                    index.signatures[i] += RuneStrokeSignature(1) << (std::countr_zero(mask) * 8);
+                if (!(mask & ~(STDEF_TURN_CUBIC | STDEF_TURN_SHARP)))
+                    index.signatures[i] += 1;
+            }
+        }
+        index.allowances[i] = uint8(UNMATCH_THRESHOLD + optional);
+    }
+    return index;
+}
+
+constexpr RuneCandidateIndex RuneCandidates = BuildCandidateIndex(RunePatterns.data(), MAX_RUNE_TYPES);
+
+//runewords using a given rune; a runeword is a candidate only if none of its runes is missing,
+//so lookup cost depends on the rune count, not on the catalog size
+struct RunewordRuneIndex
+{
+    constexpr RunePatternBits Candidates(RuneStacks const& stacks) const
+    {
+        RunePatternBits candidates = all;
+        for (size_t i = 0; i < MAX_RUNE_SPELLS; ++i)
+            if (!stacks[i])
+                candidates.Remove(byRune[i]);
+        return candidates;
+    }
+
+    RunePatternBits all;
+    std::array<RunePatternBits, MAX_RUNE_SPELLS> byRune = {};
+};
+
+constexpr RunewordRuneIndex BuildRunewordRuneIndex(RunewordPattern const* patterns, size_t count)
+{
+    RunewordRuneIndex index;
+    for (size_t i = 0; i < count && i < MAX_RUNE_PATTERNS; ++i)
+    {
+        index.all.Set(i);
+        for (size_t j = 0; j < patterns[i].size; ++j)
+            index.byRune[patterns[i].runeSpellList[j] - SPELL_EL_SELF].Set(i);
+    }
+    return index;
+}
+
+constexpr RunewordRuneIndex RunewordRunes = BuildRunewordRuneIndex(RunewordPatterns, MAX_RUNEWORD_TYPES);
+
+static_assert(MAX_RUNEWORD_TYPES <= MAX_RUNE_PATTERNS, "runeword index is too small");
+static_assert(GetRunewordSpell(RUNEWORD_SANCTUARY) == SPELL_SANCTUARY && GetRunewordSpell(RUNEWORD_ENIGMA) == SPELL_ENIGMA &&
+    GetRunewordSpell(MAX_RUNEWORD_TYPES - 1) == SPELL_UNBENDING_WILL, "runeword spells must follow runeword types");
+
+template<size_t N>
+constexpr bool RunePattern::MatchesReference(std::array<Stroke, N> const& compSeq, RunePattern const& pattern)
+{
+    using StrokeArr = std::array<Stroke, N>;
+
+    uint8 minSize = pattern.minSize;
+    uint8 size = pattern.size;
+    StrokeTypeDefs const* strokeSequence = pattern.strokeSequence;
+
+    if (minSize > compSeq.size())
+        return false; //impossible
+
+    StrokeTypeDefs jStroke = StrokeTypeDefs(0);
+    [[maybe_unused]] StrokeTypeDefs jStrokeP = StrokeTypeDefs(0); //set but never read, kept as in the original matcher
+    bool found = false;
+    bool fullmatch = true;
+    uint32 unmatchCount = 0;
+    int32 seqsize = compSeq.size(); // 7, minSize = 7, ST_SHARP, ST_SHARP_R, ST_SHARP_R, ST_CUBIC_OR_SHARP_R, ST_SHARP_R, ST_CURVE_LMH, ST_CURVE_LMH_R
+
+    uint32 thisMask = 0;
+    uint32 seqMask = 0;
+
+    for (int32 i = 0; i < seqsize; ++i)
+    {
+        if (minSize > seqsize - i)
+        {
+            //no way
+            fullmatch = false;
+            unmatchCount = UNMATCH_THRESHOLD + 1;
+            break;
+        }
+
+        fullmatch = true;
+        if ((1 << compSeq[i].type) & strokeSequence[0])
+        {
+            StrokeArr seq = compSeq;
+            //remove first reverse flag in the sequence to normalize
+            if (seq[i].reverse)
+                seq[i].reverse = false;
+            found = true;
+            unmatchCount = 0;
+
+            for (int32 j = i + 1, k = 1; j < seqsize && k < size; ++j, ++k)
+            {
+                jStroke = StrokeTypeDefs((seq[j].reverse) ? ((1 << seq[j].type) | STDEF_REV) : (1 << seq[j].type));
+                jStrokeP = StrokeTypeDefs((seq[j - 1].reverse) ? ((1 << seq[j - 1].type) | STDEF_REV) : (1 << seq[j - 1].type));
+                seqMask = jStroke & ~STDEF_REV;
+                thisMask = strokeSequence[k] & ~STDEF_REV;
+                //we may want to skip current node in own sequence
+                if ((thisMask & STDEF_CAN_BE_EMPTY) && k < size - 1 && seqsize < size &&
+                    (strokeSequence[k + 1] & seqMask))
+                {
+                    --j;
+                    continue;
+                }
+                //reversing alterations
+                bool revEqCur = (strokeSequence[k] & STDEF_REV) == (jStroke & STDEF_REV);
+                if (revEqCur == false || !(thisMask & seqMask))
+                {
+                    //can skip point in own sequence
+                    if ((revEqCur == true || (thisMask & ST_LINETYPES)) &&
+                        (thisMask & STDEF_CAN_BE_EMPTY))
+                    {
+                        --j;
+                        continue;
+                    }
+
+                    fullmatch = false;
+                    if (seq[j].type == ST_LINE || seq[j].type == ST_LINE_REV)
+                    {
+                        unmatchCount = UNMATCH_THRESHOLD + 1;
+                        break;
+                    }
+                    if (++unmatchCount > UNMATCH_THRESHOLD)
+                        break;
+                }
+            }
+
+            if (fullmatch || unmatchCount <= UNMATCH_THRESHOLD)
+                break;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    if (fullmatch)
+        return true;
+
+    if (unmatchCount <= UNMATCH_THRESHOLD)
+        return true;
+
+    //reverse order
+    for (int32 i = seqsize - 1; i >= 0; --i)
+    {
+        if (minSize > i + 1)
+        {
+            //no way
+            fullmatch = false;
+            unmatchCount = UNMATCH_THRESHOLD + 1;
+            break;
+        }
+
+        fullmatch = true;
+        unmatchCount = 0;
+        if ((1 << compSeq[i].type) & strokeSequence[0])
+        {
+            StrokeArr seq = compSeq;
+            //remove first reverse flag in the sequence to normalize
+            if (seq[i].reverse)
+                seq[i].reverse = false;
+            for (int32 j = i - 1, k = 1; j >= 0 && k < size; --j, ++k)
+            {
+                jStroke = StrokeTypeDefs((seq[j].reverse) ? ((1 << seq[j].type) | STDEF_REV) : (1 << seq[j].type));
+                jStrokeP = StrokeTypeDefs((seq[j + 1].reverse) ? ((1 << seq[j + 1].type) | STDEF_REV) : (1 << seq[j + 1].type));
+                seqMask = jStroke & ~STDEF_REV;
+                thisMask = strokeSequence[k] & ~STDEF_REV;
+                //we may want to skip current node in own sequence
+                if ((thisMask & STDEF_CAN_BE_EMPTY) && k < size - 1 && seqsize < size &&
+                    (strokeSequence[k + 1] & seqMask))
+                {
+                    ++j;
+                    continue;
+                }
+                //reversing alterations
+                bool revEqCur = (strokeSequence[k] & STDEF_REV) == (jStroke & STDEF_REV);
+                if (revEqCur == false || !(thisMask & seqMask))
+                {
+                    //can skip point in own sequence
+                    if ((revEqCur == true || (thisMask & ST_LINETYPES)) &&
+                        (thisMask & STDEF_CAN_BE_EMPTY))
+                    {
+                        ++j;
+                        continue;
+                    }
+
+                    fullmatch = false;
+                    if (seq[j].type == ST_LINE || seq[j].type == ST_LINE_REV)
+                    {
+                        unmatchCount = UNMATCH_THRESHOLD + 1;
+                        break;
+                    }
+                    if (++unmatchCount > UNMATCH_THRESHOLD)
+                        break;
+                }
+            }
+
+            if (fullmatch || unmatchCount <= UNMATCH_THRESHOLD)
+                break;
+        }
+    }
+
+    return fullmatch || unmatchCount <= UNMATCH_THRESHOLD;
+}
+
+//one attempt with first slot at start, reading the sequence forward (step 1) or backward (step -1)
+constexpr bool RunePattern::_MatchesFrom(RuneEncodedSequence const& seq, int32 start, int32 step, RuneMatchScore& score) const
+{
+    int32 seqsize = seq.size;
+    uint32 unmatchCount = 0;
+    int32 j = start + step, k = 1;
+    for (; j >= 0 && j < seqsize && k < size; j += step, ++k)
+    {
+        uint32 seqStroke = seq.GetMask(j);
+        uint32 seqMask = seqStroke & ~STDEF_REV;
+        uint32 thisMask = strokeSequence[k] & ~STDEF_REV;
+        //we may want to skip current node in own sequence
+        if ((thisMask & STDEF_CAN_BE_EMPTY) && k < size - 1 && seqsize < size &&
+            (strokeSequence[k + 1] & seqMask))
+        {
+            j -= step;
+            continue;
+        }
+        //reversing alterations
+        bool revEqCur = (strokeSequence[k] & STDEF_REV) == (seqStroke & STDEF_REV);
+        if (revEqCur == false || !(thisMask & seqMask))
+        {
+            //can skip point in own sequence
+            if ((revEqCur == true || (thisMask & ST_LINETYPES)) &&
+                (thisMask & STDEF_CAN_BE_EMPTY))
+            {
+                j -= step;
+                continue;
+            }
+
+            //same stroke types as the reference check (type == ST_LINE || type == ST_LINE_REV)
+            if (seqMask & ((1 << ST_LINE) | (1 << ST_LINE_REV)))
+                return false;
+            if (++unmatchCount > UNMATCH_THRESHOLD)
+                return false;
+        }
+    }
+
+    score.errors = uint8(unmatchCount);
+    score.offset = uint8(j - step);
+    score.coverage = uint8(k);
+    score.reversed = step < 0;
+    return true;
+}
+
+//single pass, forward start i and backward start n-1-i are tried together on the encoded sequence
+//backward match only counts if there is a forward start at all (as in the reference)
+constexpr bool RunePattern::Matches(Stroke const* compSeq, size_t compSize) const
+{
+    RuneMatchScore score;
+    return Matches(compSeq, compSize, score);
+}
+
+constexpr bool RunePattern::Matches(Stroke const* compSeq, size_t compSize, RuneMatchScore& score) const
+{
+    RuneEncodedSequence seq;
+    if (minSize > compSize || !EncodeRuneSequence(compSeq, compSize, seq))
+        return false; //impossible
+
+    return MatchesEncoded(seq, score);
+}
+
+constexpr bool RunePattern::MatchesEncoded(RuneEncodedSequence const& seq, RuneMatchScore& score) const
+{
+    int32 seqsize = seq.size;
+    if (minSize > seqsize)
+        return false; //impossible
+
+    //no optional slots: word-level, all starts at once
+    if (minSize == size)
+    {
+        RuneFixedMatch match(seq, size);
+        match.SetFirst(GetRuneAcceptedPositions(seq, strokeSequence[0], true));
+        for (int32 k = 1; k < size; ++k)
+            match.AddSlot(k, GetRuneAcceptedPositions(seq, strokeSequence[k], false));
+        return match.GetScore(score);
+    }
+
+    uint64 const first = GetRuneAcceptedPositions(seq, strokeSequence[0], true);
+    bool found = false;
+    bool reverseMatch = false;
+    RuneMatchScore reverseScore;
+    for (int32 i = 0; i + minSize <= seqsize; ++i)
+    {
+        if (first & (uint64(1) << i))
+        {
+            found = true;
+            if (_MatchesFrom(seq, i, 1, score))
+                return true;
+        }
+
+        int32 r = seqsize - 1 - i;
+        if (!reverseMatch && (first & (uint64(1) << r)))
+            reverseMatch = _MatchesFrom(seq, r, -1, reverseScore);
+
+        if (found && reverseMatch)
+        {
+            score = reverseScore;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<size_t N>
+constexpr bool RunePattern::Matches(std::array<Stroke, N> const& compSeq, RunePattern const& pattern)
+{
+    return pattern.Matches(compSeq.data(), N);
+}
+
+constexpr uint32 RunePattern::GetMatchErrors(Stroke const* compSeq, size_t compSize, uint32 maxErrors, RuneMatchScore* score) const
+{
+    maxErrors = std::min(maxErrors, MAX_RUNE_MATCH_ERRORS);
+    if (minSize > compSize)
+        return maxErrors + 1; //impossible
+
+    uint32 const allSlots = ~0u >> (32 - size);
+    uint32 const lastSlot = 1u << (size - 1);
+    uint32 optionalSlots = 0;
+    for (uint32 k = 0; k < size; ++k)
+        if (strokeSequence[k] & STDEF_CAN_BE_EMPTY)
+            optionalSlots |= 1u << k;
+
+    uint32 best = maxErrors + 1;
+    for (uint32 pass = 0; pass < 2 && best; ++pass)
+    {
+        //states[d] bit k: slots 0..k are done with d errors at current stroke
+        std::array<uint32, MAX_RUNE_MATCH_ERRORS + 1> states = {};
+        for (size_t i = 0; i < compSize; ++i)
+        {
+            Stroke const& stroke = compSeq[pass ? compSize - 1 - i : i];
+            uint32 const slots = slotMasks[GetStrokeSymbol(stroke.type, stroke.reverse)];
+            bool const canSubstitute = stroke.type != LINE && stroke.type != LINE_REV;
+
+            uint32 prevErrorsState = 0;
+            for (uint32 d = 0; d < best && d <= maxErrors; ++d)
+            {
+                uint32 state = ((states[d] << 1) | 1u) & slots;
+                if (d && canSubstitute)
+                    state |= prevErrorsState << 1;
+                //skip optional slots
+                for (uint32 skipped = (state << 1) & optionalSlots & ~state; skipped; skipped = (skipped << 1) & optionalSlots & ~state)
+                    state |= skipped;
+
+                prevErrorsState = states[d];
+                states[d] = state & allSlots;
+                if (states[d] & lastSlot)
+                {
+                    best = d;
+                    if (score)
+                    {
+                        score->errors = uint8(d);
+                        score->offset = uint8(pass ? compSize - 1 - i : i);
+                        score->coverage = size;
+                        score->reversed = pass;
+                    }
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+inline bool RunePattern::Matches(Strokes const& compSeq) const
+{
+    if (compSeq.size() < MIN_RUNE_PATTERN_LENGTH - 2)
+        return false;
+
+    return Matches(compSeq.data(), compSeq.size());
+}
+
+constexpr bool RunewordPattern::Contains(RuneStacks const& stacks) const
+{
+    RuneStacks needed = { };
+    for (size_t i = 0; i < size; ++i)
+    {
+        size_t rune = runeSpellList[i] - SPELL_EL_SELF;
+        if (++needed[rune] > stacks[rune])
+            return false;
+    }
+
+    return true;
+}
+
+inline bool RunewordPattern::Contains(RuneSpellVec const& compSeq) const
+{
+    if (this->size > compSeq.size())
+        return false; //impossible
+
+    //every entry is one stack
+    RuneStacks stacks = { };
+    for (RuneworderSpells spell : compSeq)
+        AddRuneStacks(stacks, spell, 1);
+
+    return Contains(stacks);
+}
+
+template<size_t M, size_t N>
+constexpr bool RunewordPattern::Contains(std::array<RuneworderSpells, N> const& compSeq, RunewordPattern const& pattern)
+{
+    if (M > compSeq.size())
+        return false; //impossible
+
+    //every entry is one stack
+    RuneStacks stacks = { };
+    for (size_t i = 0; i < N; ++i)
+        AddRuneStacks(stacks, compSeq[i], 1);
+
+    return pattern.Contains(stacks);
+}
+
+#endif
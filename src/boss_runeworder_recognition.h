@@ -0,0 +1,114 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_RECOGNITION_H
+#define BOSS_RUNEWORDER_RECOGNITION_H
+
+//Stroke engine rune recognition
+//Candidate selection, matching and the weighted roll of _ComputateRuneType. The boss script and the tools
+//(trajectory, replay, encounter, microbench) call these, so the simulators cannot drift from the module.
+
+#include "boss_runeworder_matchers.h"
+#include "boss_runeworder_table.h"
+#include <algorithm>
+
+//Active rune tables, built-in ones by default
+struct RuneRecognitionSet
+{
+    RunePattern const* patterns = RunePatterns.data();
+    RuneMatcherFunc const* matchers = RuneMatchers.data(); //per pattern, nullptr uses RunePattern::MatchesEncoded
+    RuneCandidateIndex const* candidates = &RuneCandidates;
+    RuneMatchTable const* table = nullptr; //exhaustive matches of short sequences, none if null
+};
+
+//work done by FindRuneMatches, for the stats
+struct RuneRecognitionCounts
+{
+    size_t candidates = 0;
+    bool tableLookup = false;
+    bool tableHit = false;
+};
+
+//best matches of the strokes within the error budget, sorted best first
+inline RuneRecognitionCounts FindRuneMatches(RuneRecognitionSet const& set, Strokes const& strokes, uint32 budget,
+    RuneMatchHeap<MAX_RUNE_MATCHES>& matches)
+{
+    RuneRecognitionCounts counts;
+    if (strokes.size() < MIN_RUNE_PATTERN_LENGTH)
+        return counts;
+
+    //budget above default threshold is handled by approximate matcher
+    uint32 extraErrors = budget > UNMATCH_THRESHOLD ? budget - UNMATCH_THRESHOLD : 0;
+    //short sequences: exact matches from the table, patterns are only walked for the score
+    RunePatternBits candidates;
+    counts.tableLookup = !extraErrors && set.table && !set.table->empty();
+    counts.tableHit = counts.tableLookup && set.table->Find(strokes.data(), strokes.size(), candidates);
+    if (!counts.tableHit)
+        candidates = set.candidates->Candidates(strokes, extraErrors);
+
+    //encoded once for all candidates
+    RuneEncodedSequence encoded;
+    bool isEncoded = EncodeRuneSequence(strokes.data(), strokes.size(), encoded);
+    candidates.ForEach([&](size_t i)
+    {
+        ++counts.candidates;
+        RunePattern const& pattern = set.patterns[i];
+        RuneMatch match;
+        match.type = pattern.type;
+        RuneMatcherFunc matcher = set.matchers[i];
+        bool matched = isEncoded && (matcher ? matcher(encoded, match.score) : pattern.MatchesEncoded(encoded, match.score));
+        if (matched || (extraErrors && pattern.GetMatchErrors(strokes.data(), strokes.size(), budget, &match.score) <= budget))
+        {
+            if (match.score.errors <= budget)
+                matches.Push(match);
+        }
+    });
+
+    matches.Sort();
+    return counts;
+}
+
+//rune picked from the sorted matches by a roll in [1, GetRuneRollMax()]
+constexpr uint32 GetRolledRune(RuneMatchHeap<MAX_RUNE_MATCHES> const& matches, uint32 budget, int32 roll)
+{
+    if (matches.empty())
+        return RUNE_INVALID;
+    if (matches.size() <= 1)
+        return matches.begin()->type;
+
+    uint32 weightBudget = std::max(budget, UNMATCH_THRESHOLD);
+    for (RuneMatch const& match : matches)
+    {
+        roll -= GetRuneMatchWeight(match, weightBudget);
+        if (roll <= 0)
+            return match.type;
+    }
+    return RUNE_INVALID;
+}
+
+//sum of the match weights, 0 if there is nothing to roll
+constexpr int32 GetRuneRollMax(RuneMatchHeap<MAX_RUNE_MATCHES> const& matches, uint32 budget)
+{
+    if (matches.size() <= 1)
+        return 0;
+
+    uint32 weightBudget = std::max(budget, UNMATCH_THRESHOLD);
+    int32 rollMax = 0;
+    for (RuneMatch const& match : matches)
+        rollMax += GetRuneMatchWeight(match, weightBudget);
+    return rollMax;
+}
+
+//weighted by tier and match quality, shifts roll result towards higher and cleaner runes
+//rand(min, max) is irand in the core, roll is 0 if there was nothing to roll
+template<typename Rand>
+uint32 RollRuneMatch(RuneMatchHeap<MAX_RUNE_MATCHES> const& matches, uint32 budget, Rand&& rand, int32& roll, int32& rollMax)
+{
+    rollMax = GetRuneRollMax(matches, budget);
+    roll = rollMax ? rand(1, rollMax) : 0;
+    return GetRolledRune(matches, budget, roll);
+}
+
+#endif
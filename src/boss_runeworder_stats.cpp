@@ -0,0 +1,164 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#include "boss_runeworder_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+void RuneworderHistogramSnapshot::Add(RuneworderHistogramSnapshot const& other)
+{
+    for (uint32 i = 0; i < RUNEWORDER_HISTOGRAM_BUCKETS; ++i)
+        buckets[i] += other.buckets[i];
+    count += other.count;
+    sum += other.sum;
+    max = std::max(max, other.max);
+}
+
+uint64 RuneworderHistogramSnapshot::GetPercentile(double percentile) const
+{
+    if (!count)
+        return 0;
+
+    uint64 rank = std::max<uint64>(1, uint64(std::ceil(double(count) * percentile)));
+    uint64 seen = 0;
+    for (uint32 i = 0; i < RUNEWORDER_HISTOGRAM_BUCKETS; ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::min(GetRuneworderHistogramBound(i), max);
+    }
+    return max;
+}
+
+void RuneworderHistogram::Snapshot(RuneworderHistogramSnapshot& snapshot) const
+{
+    for (uint32 i = 0; i < RUNEWORDER_HISTOGRAM_BUCKETS; ++i)
+        snapshot.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+    snapshot.sum = _sum.load(std::memory_order_relaxed);
+    snapshot.max = _max.load(std::memory_order_relaxed);
+    //the writer may be between adds, count what the buckets hold
+    snapshot.count = 0;
+    for (uint64 bucket : snapshot.buckets)
+        snapshot.count += bucket;
+}
+
+void RuneworderHistogram::Clear()
+{
+    for (std::atomic<uint64>& bucket : _buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    _sum.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+void RuneworderStatsSnapshot::Add(RuneworderStatsSnapshot const& other)
+{
+    for (uint32 i = 0; i < MAX_RUNEWORDER_COUNTERS; ++i)
+        counters[i] += other.counters[i];
+    for (uint32 i = 0; i < MAX_RUNEWORDER_LATENCIES; ++i)
+        latencies[i].Add(other.latencies[i]);
+}
+
+void RuneworderStatsBlock::Snapshot(RuneworderStatsSnapshot& snapshot) const
+{
+    for (uint32 i = 0; i < MAX_RUNEWORDER_COUNTERS; ++i)
+        snapshot.counters[i] = _counters[i].load(std::memory_order_relaxed);
+    for (uint32 i = 0; i < MAX_RUNEWORDER_LATENCIES; ++i)
+        _latencies[i].Snapshot(snapshot.latencies[i]);
+}
+
+void RuneworderStatsBlock::Clear()
+{
+    for (std::atomic<uint64>& counter : _counters)
+        counter.store(0, std::memory_order_relaxed);
+    for (RuneworderHistogram& histogram : _latencies)
+        histogram.Clear();
+}
+
+void FormatRuneworderStats(RuneworderStatsSnapshot const& stats, std::vector<std::string>& lines)
+{
+    std::array<uint64, MAX_RUNEWORDER_COUNTERS> const& counters = stats.counters;
+    char line[256];
+    std::snprintf(line, sizeof(line), "%s %llu (%s %llu, %.2f %s each), %s %llu of %llu, %s %llu, %s %llu, %s %llu, %s %llu, %s %llu",
+        RuneworderCounterNames[RUNEWORDER_COUNTER_RUNES], (unsigned long long)counters[RUNEWORDER_COUNTER_RUNES],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_RUNES_INVALID], (unsigned long long)counters[RUNEWORDER_COUNTER_RUNES_INVALID],
+        counters[RUNEWORDER_COUNTER_RUNES] ? double(counters[RUNEWORDER_COUNTER_RUNE_MATCHES]) / double(counters[RUNEWORDER_COUNTER_RUNES]) : 0.0,
+        RuneworderCounterNames[RUNEWORDER_COUNTER_RUNE_MATCHES],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_TABLE_HITS], (unsigned long long)counters[RUNEWORDER_COUNTER_TABLE_HITS],
+        (unsigned long long)counters[RUNEWORDER_COUNTER_TABLE_LOOKUPS],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_RUNEWORDS], (unsigned long long)counters[RUNEWORDER_COUNTER_RUNEWORDS],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_SUMMONS], (unsigned long long)counters[RUNEWORDER_COUNTER_SUMMONS],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_DESPAWNS], (unsigned long long)counters[RUNEWORDER_COUNTER_DESPAWNS],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_LIFESTEAL], (unsigned long long)counters[RUNEWORDER_COUNTER_LIFESTEAL],
+        RuneworderCounterNames[RUNEWORDER_COUNTER_THORNS], (unsigned long long)counters[RUNEWORDER_COUNTER_THORNS]);
+    lines.push_back(line);
+
+    for (uint32 i = 0; i < MAX_RUNEWORDER_LATENCIES; ++i)
+    {
+        RuneworderHistogramSnapshot const& latency = stats.latencies[i];
+        if (!latency.count)
+            continue;
+        std::snprintf(line, sizeof(line), "%s: %llu, mean %.2f us, p50 %.2f us, p99 %.2f us, max %.2f us", RuneworderLatencyNames[i],
+            (unsigned long long)latency.count, latency.GetMean() * 0.001, latency.GetPercentile(0.5) * 0.001,
+            latency.GetPercentile(0.99) * 0.001, latency.max * 0.001);
+        lines.push_back(line);
+    }
+}
+
+std::shared_ptr<RuneworderStatsBlock> RuneworderStatsRegistry::GetInstance(uint32 mapId, uint32 instanceId)
+{
+    uint64 key = (uint64(mapId) << 32) | instanceId;
+    std::lock_guard<std::mutex> guard(_lock);
+    std::weak_ptr<RuneworderStatsBlock>& entry = _instances[key];
+    if (std::shared_ptr<RuneworderStatsBlock> block = entry.lock())
+        return block;
+
+    std::shared_ptr<RuneworderStatsBlock> block(new RuneworderStatsBlock(), [this, key](RuneworderStatsBlock* retired) { _Retire(key, retired); });
+    entry = block;
+    return block;
+}
+
+void RuneworderStatsRegistry::Collect(std::vector<InstanceStats>& instances, RuneworderStatsSnapshot& total) const
+{
+    instances.clear();
+    std::lock_guard<std::mutex> guard(_lock);
+    total = _retired;
+    for (auto const& [key, entry] : _instances)
+    {
+        std::shared_ptr<RuneworderStatsBlock> block = entry.lock();
+        if (!block)
+            continue;
+
+        InstanceStats instance = { uint32(key >> 32), uint32(key), RuneworderStatsSnapshot() };
+        block->Snapshot(instance.stats);
+        total.Add(instance.stats);
+        instances.push_back(instance);
+    }
+}
+
+//counts added while clearing may be lost
+void RuneworderStatsRegistry::Clear()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _retired = RuneworderStatsSnapshot();
+    for (auto const& [key, entry] : _instances)
+        if (std::shared_ptr<RuneworderStatsBlock> block = entry.lock())
+            block->Clear();
+}
+
+//last holder is gone (instance unloaded), its counts go to the total
+void RuneworderStatsRegistry::_Retire(uint64 key, RuneworderStatsBlock* block)
+{
+    RuneworderStatsSnapshot snapshot;
+    block->Snapshot(snapshot);
+    delete block;
+
+    std::lock_guard<std::mutex> guard(_lock);
+    _retired.Add(snapshot);
+    //may already belong to a new block of the same instance
+    std::map<uint64, std::weak_ptr<RuneworderStatsBlock>>::iterator itr = _instances.find(key);
+    if (itr != _instances.end() && itr->second.expired())
+        _instances.erase(itr);
+}
@@ -0,0 +1,207 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_STATS_H
+#define BOSS_RUNEWORDER_STATS_H
+
+//Encounter counters and latency histograms (.runeworder stats)
+//Each map instance with a runeworder gets its own block, written only by the map thread that updates
+//its creatures: relaxed atomic adds on cache lines no other thread writes. Nothing is summed or locked
+//on the update path, the command takes the snapshots and adds them up. Blocks of unloaded instances
+//are folded into the finished total. Latencies need two clock reads per scope, so they are only taken
+//while enabled (Runeworder.Stats.Latency, .runeworder stats latency on).
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum RuneworderCounters
+{
+    RUNEWORDER_COUNTER_RUNES,           //runes computed
+    RUNEWORDER_COUNTER_RUNES_INVALID,   //runes without a match (SPELL_RUNIC_WITHDRAWAL)
+    RUNEWORDER_COUNTER_RUNE_MATCHES,    //matches over all computed runes
+    RUNEWORDER_COUNTER_TABLE_LOOKUPS,   //strokes looked up in the match table
+    RUNEWORDER_COUNTER_TABLE_HITS,      //covered by the table, candidate index skipped
+    RUNEWORDER_COUNTER_RUNEWORDS,       //runewords resolved
+    RUNEWORDER_COUNTER_SUMMONS,         //carvers and rune points
+    RUNEWORDER_COUNTER_DESPAWNS,
+    RUNEWORDER_COUNTER_LIFESTEAL,       //SPELL_LIFESTEAL casts
+    RUNEWORDER_COUNTER_THORNS,          //SPELL_THORNS_AURA_DAMAGE casts
+    MAX_RUNEWORDER_COUNTERS
+};
+
+constexpr char const* RuneworderCounterNames[MAX_RUNEWORDER_COUNTERS] =
+{
+    "runes", "invalid", "matches", "table lookups", "table hits", "runewords", "summons", "despawns", "lifesteal", "thorns"
+};
+
+enum RuneworderLatencies
+{
+    RUNEWORDER_LATENCY_BOSS,            //boss_runeworderAI::UpdateAI
+    RUNEWORDER_LATENCY_CARVER,          //npc_rune_carverAI::UpdateAI
+    RUNEWORDER_LATENCY_RUNE,            //_ComputateRuneType
+    MAX_RUNEWORDER_LATENCIES
+};
+
+constexpr char const* RuneworderLatencyNames[MAX_RUNEWORDER_LATENCIES] = { "boss UpdateAI", "carver UpdateAI", "rune computation" };
+
+//4 buckets per power of two, values up to 2^36 ns (68 s)
+constexpr uint32 RUNEWORDER_HISTOGRAM_SUB_BITS = 2;
+constexpr uint32 RUNEWORDER_HISTOGRAM_MAX_BITS = 36;
+constexpr uint32 RUNEWORDER_HISTOGRAM_BUCKETS = (RUNEWORDER_HISTOGRAM_MAX_BITS - RUNEWORDER_HISTOGRAM_SUB_BITS + 1) << RUNEWORDER_HISTOGRAM_SUB_BITS;
+
+//bucket of a value: exact below 4, then 2 bits below the leading one
+constexpr uint32 GetRuneworderHistogramBucket(uint64 value)
+{
+    constexpr uint32 sub = 1 << RUNEWORDER_HISTOGRAM_SUB_BITS;
+    if (value < sub)
+        return uint32(value);
+    uint32 bits = 0;
+    for (uint64 v = value; v >>= 1;)
+        ++bits;
+    if (bits >= RUNEWORDER_HISTOGRAM_MAX_BITS)
+        return RUNEWORDER_HISTOGRAM_BUCKETS - 1;
+    return ((bits - RUNEWORDER_HISTOGRAM_SUB_BITS + 1) << RUNEWORDER_HISTOGRAM_SUB_BITS) +
+        uint32((value >> (bits - RUNEWORDER_HISTOGRAM_SUB_BITS)) & (sub - 1));
+}
+
+//largest value of a bucket
+constexpr uint64 GetRuneworderHistogramBound(uint32 bucket)
+{
+    constexpr uint32 sub = 1 << RUNEWORDER_HISTOGRAM_SUB_BITS;
+    if (bucket < sub)
+        return bucket;
+    uint32 bits = (bucket >> RUNEWORDER_HISTOGRAM_SUB_BITS) + RUNEWORDER_HISTOGRAM_SUB_BITS - 1;
+    uint64 low = (uint64(sub) | (bucket & (sub - 1))) << (bits - RUNEWORDER_HISTOGRAM_SUB_BITS);
+    return low + (uint64(1) << (bits - RUNEWORDER_HISTOGRAM_SUB_BITS)) - 1;
+}
+
+static_assert(GetRuneworderHistogramBucket(3) == 3 && GetRuneworderHistogramBucket(4) == 4 && GetRuneworderHistogramBucket(7) == 7 &&
+    GetRuneworderHistogramBucket(8) == 8 && GetRuneworderHistogramBucket(9) == 8 && GetRuneworderHistogramBucket(10) == 9, "histogram buckets");
+static_assert(GetRuneworderHistogramBound(8) == 9 && GetRuneworderHistogramBound(9) == 11 &&
+    GetRuneworderHistogramBound(GetRuneworderHistogramBucket(1000000)) >= 1000000, "histogram bounds");
+
+//Plain copy of a histogram, for reading and adding up
+struct RuneworderHistogramSnapshot
+{
+    std::array<uint64, RUNEWORDER_HISTOGRAM_BUCKETS> buckets = { };
+    uint64 count = 0;
+    uint64 sum = 0;
+    uint64 max = 0;
+
+    void Add(RuneworderHistogramSnapshot const& other);
+    uint64 GetMean() const { return count ? sum / count : 0; }
+    //bucket bound, at most 25% above the exact percentile
+    uint64 GetPercentile(double percentile) const;
+};
+
+class RuneworderHistogram
+{
+public:
+    void Record(uint64 value)
+    {
+        _buckets[GetRuneworderHistogramBucket(value)].fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+        //single writer, no compare loop needed
+        if (value > _max.load(std::memory_order_relaxed))
+            _max.store(value, std::memory_order_relaxed);
+    }
+
+    void Snapshot(RuneworderHistogramSnapshot& snapshot) const;
+    void Clear();
+
+private:
+    std::array<std::atomic<uint64>, RUNEWORDER_HISTOGRAM_BUCKETS> _buckets = { };
+    std::atomic<uint64> _sum{0};
+    std::atomic<uint64> _max{0};
+};
+
+struct RuneworderStatsSnapshot
+{
+    std::array<uint64, MAX_RUNEWORDER_COUNTERS> counters = { };
+    std::array<RuneworderHistogramSnapshot, MAX_RUNEWORDER_LATENCIES> latencies;
+
+    void Add(RuneworderStatsSnapshot const& other);
+};
+
+//Counters of one map instance
+class alignas(64) RuneworderStatsBlock
+{
+public:
+    void Count(RuneworderCounters counter, uint64 value = 1) { _counters[counter].fetch_add(value, std::memory_order_relaxed); }
+    void Record(RuneworderLatencies latency, uint64 ns) { _latencies[latency].Record(ns); }
+
+    void Snapshot(RuneworderStatsSnapshot& snapshot) const;
+    void Clear();
+
+private:
+    std::array<std::atomic<uint64>, MAX_RUNEWORDER_COUNTERS> _counters = { };
+    std::array<RuneworderHistogram, MAX_RUNEWORDER_LATENCIES> _latencies;
+};
+
+//Records the lifetime of a scope, does nothing if not enabled
+class RuneworderStatsTimer
+{
+public:
+    RuneworderStatsTimer(RuneworderStatsBlock& block, RuneworderLatencies latency, bool enabled) :
+        _block(enabled ? &block : nullptr), _latency(latency)
+    {
+        if (_block)
+            _start = std::chrono::steady_clock::now();
+    }
+    ~RuneworderStatsTimer()
+    {
+        if (_block)
+            _block->Record(_latency, uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count()));
+    }
+
+    RuneworderStatsTimer(RuneworderStatsTimer const&) = delete;
+    RuneworderStatsTimer& operator=(RuneworderStatsTimer const&) = delete;
+
+private:
+    RuneworderStatsBlock* _block;
+    RuneworderLatencies _latency;
+    std::chrono::steady_clock::time_point _start;
+};
+
+//.runeworder stats output: a counters line, then a line per latency that has samples
+void FormatRuneworderStats(RuneworderStatsSnapshot const& stats, std::vector<std::string>& lines);
+
+//Blocks by map instance, a block lives as long as some creature of the instance holds it
+class RuneworderStatsRegistry
+{
+public:
+    struct InstanceStats
+    {
+        uint32 mapId;
+        uint32 instanceId;
+        RuneworderStatsSnapshot stats;
+    };
+
+    std::shared_ptr<RuneworderStatsBlock> GetInstance(uint32 mapId, uint32 instanceId);
+
+    //live instances, and the total of live and unloaded ones
+    void Collect(std::vector<InstanceStats>& instances, RuneworderStatsSnapshot& total) const;
+    void Clear();
+
+    bool IsTiming() const { return _timing.load(std::memory_order_relaxed); }
+    void SetTiming(bool timing) { _timing.store(timing, std::memory_order_relaxed); }
+
+private:
+    void _Retire(uint64 key, RuneworderStatsBlock* block);
+
+    mutable std::mutex _lock;
+    std::map<uint64, std::weak_ptr<RuneworderStatsBlock>> _instances;
+    RuneworderStatsSnapshot _retired;
+    std::atomic<bool> _timing{false};
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_STROKES_H
+#define BOSS_RUNEWORDER_STROKES_H
+
+//Carved path to strokes
+//Vertex angles of the carved path are classified into strokes. Only needs Position, so the
+//standalone build (CMakeLists.txt) compiles it against the mock in standalone/.
+
+#include "Position.h"
+#include "boss_runeworder_patterns.h"
+#include <cmath>
+
+//-180 to 180
+inline int32 GetDegrees(Position const* pos1, Position const* posMid, Position const* pos3)
+{
+    float ang = posMid->GetAbsoluteAngle(pos1) - posMid->GetAbsoluteAngle(pos3);
+    ang = (ang > M_PI) ? ang - M_PI * 2 : (ang < -M_PI) ? ang + M_PI * 2 : ang;
+
+    return int32(ang * 180.f / M_PI);
+}
+
+//*---*---*---*---*---*---*---*---* // 9 vertices
+// --- --- --- --- --- --- --- ---  // 8 dists  vertices - 1
+//    ^   ^   ^   ^   ^   ^   ^     // 7 angles vertices - 2
+//LINE                        = 1, //171-180
+//LINE_REV                    = 2, //0-15
+//CURVE_L                     = 3, //141-170
+//CURVE_M /*sharper*/         = 4, //121-140
+//CURVE_H /*even sharper*/    = 5, //101-120
+//TURN_CUBIC                  = 6, //81-100
+//TURN_SHARP                  = 7, //16-80
+constexpr Strokes ClassifyRuneStrokes(int32 const* angles, uint32 asize)
+{
+    Strokes strokes;
+    strokes.reserve(asize);
+    int32 ang; //in degrees
+    int32 absang;
+    int32 lastTurn = -1; //last curve or turn in strokes
+    for (uint32 i = 0; i < asize; ++i)
+    {
+        bool rev = false;
+        ang = angles[i];
+        absang = ang < 0 ? -ang : ang;
+        //side relative to the last curve or turn
+        if (lastTurn >= 0)
+            rev = (angles[lastTurn] < 0) != (angles[i] < 0);
+        //line
+        if (absang >= 0 && absang <= 15)
+        {
+            //cannot be rev
+            rev = false;
+            strokes.push_back(Stroke(LINE_REV, rev));
+            continue;
+        }
+        //line rev
+        if (absang >= 171 && absang <= 180)
+        {
+            //cannot be rev
+            rev = false;
+            strokes.push_back(Stroke(LINE, rev));
+            continue;
+        }
+        //curve low
+        if (absang >= 141 && absang <= 170)
+        {
+            strokes.push_back(Stroke(CURVE_L, rev));
+            lastTurn = int32(strokes.size()) - 1;
+            continue;
+        }
+        //curve medium
+        if (absang >= 121 && absang <= 140)
+        {
+            strokes.push_back(Stroke(CURVE_M, rev));
+            lastTurn = int32(strokes.size()) - 1;
+            continue;
+        }
+        //curve high
+        if (absang >= 101 && absang <= 120)
+        {
+            strokes.push_back(Stroke(CURVE_H, rev));
+            lastTurn = int32(strokes.size()) - 1;
+            continue;
+        }
+        //cubic
+        if (absang >= 81 && absang <= 100)
+        {
+            strokes.push_back(Stroke(TURN_CUBIC, rev));
+            lastTurn = int32(strokes.size()) - 1;
+            continue;
+        }
+        //sharp
+        if (absang >= 16 && absang <= 80)
+        {
+            strokes.push_back(Stroke(TURN_SHARP, rev));
+            lastTurn = int32(strokes.size()) - 1;
+            continue;
+        }
+    }
+    return strokes;
+}
+
+#endif
@@ -0,0 +1,246 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_TABLE_H
+#define BOSS_RUNEWORDER_TABLE_H
+
+//Exhaustive rune match table
+//Every stroke sequence of the table lengths is matched against the runes, offline for packs (tools/runeworder_packgen)
+//and at startup for the built-in patterns (Runeworder.MatchTable.Length), and stored succinctly: one bit per sequence (matches anything or not), a rank directory every 512 bits
+//and a match set index per matched sequence. A lookup is a single probe, no pattern is walked.
+//Sequences are numbered in base RUNE_TABLE_SYMBOLS, first stroke is the lowest digit, shorter lengths first.
+
+#include "boss_runeworder_patterns.h"
+#include <array>
+#include <map>
+#include <utility>
+#include <vector>
+
+constexpr size_t RUNE_TABLE_SYMBOLS = 12; //LINE, LINE_REV, curves and turns on either side
+constexpr size_t MAX_RUNE_TABLE_LENGTH = 7; //12^7 sequences, ~30 MB table
+constexpr size_t DEFAULT_RUNE_TABLE_LENGTH = 6; //packs, built offline
+constexpr size_t DEFAULT_BUILTIN_TABLE_LENGTH = 5; //built-in patterns, built at startup in ~0.2 s (6 takes seconds)
+constexpr size_t RUNE_TABLE_RANK_WORDS = 8; //64-bit words per rank directory entry
+constexpr uint64 RUNE_TABLE_TASK_SEQUENCES = 4096; //sequences per build task
+
+//-1 if the stroke can not come from a carved rune
+constexpr int32 GetRuneTableSymbol(Stroke const& stroke)
+{
+    if (stroke.type == LINE || stroke.type == LINE_REV)
+        return stroke.type - LINE;
+    if (stroke.type >= CURVE_L && stroke.type <= TURN_SHARP)
+        return 2 + (stroke.type - CURVE_L) * 2 + (stroke.reverse ? 1 : 0);
+    return -1;
+}
+
+constexpr Stroke GetRuneTableStroke(uint32 symbol)
+{
+    return symbol < 2 ? Stroke(uint8(LINE + symbol), false) : Stroke(uint8(CURVE_L + (symbol - 2) / 2), (symbol - 2) % 2 != 0);
+}
+
+//sequences of given length
+constexpr uint64 GetRuneTableSequences(size_t length)
+{
+    uint64 count = 1;
+    for (size_t i = 0; i < length; ++i)
+        count *= RUNE_TABLE_SYMBOLS;
+    return count;
+}
+
+//number of the first sequence of given length
+constexpr uint64 GetRuneTableBase(size_t minLength, size_t length)
+{
+    uint64 base = 0;
+    for (size_t i = minLength; i < length; ++i)
+        base += GetRuneTableSequences(i);
+    return base;
+}
+
+//64-bit words of a table of given lengths, one bit per sequence
+constexpr uint64 GetRuneTableWords(size_t minLength, size_t maxLength)
+{
+    return (GetRuneTableBase(minLength, maxLength + 1) + 63) / 64;
+}
+
+//strokes of a table sequence, room for the longest one
+typedef std::array<Stroke, MAX_RUNE_TABLE_LENGTH> RuneTableSequence;
+
+//sequence by its number within its length, strokes past length are lines
+constexpr RuneTableSequence GetRuneTableSequence(uint64 number, size_t length)
+{
+    if (length > MAX_RUNE_TABLE_LENGTH)
+        throw -1;
+
+    std::array<uint32, MAX_RUNE_TABLE_LENGTH> symbols = { };
+    for (size_t i = 0; i < length; ++i, number /= RUNE_TABLE_SYMBOLS)
+        symbols[i] = uint32(number % RUNE_TABLE_SYMBOLS);
+    return [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        return RuneTableSequence{ GetRuneTableStroke(symbols[I])... };
+    }(std::make_index_sequence<MAX_RUNE_TABLE_LENGTH>());
+}
+
+//Read-only view of a table, data is owned by the pack
+struct RuneMatchTable
+{
+    //false if the sequence is not covered (length, symbols), matches are exact otherwise
+    constexpr bool Find(Stroke const* compSeq, size_t size, RunePatternBits& matches) const
+    {
+        if (!words || size < minLength || size > maxLength)
+            return false;
+
+        uint64 number = 0;
+        for (size_t i = size; i-- > 0;)
+        {
+            int32 symbol = GetRuneTableSymbol(compSeq[i]);
+            if (symbol < 0)
+                return false;
+            number = number * RUNE_TABLE_SYMBOLS + uint32(symbol);
+        }
+        number += GetRuneTableBase(minLength, size);
+
+        matches = RunePatternBits();
+        uint64 word = number / 64;
+        uint64 bit = uint64(1) << (number % 64);
+        if (!(words[word] & bit))
+            return true;
+
+        uint64 rank = ranks[word / RUNE_TABLE_RANK_WORDS];
+        for (uint64 i = word - word % RUNE_TABLE_RANK_WORDS; i < word; ++i)
+            rank += uint64(std::popcount(words[i]));
+        rank += uint64(std::popcount(words[word] & (bit - 1)));
+        matches = sets[matchSets[rank]];
+        return true;
+    }
+
+    bool empty() const { return !words; }
+
+    uint8 minLength = 0;
+    uint8 maxLength = 0;
+    uint64 const* words = nullptr;          //sequence matched anything
+    uint32 const* ranks = nullptr;          //matched sequences before each RUNE_TABLE_RANK_WORDS words
+    uint16 const* matchSets = nullptr;      //set index per matched sequence
+    RunePatternBits const* sets = nullptr;  //distinct match sets
+};
+
+//Table owning its data, RuneMatchTable views it
+struct RuneMatchTableData
+{
+    RuneMatchTable GetView() const
+    {
+        return { minLength, maxLength, words.data(), ranks.data(), matchSets.data(), sets.data() };
+    }
+
+    uint8 minLength = 0;
+    uint8 maxLength = 0;
+    std::vector<uint64> words;
+    std::vector<uint32> ranks;
+    std::vector<uint16> matchSets;
+    std::vector<RunePatternBits> sets;
+};
+
+//Every sequence of MIN_RUNE_PATTERN_LENGTH..maxLength strokes checked against every pattern with RunePattern::MatchesEncoded,
+//no candidate filtering. runTasks(count, run) calls run(task) for every task, on any threads. Tasks keep task-local
+//set ids, merged in sequence order so the table does not depend on threads.
+//false if there are more distinct match sets than a uint16 id holds
+template<typename RunTasks>
+bool BuildRuneMatchTable(RunePattern const* patterns, size_t count, uint8 maxLength, RunTasks&& runTasks, RuneMatchTableData& table)
+{
+    uint8 const minLength = uint8(MIN_RUNE_PATTERN_LENGTH);
+    if (maxLength < minLength || maxLength > MAX_RUNE_TABLE_LENGTH)
+        return false;
+
+    struct Task
+    {
+        uint8 length;
+        uint64 first;   //number within length
+        uint64 count;
+        std::vector<RunePatternBits> sets;
+        std::vector<uint16> ids; //per sequence, 0: no match, local set id + 1
+    };
+
+    std::vector<Task> tasks;
+    for (uint8 length = minLength; length <= maxLength; ++length)
+        for (uint64 first = 0; first < GetRuneTableSequences(length); first += RUNE_TABLE_TASK_SEQUENCES)
+            tasks.push_back({ length, first, std::min(RUNE_TABLE_TASK_SEQUENCES, GetRuneTableSequences(length) - first), { }, { } });
+
+    runTasks(uint32(tasks.size()), [&](uint32 taskIndex)
+    {
+        Task& task = tasks[taskIndex];
+        task.ids.resize(task.count);
+        for (uint64 i = 0; i < task.count; ++i)
+        {
+            RuneTableSequence const sequence = GetRuneTableSequence(task.first + i, task.length);
+            RuneEncodedSequence encoded;
+            EncodeRuneSequence(sequence.data(), task.length, encoded);
+            RunePatternBits matches;
+            bool matched = false;
+            for (size_t j = 0; j < count; ++j)
+            {
+                RuneMatchScore score;
+                if (patterns[j].minSize <= encoded.size && patterns[j].MatchesEncoded(encoded, score))
+                {
+                    matches.Set(j);
+                    matched = true;
+                }
+            }
+            if (!matched)
+                continue;
+
+            size_t id = 0;
+            while (id < task.sets.size() && task.sets[id].words != matches.words)
+                ++id;
+            if (id == task.sets.size())
+                task.sets.push_back(matches);
+            task.ids[i] = uint16(id + 1);
+        }
+    });
+
+    table = RuneMatchTableData();
+    table.words.assign(GetRuneTableWords(minLength, maxLength), 0);
+    std::map<std::array<uint64, MAX_RUNE_PATTERNS / 64>, uint16> setIds;
+    uint64 number = 0;
+    for (Task const& task : tasks)
+    {
+        std::vector<uint16> globalIds(task.sets.size());
+        for (size_t i = 0; i < task.sets.size(); ++i)
+        {
+            auto itr = setIds.find(task.sets[i].words);
+            if (itr == setIds.end())
+            {
+                if (table.sets.size() > UINT16_MAX)
+                    return false;
+                itr = setIds.emplace(task.sets[i].words, uint16(table.sets.size())).first;
+                table.sets.push_back(task.sets[i]);
+            }
+            globalIds[i] = itr->second;
+        }
+
+        for (uint64 i = 0; i < task.count; ++i, ++number)
+        {
+            if (!task.ids[i])
+                continue;
+            table.words[number / 64] |= uint64(1) << (number % 64);
+            table.matchSets.push_back(globalIds[task.ids[i] - 1]);
+        }
+    }
+
+    table.ranks.resize(table.words.size() / RUNE_TABLE_RANK_WORDS + 1);
+    uint64 rank = 0;
+    for (size_t i = 0; i < table.words.size(); ++i)
+    {
+        if (i % RUNE_TABLE_RANK_WORDS == 0)
+            table.ranks[i / RUNE_TABLE_RANK_WORDS] = uint32(rank);
+        rank += uint64(std::popcount(table.words[i]));
+    }
+    if (table.words.size() % RUNE_TABLE_RANK_WORDS == 0)
+        table.ranks.back() = uint32(rank);
+
+    table.minLength = minLength;
+    table.maxLength = maxLength;
+    return true;
+}
+
+#endif
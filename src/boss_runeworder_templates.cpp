@@ -0,0 +1,299 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#include "boss_runeworder_templates.h"
+#include <cmath>
+
+namespace
+{
+
+constexpr float TEMPLATE_PI = 3.14159265f;
+
+//middle of each stroke angle range (see GetDegrees)
+constexpr float RuneTemplateDegrees[TURN_REVERSE] =
+{
+    0.f,    //NO_STROKE
+    176.f,  //LINE          171-180
+    8.f,    //LINE_REV      0-15
+    155.f,  //CURVE_L       141-170
+    130.f,  //CURVE_M       121-140
+    110.f,  //CURVE_H       101-120
+    90.f,   //TURN_CUBIC    81-100
+    48.f    //TURN_SHARP    16-80
+};
+
+//middle one of the allowed stroke types
+uint8 GetTemplateStrokeType(StrokeTypeDefs mask)
+{
+    uint8 types[TURN_REVERSE];
+    uint8 count = 0;
+    for (uint8 type = LINE; type < TURN_REVERSE; ++type)
+        if (mask & (1 << type))
+            types[count++] = type;
+
+    return count ? types[(count - 1) / 2] : uint8(NO_STROKE);
+}
+
+float GetPathLength(RuneTemplatePoints const& points)
+{
+    float length = 0.f;
+    for (size_t i = 1; i < points.size(); ++i)
+        length += std::hypot(points[i].x - points[i - 1].x, points[i].y - points[i - 1].y);
+    return length;
+}
+
+}
+
+RuneTemplatePoints BuildRuneTemplatePoints(RunePattern const& pattern, bool mirrored)
+{
+    RuneTemplatePoints points;
+    points.reserve(pattern.size + 2);
+    points.push_back({ 0.f, 0.f });
+    points.push_back({ 1.f, 0.f });
+
+    //turn side flips with the reverse flag, relative to the previous curve or turn
+    float heading = 0.f;
+    float side = mirrored ? -1.f : 1.f;
+    for (uint8 k = 0; k < pattern.size; ++k)
+    {
+        StrokeTypeDefs mask = pattern.strokeSequence[k];
+        if (mask & STDEF_CAN_BE_EMPTY)
+            continue;
+
+        uint8 type = GetTemplateStrokeType(mask);
+        if (type == NO_STROKE)
+            continue;
+
+        if (type != LINE && type != LINE_REV && k > 0 && (mask & STDEF_REV))
+            side = -side;
+
+        heading += side * (180.f - RuneTemplateDegrees[type]) * TEMPLATE_PI / 180.f;
+        RuneTemplatePoint const& last = points.back();
+        points.push_back({ last.x + std::cos(heading), last.y + std::sin(heading) });
+    }
+
+    return points;
+}
+
+bool NormalizeRuneTemplatePath(RuneTemplatePoints const& points, RuneTemplatePath& path)
+{
+    float length = GetPathLength(points);
+    if (points.size() < 2 || length <= 0.f)
+        return false;
+
+    //resample to equidistant points
+    float interval = length / (RUNE_TEMPLATE_POINTS - 1);
+    float walked = 0.f;
+    size_t count = 0;
+    path[count++] = points[0];
+    RuneTemplatePoint prev = points[0];
+    for (size_t i = 1; i < points.size() && count < RUNE_TEMPLATE_POINTS; ++i)
+    {
+        RuneTemplatePoint cur = points[i];
+        float dist = std::hypot(cur.x - prev.x, cur.y - prev.y);
+        while (walked + dist >= interval && dist > 0.f && count < RUNE_TEMPLATE_POINTS)
+        {
+            float t = (interval - walked) / dist;
+            prev = { prev.x + t * (cur.x - prev.x), prev.y + t * (cur.y - prev.y) };
+            path[count++] = prev;
+            dist = std::hypot(cur.x - prev.x, cur.y - prev.y);
+            walked = 0.f;
+        }
+        walked += dist;
+        prev = cur;
+    }
+    while (count < RUNE_TEMPLATE_POINTS) //rounding
+        path[count++] = points.back();
+
+    //center
+    RuneTemplatePoint centroid = { 0.f, 0.f };
+    for (RuneTemplatePoint const& point : path)
+    {
+        centroid.x += point.x / RUNE_TEMPLATE_POINTS;
+        centroid.y += point.y / RUNE_TEMPLATE_POINTS;
+    }
+
+    //rotate indicative angle (centroid to first point) to zero
+    float angle = std::atan2(path[0].y - centroid.y, path[0].x - centroid.x);
+    float cosa = std::cos(-angle), sina = std::sin(-angle);
+    float minX = 0.f, maxX = 0.f, minY = 0.f, maxY = 0.f;
+    for (RuneTemplatePoint& point : path)
+    {
+        float x = point.x - centroid.x, y = point.y - centroid.y;
+        point = { x * cosa - y * sina, x * sina + y * cosa };
+        minX = std::min(minX, point.x); maxX = std::max(maxX, point.x);
+        minY = std::min(minY, point.y); maxY = std::max(maxY, point.y);
+    }
+
+    //uniform scale, keeps line-like runes intact
+    float scale = std::max(maxX - minX, maxY - minY);
+    if (scale <= 0.f)
+        return false;
+
+    for (RuneTemplatePoint& point : path)
+        point = { point.x / scale, point.y / scale };
+
+    return true;
+}
+
+float GetRuneTemplateDistance(RuneTemplatePath const& a, RuneTemplatePath const& b)
+{
+    float distance = 0.f;
+    for (size_t i = 0; i < RUNE_TEMPLATE_POINTS; ++i)
+        distance += std::hypot(a[i].x - b[i].x, a[i].y - b[i].y);
+    return distance / RUNE_TEMPLATE_POINTS;
+}
+
+void RuneTemplateTree::Build(RunePattern const* patterns, size_t count)
+{
+    _templates.clear();
+    _nodes.clear();
+    _root = -1;
+
+    _templates.reserve(count * 4);
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (bool mirrored : { false, true })
+        {
+            RuneTemplatePoints points = BuildRuneTemplatePoints(patterns[i], mirrored);
+            for (bool reversed : { false, true })
+            {
+                if (reversed)
+                    std::reverse(points.begin(), points.end());
+
+                RuneTemplate tmpl;
+                tmpl.type = patterns[i].type;
+                tmpl.size = patterns[i].size;
+                tmpl.reversed = reversed;
+                if (NormalizeRuneTemplatePath(points, tmpl.path))
+                    _templates.push_back(tmpl);
+            }
+        }
+    }
+
+    std::vector<uint32> indices(_templates.size());
+    for (uint32 i = 0; i < indices.size(); ++i)
+        indices[i] = i;
+
+    _nodes.reserve(_templates.size());
+    _root = _Build(indices, 0, indices.size());
+}
+
+int32 RuneTemplateTree::_Build(std::vector<uint32>& indices, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return -1;
+
+    int32 nodeIndex = int32(_nodes.size());
+    _nodes.push_back({ indices[begin], 0.f, -1, -1 });
+
+    if (end - begin > 1)
+    {
+        //split the rest at median distance from the vantage point
+        RuneTemplatePath const& vantage = _templates[indices[begin]].path;
+        size_t mid = begin + 1 + (end - begin - 1) / 2;
+        std::nth_element(indices.begin() + begin + 1, indices.begin() + mid, indices.begin() + end, [&](uint32 a, uint32 b)
+        {
+            return GetRuneTemplateDistance(vantage, _templates[a].path) < GetRuneTemplateDistance(vantage, _templates[b].path);
+        });
+
+        float radius = GetRuneTemplateDistance(vantage, _templates[indices[mid]].path);
+        int32 inside = _Build(indices, begin + 1, mid);
+        int32 outside = _Build(indices, mid, end);
+        _nodes[nodeIndex].radius = radius;
+        _nodes[nodeIndex].inside = inside;
+        _nodes[nodeIndex].outside = outside;
+    }
+
+    return nodeIndex;
+}
+
+void RuneTemplateTree::FindMatches(RuneTemplatePoints const& points, uint32 errorBudget, RuneMatchHeap<MAX_RUNE_MATCHES>& matches) const
+{
+    RuneTemplatePath path;
+    if (_root < 0 || !NormalizeRuneTemplatePath(points, path))
+        return;
+
+    Neighbours nearest = { };
+    size_t count = 0;
+    float maxDistance = (errorBudget + 1) * RUNE_TEMPLATE_ERROR_DISTANCE;
+    _Search(_root, path, nearest, count, maxDistance);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        RuneTemplate const& tmpl = _templates[nearest[i].templateIndex];
+        RuneMatch match;
+        match.type = tmpl.type;
+        match.score.errors = uint8(nearest[i].distance / RUNE_TEMPLATE_ERROR_DISTANCE);
+        match.score.offset = uint8(points.size() - 1);
+        match.score.coverage = tmpl.size;
+        match.score.reversed = tmpl.reversed;
+        if (match.score.errors <= errorBudget)
+            matches.Push(match);
+    }
+}
+
+void RuneTemplateTree::_Search(int32 node, RuneTemplatePath const& path, Neighbours& nearest, size_t& count, float& maxDistance) const
+{
+    if (node < 0)
+        return;
+
+    Node const& vp = _nodes[node];
+    float distance = GetRuneTemplateDistance(path, _templates[vp.templateIndex].path);
+    _AddNeighbour(vp.templateIndex, distance, nearest, count, maxDistance);
+
+    //triangle inequality, visit the more promising side first
+    if (distance < vp.radius)
+    {
+        if (distance - maxDistance <= vp.radius)
+            _Search(vp.inside, path, nearest, count, maxDistance);
+        if (distance + maxDistance >= vp.radius)
+            _Search(vp.outside, path, nearest, count, maxDistance);
+    }
+    else
+    {
+        if (distance + maxDistance >= vp.radius)
+            _Search(vp.outside, path, nearest, count, maxDistance);
+        if (distance - maxDistance <= vp.radius)
+            _Search(vp.inside, path, nearest, count, maxDistance);
+    }
+}
+
+//nearest template per rune type, search radius shrinks once the list is full
+void RuneTemplateTree::_AddNeighbour(uint32 templateIndex, float distance, Neighbours& nearest, size_t& count, float& maxDistance) const
+{
+    if (distance > maxDistance)
+        return;
+
+    uint8 type = _templates[templateIndex].type;
+    size_t slot = count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (_templates[nearest[i].templateIndex].type == type)
+        {
+            if (nearest[i].distance <= distance)
+                return;
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot == count)
+    {
+        if (count < nearest.size())
+            ++count;
+        else
+            slot = count - 1; //replace the farthest
+    }
+
+    nearest[slot] = { templateIndex, distance };
+    std::sort(nearest.begin(), nearest.begin() + count, [](RuneTemplateNeighbour const& a, RuneTemplateNeighbour const& b)
+    {
+        return a.distance < b.distance;
+    });
+
+    if (count == nearest.size())
+        maxDistance = std::min(maxDistance, nearest[count - 1].distance);
+}
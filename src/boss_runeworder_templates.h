@@ -0,0 +1,88 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_TEMPLATES_H
+#define BOSS_RUNEWORDER_TEMPLATES_H
+
+//Template rune recognizer
+//Alternative to the stroke matcher working on raw carve point coordinates ($1 unistroke style):
+//the path is resampled, centered, scaled and rotated to its indicative angle, then compared point by point
+//with canonical templates synthesized from the rune patterns. Templates are kept in a vantage-point tree.
+//Experimental: 32-point paths are too alike for the tree to prune well (a lookup still compares more than half
+//of the templates) and recognition is less accurate than the stroke matcher, which stays the default.
+
+#include "boss_runeworder_patterns.h"
+
+constexpr size_t RUNE_TEMPLATE_POINTS = 32;
+constexpr float RUNE_TEMPLATE_ERROR_DISTANCE = 0.10f; //template distance counted as one stroke error
+
+enum RuneworderEngines
+{
+    RUNE_ENGINE_STROKES         = 0, //stroke grammar matcher (RunePattern::Matches)
+    RUNE_ENGINE_TEMPLATES       = 1  //nearest template
+};
+
+struct RuneTemplatePoint
+{
+    float x;
+    float y;
+};
+
+typedef std::vector<RuneTemplatePoint> RuneTemplatePoints;
+typedef std::array<RuneTemplatePoint, RUNE_TEMPLATE_POINTS> RuneTemplatePath;
+
+//canonical carve path of a pattern: unit steps turned by the middle angle of each stroke, optional slots dropped
+RuneTemplatePoints BuildRuneTemplatePoints(RunePattern const& pattern, bool mirrored);
+//resampled and normalized path, false if points are degenerate
+bool NormalizeRuneTemplatePath(RuneTemplatePoints const& points, RuneTemplatePath& path);
+//average point distance, a metric (required by the tree)
+float GetRuneTemplateDistance(RuneTemplatePath const& a, RuneTemplatePath const& b);
+
+struct RuneTemplate
+{
+    RuneTemplatePath path;
+    uint8 type;
+    uint8 size;
+    bool reversed;
+};
+
+struct RuneTemplateNeighbour
+{
+    uint32 templateIndex;
+    float distance;
+};
+
+class RuneTemplateTree
+{
+public:
+    //4 templates per pattern: drawn forward or backwards, mirrored or not
+    void Build(RunePattern const* patterns, size_t count);
+
+    //up to MAX_RUNE_MATCHES nearest rune types within the error budget
+    void FindMatches(RuneTemplatePoints const& points, uint32 errorBudget, RuneMatchHeap<MAX_RUNE_MATCHES>& matches) const;
+
+    size_t size() const { return _templates.size(); }
+
+private:
+    struct Node
+    {
+        uint32 templateIndex;
+        float radius;   //median distance to the vantage point
+        int32 inside;   //closer than radius
+        int32 outside;
+    };
+
+    typedef std::array<RuneTemplateNeighbour, MAX_RUNE_MATCHES> Neighbours;
+
+    int32 _Build(std::vector<uint32>& indices, size_t begin, size_t end);
+    void _Search(int32 node, RuneTemplatePath const& path, Neighbours& nearest, size_t& count, float& maxDistance) const;
+    void _AddNeighbour(uint32 templateIndex, float distance, Neighbours& nearest, size_t& count, float& maxDistance) const;
+
+    std::vector<RuneTemplate> _templates;
+    std::vector<Node> _nodes;
+    int32 _root = -1;
+};
+
+#endif
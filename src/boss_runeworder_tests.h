@@ -0,0 +1,426 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef BOSS_RUNEWORDER_TESTS_H
+#define BOSS_RUNEWORDER_TESTS_H
+
+//Compile-time tests of the recognition code: stroke notation and classifier, matchers against the reference
+//and each other, canonical coverage and shadowing of every rune, runewords, match table.
+//Nothing runs, a failing check fails the build. Included by the module and by tools/runeworder_tests.cpp,
+//so the standalone build checks the same code it benchmarks.
+
+#include "boss_runeworder_coverage.h"
+#include "boss_runeworder_matchers.h"
+#include "boss_runeworder_patterns.h"
+#include "boss_runeworder_strokes.h"
+#include "boss_runeworder_table.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <utility>
+#include <vector>
+
+//random sequences per pattern and length in the RUNE_MATCHER_DIFF_TESTS smoke test, more cost compile time
+#ifndef RUNEWORDER_MATCHER_TEST_SAMPLES
+# define RUNEWORDER_MATCHER_TEST_SAMPLES 4
+#endif
+
+//glyph longer than built-in runes
+constexpr auto RuneStrokesTestLong = RuneStrokes<"MH LM CH/r S/r I LM LM MH LM CH/r S/r I LM LM">();
+constexpr RunePattern Rune_TEST_LONG = RunePattern(RUNE_EL1, RuneStrokesTestLong);
+
+//EL1 strokes twice after 30 lines
+constexpr std::array<Stroke, 44> GetTestLongSequence()
+{
+    constexpr std::array glyph { Stroke(CURVE_H, false), Stroke(CURVE_L, false), Stroke(TURN_CUBIC, true), Stroke(TURN_SHARP, true), Stroke(LINE, false), Stroke(CURVE_M, false), Stroke(CURVE_M, false) };
+    return [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        return std::array{ (I < 30 ? Stroke(LINE, false) : glyph[(I - 30) % glyph.size()])... };
+    }(std::make_index_sequence<44>());
+}
+
+template<size_t N>
+constexpr RuneMatchScore GetTestMatchScore(std::array<Stroke, N> const& compSeq, RunePattern const& pattern)
+{
+    RuneMatchScore score;
+    pattern.Matches(compSeq.data(), N, score);
+    return score;
+}
+
+template<size_t N>
+constexpr RuneEncodedSequence GetTestEncodedSequence(std::array<Stroke, N> const& compSeq)
+{
+    RuneEncodedSequence seq;
+    EncodeRuneSequence(compSeq.data(), N, seq);
+    return seq;
+}
+
+//5 stroke match table with two matched sequences: all lines (EL1) and the ITH2 glyph (ITH2)
+constexpr std::array TestTableGlyph { Stroke(CURVE_M, false), Stroke(TURN_SHARP, false), Stroke(CURVE_M, true), Stroke(TURN_SHARP, true), Stroke(CURVE_M, false) };
+constexpr uint64 GetTestTableNumber()
+{
+    uint64 number = 0;
+    for (size_t i = TestTableGlyph.size(); i-- > 0;)
+        number = number * RUNE_TABLE_SYMBOLS + uint32(GetRuneTableSymbol(TestTableGlyph[i]));
+    return number;
+}
+constexpr auto TestTableWords = []
+{
+    std::array<uint64, (GetRuneTableSequences(5) + 63) / 64> words = {};
+    words[0] |= 1;
+    words[GetTestTableNumber() / 64] |= uint64(1) << (GetTestTableNumber() % 64);
+    return words;
+}();
+constexpr auto TestTableRanks = []
+{
+    std::array<uint32, TestTableWords.size() / RUNE_TABLE_RANK_WORDS + 1> ranks = {};
+    for (size_t i = 0; i < ranks.size(); ++i)
+        ranks[i] = (i > 0) + (GetTestTableNumber() / 64 < i * RUNE_TABLE_RANK_WORDS);
+    return ranks;
+}();
+constexpr std::array<uint16, 2> TestTableMatchSets = { 0, 1 };
+constexpr auto TestTableSets = []
+{
+    std::array<RunePatternBits, 2> sets;
+    sets[0].Set(RUNE_EL1);
+    sets[1].Set(RUNE_ITH2);
+    return sets;
+}();
+constexpr RuneMatchTable TestTable = { 5, 5, TestTableWords.data(), TestTableRanks.data(), TestTableMatchSets.data(), TestTableSets.data() };
+
+constexpr RunePatternBits GetTestTableMatches(Stroke const* compSeq, size_t size)
+{
+    RunePatternBits matches;
+    matches.Set(MAX_RUNE_PATTERNS - 1); //stays if not covered
+    TestTable.Find(compSeq, size, matches);
+    return matches;
+}
+
+constexpr void RUNE_PATTERN_TESTS()
+{
+#define TEST_RUNE_PATTERN(p, ...) \
+    constexpr std::array arr_##p { __VA_ARGS__ }; \
+    constexpr bool val_##p = RunePattern::Matches(arr_##p, p); \
+    static_assert(val_##p); \
+    static_assert(RuneCandidates.Candidates(Strokes(arr_##p.begin(), arr_##p.end())).Test(p.type))
+
+    //MH I? CS MH/r CS/r I? MH
+    TEST_RUNE_PATTERN(Rune_ITH2, Stroke(CURVE_M, false), Stroke(TURN_SHARP, false), Stroke(CURVE_M, true), Stroke(TURN_SHARP, true), Stroke(CURVE_M, false));
+    //MH LM CH/r S/r I LM LM
+    TEST_RUNE_PATTERN(Rune_EL1, Stroke(CURVE_H, false), Stroke(CURVE_L, false), Stroke(TURN_CUBIC, true), Stroke(TURN_SHARP, true), Stroke(LINE, false), Stroke(CURVE_M, false), Stroke(TURN_SHARP, true));
+#undef TEST_RUNE_PATTERN
+
+    //scores: EL1 misses the last stroke, ITH2 skips both optional lines
+    constexpr RuneMatchScore score_EL1 = GetTestMatchScore(arr_Rune_EL1, Rune_EL1);
+    static_assert(score_EL1.errors == 1 && score_EL1.coverage == 7 && score_EL1.offset == 6 && !score_EL1.reversed);
+    constexpr RuneMatchScore score_ITH2 = GetTestMatchScore(arr_Rune_ITH2, Rune_ITH2);
+    static_assert(score_ITH2.errors == 0 && score_ITH2.coverage == 7 && score_ITH2.offset == 4);
+
+    //packed strokes, one nibble each (type, reverse bit), and bitplanes
+    constexpr RuneEncodedSequence encoded_EL1 = GetTestEncodedSequence(arr_Rune_EL1);
+    static_assert(encoded_EL1.strokes[0] == 0xF41FE35 && encoded_EL1.size == 7);
+    static_assert(encoded_EL1.GetMask(2) == (STDEF_TURN_CUBIC | STDEF_REV) && encoded_EL1.GetMask(4) == STDEF_LINE);
+    static_assert(encoded_EL1.positions[TURN_SHARP] == 0b1001000 && encoded_EL1.reversed == 0b1001100);
+
+    //top-k keeps the cleanest matches, clean low rune outweighs sloppy high one
+    constexpr auto heap = []
+    {
+        RuneMatchHeap<2> matches;
+        matches.Push(RuneMatch{ RUNE_ZOD1, RuneMatchScore{ 1, 0, 9, false } });
+        matches.Push(RuneMatch{ RUNE_EL1, RuneMatchScore{ 0, 0, 7, false } });
+        matches.Push(RuneMatch{ RUNE_ZOD2, RuneMatchScore{ 1, 0, 6, false } });
+        matches.Push(RuneMatch{ RUNE_TIR1, RuneMatchScore{ 0, 0, 5, false } });
+        matches.Sort();
+        return matches;
+    }();
+    static_assert(heap.size() == 2 && heap.begin()[0].type == RUNE_EL1 && heap.begin()[1].type == RUNE_TIR1);
+    static_assert(GetRuneMatchWeight(RuneMatch{ RUNE_EL1, RuneMatchScore{ 0, 0, 7, false } }, UNMATCH_THRESHOLD) >
+        GetRuneMatchWeight(RuneMatch{ RUNE_ZOD1, RuneMatchScore{ 1, 0, 9, false } }, UNMATCH_THRESHOLD));
+
+    //14 stroke glyph after 30 lines, 44 strokes in total
+    constexpr std::array arr_TEST_LONG = GetTestLongSequence();
+    constexpr RuneMatchScore score_TEST_LONG = GetTestMatchScore(arr_TEST_LONG, Rune_TEST_LONG);
+    static_assert(RunePattern::Matches(arr_TEST_LONG, Rune_TEST_LONG) && score_TEST_LONG.errors == 0 && score_TEST_LONG.offset == 43);
+    static_assert(Rune_TEST_LONG.GetMatchErrors(arr_TEST_LONG.data(), arr_TEST_LONG.size(), MAX_RUNE_MATCH_ERRORS) == 0);
+    static_assert(RunePattern::Matches(arr_TEST_LONG, Rune_EL1));
+
+    //approximate matcher: optional slots are free, last EL1 stroke is substituted
+    static_assert(Rune_ITH2.GetMatchErrors(arr_Rune_ITH2.data(), arr_Rune_ITH2.size(), MAX_RUNE_MATCH_ERRORS) == 0);
+    static_assert(Rune_EL1.GetMatchErrors(arr_Rune_EL1.data(), arr_Rune_EL1.size(), MAX_RUNE_MATCH_ERRORS) == 1);
+    static_assert(Rune_EL1.GetMatchErrors(arr_Rune_EL1.data(), arr_Rune_EL1.size(), 0) == 1);
+    //H L S/r S/r I M S/r: two substitutions
+    constexpr std::array arr_EL1_2 { Stroke(CURVE_H, false), Stroke(CURVE_L, false), Stroke(TURN_SHARP, true), Stroke(TURN_SHARP, true), Stroke(LINE, false), Stroke(CURVE_M, false), Stroke(TURN_SHARP, true) };
+    static_assert(Rune_EL1.GetMatchErrors(arr_EL1_2.data(), arr_EL1_2.size(), MAX_RUNE_MATCH_ERRORS) == 2);
+    static_assert(!RunePattern::Matches(arr_EL1_2, Rune_EL1));
+    static_assert(RuneCandidates.Candidates(Strokes(arr_EL1_2.begin(), arr_EL1_2.end()), 1).Test(Rune_EL1.type));
+    //H L C/r S/r V M M: lines are never substituted
+    constexpr std::array arr_EL1_V { Stroke(CURVE_H, false), Stroke(CURVE_L, false), Stroke(TURN_CUBIC, true), Stroke(TURN_SHARP, true), Stroke(LINE_REV, false), Stroke(CURVE_M, false), Stroke(CURVE_M, false) };
+    static_assert(Rune_EL1.GetMatchErrors(arr_EL1_V.data(), arr_EL1_V.size(), MAX_RUNE_MATCH_ERRORS) == MAX_RUNE_MATCH_ERRORS + 1);
+
+    //match table: symbols round-trip, lookups are exact for covered lengths only
+    static_assert([]
+    {
+        for (uint32 symbol = 0; symbol < RUNE_TABLE_SYMBOLS; ++symbol)
+            if (GetRuneTableSymbol(GetRuneTableStroke(symbol)) != int32(symbol))
+                return false;
+        return true;
+    }());
+    static_assert(GetRuneTableBase(MIN_RUNE_PATTERN_LENGTH, 7) == 248832 + 2985984);
+    constexpr std::array arr_TABLE_LINES { Stroke(LINE, false), Stroke(LINE, false), Stroke(LINE, false), Stroke(LINE, false), Stroke(LINE, false) };
+    static_assert(GetTestTableMatches(TestTableGlyph.data(), TestTableGlyph.size()).words == TestTableSets[1].words);
+    static_assert(GetTestTableMatches(arr_TABLE_LINES.data(), arr_TABLE_LINES.size()).words == TestTableSets[0].words);
+    static_assert(GetTestTableMatches(arr_Rune_EL1.data(), 5).words == RunePatternBits().words);
+    static_assert(GetTestTableMatches(arr_Rune_EL1.data(), 6).Test(MAX_RUNE_PATTERNS - 1));
+}
+
+constexpr void RUNE_STROKE_NOTATION_TESTS()
+{
+#define TEST_RUNE_STROKE_NOTATION(text, err) \
+    static_assert(ParseRuneStrokes(text, nullptr, 0).error == err)
+
+    TEST_RUNE_STROKE_NOTATION("MH LM CH/r S/r I LM LM", RSPE_NONE);
+    TEST_RUNE_STROKE_NOTATION("S I? S/r  I?\t* */r", RSPE_NONE);
+    TEST_RUNE_STROKE_NOTATION("   ", RSPE_EMPTY_PATTERN);
+    TEST_RUNE_STROKE_NOTATION("MH LX", RSPE_UNKNOWN_LETTER);
+    TEST_RUNE_STROKE_NOTATION("MH /r", RSPE_UNKNOWN_LETTER);
+    TEST_RUNE_STROKE_NOTATION("MH MM", RSPE_DUPLICATE_LETTER);
+    TEST_RUNE_STROKE_NOTATION("MH LM?/r", RSPE_BAD_SUFFIX);
+    TEST_RUNE_STROKE_NOTATION("MH IS", RSPE_UNKNOWN_COMBINATION);
+    TEST_RUNE_STROKE_NOTATION("MH I/r", RSPE_UNKNOWN_COMBINATION);
+    static_assert(RuneStrokes<"MH LM CH/r S/r I LM LM">() == RuneStrokesEL1);
+    static_assert(RuneStrokes<"MH I? CS MH/r CS/r I? MH">()[1] == ST_LINE_OR_NOTHING);
+
+#undef TEST_RUNE_STROKE_NOTATION
+}
+
+//vertex angles to strokes, the side flips against the last curve or turn only
+consteval bool TestRuneStrokeClassifier()
+{
+    constexpr std::array<int32, 7> angles = { 175, 150, -130, 10, -90, -20, 110 };
+    constexpr std::array expected { Stroke(LINE, false), Stroke(CURVE_L, false), Stroke(CURVE_M, true), Stroke(LINE_REV, false),
+        Stroke(TURN_CUBIC, false), Stroke(TURN_SHARP, false), Stroke(CURVE_H, true) };
+    Strokes strokes = ClassifyRuneStrokes(angles.data(), uint32(angles.size()));
+    if (strokes.size() != expected.size())
+        return false;
+    for (size_t i = 0; i < expected.size(); ++i)
+        if (strokes[i].type != expected[i].type || strokes[i].reverse != expected[i].reverse)
+            return false;
+    return true;
+}
+
+constexpr void RUNE_STROKE_CLASSIFIER_TESTS()
+{
+    static_assert(TestRuneStrokeClassifier());
+    static_assert(ClassifyRuneStrokes(nullptr, 0).empty());
+}
+
+//Smoke test of Matches vs MatchesReference and the specialized matchers on random sequences, half of them built from
+//the pattern itself. The exhaustive checks are in runeworder_fuzz (--exhaustive, --classes), run after each build
+constexpr uint32 MATCHER_TEST_SYMBOLS = 12; //LINE, LINE_REV, 5 turns * reverse
+constexpr uint32 MATCHER_TEST_SAMPLES = RUNEWORDER_MATCHER_TEST_SAMPLES;
+constexpr size_t MATCHER_TEST_MAX_LENGTH = 12; //reference was only used up to 12 strokes
+
+constexpr Stroke GetMatcherTestStroke(uint32 symbol)
+{
+    return symbol < 2 ? Stroke(uint8(LINE + symbol), false) : Stroke(uint8(CURVE_L + (symbol - 2) / 2), (symbol - 2) % 2);
+}
+
+constexpr uint32 NextMatcherTestRandom(uint32& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 16;
+}
+
+template<size_t N>
+constexpr bool TestMatcherSequence(std::array<uint32, MATCHER_TEST_MAX_LENGTH> const& symbols, RunePattern const& pattern)
+{
+    auto seq = [&]<size_t... I>(std::index_sequence<I...>) { return std::array{ GetMatcherTestStroke(symbols[I])... }; }(std::make_index_sequence<N>());
+    if (RunePattern::Matches(seq, pattern) != RunePattern::MatchesReference(seq, pattern))
+        return false;
+
+    //specialized matcher gives the same score
+    RuneEncodedSequence encoded;
+    RuneMatchScore score, specializedScore;
+    if (!EncodeRuneSequence(seq.data(), N, encoded))
+        return false;
+    bool matched = pattern.MatchesEncoded(encoded, score);
+    if (RuneMatchers[pattern.type](encoded, specializedScore) != matched)
+        return false;
+    return !matched || (score.errors == specializedScore.errors && score.offset == specializedScore.offset &&
+        score.coverage == specializedScore.coverage && score.reversed == specializedScore.reversed);
+}
+
+template<size_t N>
+constexpr bool TestMatcherSamples(RunePattern const& pattern)
+{
+    uint32 seed = pattern.type * 131 + N;
+    for (uint32 sample = 0; sample < MATCHER_TEST_SAMPLES; ++sample)
+    {
+        std::array<uint32, MATCHER_TEST_MAX_LENGTH> symbols = { };
+        size_t count = 0;
+        if (sample % 2)
+        {
+            //stroke accepted by each slot, optional slots are dropped at random
+            for (uint32 k = 0; k < pattern.size && count < N; ++k)
+            {
+                if ((pattern.strokeSequence[k] & STDEF_CAN_BE_EMPTY) && NextMatcherTestRandom(seed) % 2)
+                    continue;
+
+                uint32 symbol = NextMatcherTestRandom(seed) % MATCHER_TEST_SYMBOLS;
+                for (uint32 s = 0; s < MATCHER_TEST_SYMBOLS; ++s, symbol = (symbol + 1) % MATCHER_TEST_SYMBOLS)
+                {
+                    Stroke stroke = GetMatcherTestStroke(symbol);
+                    if ((pattern.strokeSequence[k] & (1 << stroke.type)) && (k == 0 || stroke.reverse == bool(pattern.strokeSequence[k] & STDEF_REV)))
+                        break;
+                }
+                symbols[count++] = symbol;
+            }
+            //pad at either end, then break up to 2 strokes
+            while (count < N)
+            {
+                if (NextMatcherTestRandom(seed) % 2)
+                    std::rotate(symbols.begin(), symbols.begin() + count, symbols.begin() + count + 1);
+                symbols[NextMatcherTestRandom(seed) % 2 ? 0 : count] = NextMatcherTestRandom(seed) % MATCHER_TEST_SYMBOLS;
+                ++count;
+            }
+            for (uint32 m = NextMatcherTestRandom(seed) % 3; m > 0; --m)
+                symbols[NextMatcherTestRandom(seed) % N] = NextMatcherTestRandom(seed) % MATCHER_TEST_SYMBOLS;
+            if (NextMatcherTestRandom(seed) % 2)
+                std::reverse(symbols.begin(), symbols.begin() + N);
+        }
+        else
+        {
+            for (size_t i = 0; i < N; ++i)
+                symbols[i] = NextMatcherTestRandom(seed) % MATCHER_TEST_SYMBOLS;
+        }
+
+        if (!TestMatcherSequence<N>(symbols, pattern))
+            return false;
+    }
+
+    return true;
+}
+
+//one evaluation per pattern and length, keeps each one within compiler constexpr step limits
+template<size_t P, size_t N>
+struct RuneMatcherDiffTest
+{
+    static_assert(TestMatcherSamples<N>(RunePatterns[P]), "single-pass Matches differs from MatchesReference or specialized matcher");
+};
+
+template<size_t P, size_t... N>
+constexpr size_t TestMatcherLengths(std::index_sequence<N...>)
+{
+    return (sizeof(RuneMatcherDiffTest<P, N + MIN_RUNE_PATTERN_LENGTH - 2>) + ...);
+}
+
+template<size_t... P>
+constexpr size_t TestMatcherPatterns(std::index_sequence<P...>)
+{
+    return (TestMatcherLengths<P>(std::make_index_sequence<MATCHER_TEST_MAX_LENGTH - MIN_RUNE_PATTERN_LENGTH + 3>()) + ...);
+}
+
+constexpr void RUNE_MATCHER_DIFF_TESTS()
+{
+    static_assert(TestMatcherPatterns(std::make_index_sequence<MAX_RUNE_TYPES>()));
+}
+
+//compile error names both patterns
+template<RuneTypes Shadowing, RuneTypes Shadowed, bool Shadows>
+struct RuneShadowReport
+{
+};
+
+template<RuneTypes Shadowing, RuneTypes Shadowed>
+struct RuneShadowReport<Shadowing, Shadowed, true>
+{
+    static_assert(IsRuneShadowAllowed(Shadowing, Shadowed), "rune pattern matches every canonical of another one (template arguments), see RuneShadowAllowlist");
+};
+
+//one evaluation per pattern, keeps each one within compiler constexpr step limits
+template<size_t P>
+struct RuneCoverageTest
+{
+    static_assert(TestRuneCanonicals(RunePatterns[P], P, RuneCandidates), "pattern does not match its own canonical sequences");
+    static constexpr RunePatternBits Shadowing = GetRuneShadowing(RunePatterns.data(), MAX_RUNE_TYPES, P);
+
+    template<size_t... O>
+    static constexpr size_t Report(std::index_sequence<O...>)
+    {
+        return (sizeof(RuneShadowReport<RuneTypes(O), RuneTypes(P), Shadowing.Test(O)>) + ...);
+    }
+};
+
+template<size_t... P>
+constexpr size_t TestRuneCoverage(std::index_sequence<P...>)
+{
+    return (RuneCoverageTest<P>::Report(std::make_index_sequence<MAX_RUNE_TYPES>()) + ...);
+}
+
+//allowlist entries still shadow
+template<size_t... I>
+constexpr bool TestRuneShadowAllowlist(std::index_sequence<I...>)
+{
+    return (RuneCoverageTest<RuneShadowAllowlist[I].second>::Shadowing.Test(RuneShadowAllowlist[I].first) && ...);
+}
+
+constexpr void RUNE_PATTERN_COVERAGE_TESTS()
+{
+    static_assert(TestRuneCoverage(std::make_index_sequence<MAX_RUNE_TYPES>()));
+    static_assert(TestRuneShadowAllowlist(std::make_index_sequence<RuneShadowAllowlist.size()>()),
+        "allowlisted rune pattern no longer shadows, remove it from RuneShadowAllowlist");
+}
+
+//every runeword is made of its own runes, and not of one rune less
+consteval bool TestRunewordCoverage()
+{
+    for (size_t i = 0; i < MAX_RUNEWORD_TYPES; ++i)
+    {
+        RunewordPattern const& pattern = RunewordPatterns[i];
+        RuneStacks stacks = { };
+        for (uint32 k = 0; k + 1 < pattern.size; ++k)
+            AddRuneStacks(stacks, pattern.runeSpellList[k], 1);
+        if (pattern.Contains(stacks))
+            return false;
+
+        AddRuneStacks(stacks, pattern.runeSpellList[pattern.size - 1], 1);
+        if (!pattern.Contains(stacks) || !RunewordRunes.Candidates(stacks).Test(i))
+            return false;
+    }
+    return true;
+}
+
+constexpr void RUNEWORD_PATTERN_TESTS()
+{
+    static_assert(TestRunewordCoverage(), "runeword pattern does not match its own runes");
+
+#define TEST_RUNEWORD_PATTERN(p, ...) \
+    constexpr std::array arr_##p { __VA_ARGS__ }; \
+    constexpr bool val_##p = RunewordPattern::Contains<p.size>(arr_##p, p); \
+    static_assert(val_##p)
+
+    TEST_RUNEWORD_PATTERN(Runeword_RADIANCE, SPELL_NEF_SELF, SPELL_SOL_SELF, SPELL_ITH_SELF);
+    TEST_RUNEWORD_PATTERN(Runeword_SANCTUARY, SPELL_KO_SELF, SPELL_MAL_SELF, SPELL_KO_SELF);
+    TEST_RUNEWORD_PATTERN(Runeword_LAST_WISH, SPELL_JAH_SELF, SPELL_SUR_SELF, SPELL_JAH_SELF, SPELL_BER_SELF, SPELL_MAL_SELF, SPELL_JAH_SELF, SPELL_EL_SELF);
+    //one rune can not stand for a repeated one
+    static_assert(!RunewordPattern::Contains<3>(std::array{ SPELL_KO_SELF, SPELL_MAL_SELF, SPELL_TIR_SELF }, Runeword_SANCTUARY));
+    static_assert(!RunewordPattern::Contains<4>(std::array{ SPELL_BER_SELF, SPELL_MAL_SELF, SPELL_IST_SELF, SPELL_TIR_SELF }, Runeword_INFINITY));
+
+    constexpr RuneStacks stacks = []()
+    {
+        RuneStacks result = { };
+        AddRuneStacks(result, SPELL_KO_SELF, 2);
+        AddRuneStacks(result, SPELL_MAL_SELF, 1);
+        AddRuneStacks(result, SPELL_STEEL, 1);
+        return result;
+    }();
+    static_assert(Runeword_SANCTUARY.Contains(stacks));
+    static_assert(RunewordRunes.Candidates(stacks).Test(RUNEWORD_SANCTUARY));
+    static_assert(!RunewordRunes.Candidates(stacks).Test(RUNEWORD_PRUDENCE));
+
+#undef TEST_RUNEWORD_PATTERN
+}
+
+#endif
@@ -0,0 +1,23 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_STANDALONE_DEFINE_H
+#define RUNEWORDER_STANDALONE_DEFINE_H
+
+//Core Define.h stand-in for the standalone build, fixed width types only
+
+#include <cstddef>
+#include <cstdint>
+
+typedef std::int64_t int64;
+typedef std::int32_t int32;
+typedef std::int16_t int16;
+typedef std::int8_t int8;
+typedef std::uint64_t uint64;
+typedef std::uint32_t uint32;
+typedef std::uint16_t uint16;
+typedef std::uint8_t uint8;
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_STANDALONE_POSITION_H
+#define RUNEWORDER_STANDALONE_POSITION_H
+
+//Core Position stand-in for the standalone build, the 2d part the stroke classifier uses
+
+#include "Define.h"
+#include <cmath>
+
+struct Position
+{
+    Position(float x = 0, float y = 0, float z = 0, float o = 0)
+        : m_positionX(x), m_positionY(y), m_positionZ(z), m_orientation(NormalizeOrientation(o)) { }
+
+    float m_positionX;
+    float m_positionY;
+    float m_positionZ;
+    float m_orientation;
+
+    void Relocate(float x, float y) { m_positionX = x; m_positionY = y; }
+    void Relocate(float x, float y, float z) { Relocate(x, y); m_positionZ = z; }
+
+    float GetPositionX() const { return m_positionX; }
+    float GetPositionY() const { return m_positionY; }
+    float GetPositionZ() const { return m_positionZ; }
+    float GetOrientation() const { return m_orientation; }
+
+    float GetExactDist2d(float x, float y) const { return std::sqrt(GetExactDist2dSq(x, y)); }
+    float GetExactDist2d(Position const* pos) const { return GetExactDist2d(pos->m_positionX, pos->m_positionY); }
+    float GetExactDist2dSq(float x, float y) const
+    {
+        float dx = m_positionX - x;
+        float dy = m_positionY - y;
+        return dx * dx + dy * dy;
+    }
+
+    //0 to 2 pi, same as the core
+    float GetAbsoluteAngle(float x, float y) const
+    {
+        float dx = x - m_positionX;
+        float dy = y - m_positionY;
+        return NormalizeOrientation(std::atan2(dy, dx));
+    }
+    float GetAbsoluteAngle(Position const* pos) const { return GetAbsoluteAngle(pos->m_positionX, pos->m_positionY); }
+
+    static float NormalizeOrientation(float o)
+    {
+        //fmod only works properly with positive values
+        if (o < 0)
+        {
+            float mod = o * -1;
+            mod = std::fmod(mod, 2.0f * static_cast<float>(M_PI));
+            mod = -mod + 2.0f * static_cast<float>(M_PI);
+            return mod;
+        }
+        return std::fmod(o, 2.0f * static_cast<float>(M_PI));
+    }
+};
+
+#endif
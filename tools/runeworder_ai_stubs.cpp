@@ -0,0 +1,157 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Compile check of the AI side of boss_runeworder_encounter.h without a game core
+//Stand-ins of boss_runeworderAI and npc_rune_carverAI declare the same hooks with the same signatures, friend the
+//encounter bases and run the same event loops as the module. Both bases are instantiated with the TrinityCore
+//EventMap and Milliseconds (std::chrono) and with the AzerothCore ones (uint32 times, the module defines
+//Milliseconds as uint32). Building this file is the check: hooks are only declared and nothing is linked.
+//Keep the hooks in sync with boss_runeworder.cpp.
+
+#include "boss_runeworder_encounter.h"
+#include <chrono>
+#include <cstddef>
+
+namespace runeworder_stubs
+{
+
+struct Unit { };
+
+//TrinityCore Duration.h and EventMap.h
+namespace tc
+{
+    typedef std::chrono::milliseconds Milliseconds;
+
+    class EventMap
+    {
+    public:
+        void Reset();
+        void Update(uint32 time);
+        uint32 ExecuteEvent();
+        void ScheduleEvent(uint32 eventId, Milliseconds time, uint32 group = 0, uint8 phase = 0);
+    };
+}
+
+//AzerothCore EventMap.h
+namespace ac
+{
+    typedef uint32 Milliseconds; //#define Milliseconds uint32 in the module
+
+    class EventMap
+    {
+    public:
+        void Reset();
+        void Update(uint32 time);
+        uint32 ExecuteEvent();
+        void ScheduleEvent(uint32 eventId, uint32 time, uint32 group = 0, uint32 phase = 0);
+    };
+}
+
+//boss_runeworderAI
+template<typename EventMap, typename Milliseconds>
+struct RuneworderAI : public RuneworderEncounterAI<RuneworderAI<EventMap, Milliseconds>, EventMap, Milliseconds>
+{
+    friend class RuneworderEncounterAI<RuneworderAI, EventMap, Milliseconds>;
+
+    void JustEngagedWith(Unit* /*who*/)
+    {
+        this->_ScheduleCombatEvents();
+    }
+
+    void UpdateAI(uint32 diff)
+    {
+        this->_events.Update(diff);
+        while (uint32 eventId = this->_events.ExecuteEvent())
+        {
+            switch (this->_ExecuteEncounterEvent(eventId))
+            {
+                case RUNEWORDER_EVENT_UNKNOWN:
+                case RUNEWORDER_EVENT_NOT_IN_FRENZY:
+                    _LogError(eventId, this->_myphase);
+                    break;
+                default:
+                    break;
+            }
+        }
+        this->_UpdateEncounterTimers(diff);
+    }
+
+    //SpellHitTarget, SPELL_PERIODIC_TELEPORT_DUMMY
+    void ScheduleTeleport()
+    {
+        this->_events.ScheduleEvent(EVENT_ENIGMA_TELEPORT, Milliseconds(0));
+    }
+
+private:
+    void _LogError(uint32 eventId, uint32 phase);
+
+    //RuneworderEncounterAI calls
+    uint32 _Urand(uint32 min, uint32 max) const;
+    void _Talk(uint32 text);
+    void _CastSelf(uint32 spellId, bool triggered);
+    bool _CastOnRandomTarget(uint32 spellId);
+    bool _HasCarver() const;
+    void _GetCarverPosition(float& x, float& y) const;
+    void _DespawnCarver();
+    bool _SummonCarvePoint(float x, float y);
+    size_t _GetCarvePointsCount() const;
+    bool _HasRunewordType() const;
+    float _GetHealthPct() const;
+    void _EnigmaTeleport();
+    bool _IsVictimInMelee() const;
+    void _SetWalkSpeed(bool walk);
+    void _MeleeAttack(uint32 diff);
+    float _GetVictimDistance() const;
+    bool _SwitchToNearestTarget();
+    void _IncinerateVictim();
+    void _UnsummonPoints();
+    float _GetPointStep() const;
+    void _ComputateRuneType();
+    void _ComputateRunewordType();
+};
+
+//npc_rune_carverAI
+template<typename EventMap, typename Milliseconds>
+struct RuneCarverAI : public RuneCarverEncounterAI<RuneCarverAI<EventMap, Milliseconds>, EventMap, Milliseconds>
+{
+    friend class RuneCarverEncounterAI<RuneCarverAI, EventMap, Milliseconds>;
+
+    void IsSummonedBy(Unit* /*summoner*/)
+    {
+        this->_ScheduleCarverEvents();
+    }
+
+    void UpdateAI(uint32 diff, Unit* victim)
+    {
+        this->_events.Update(diff);
+        while (uint32 eventId = this->_events.ExecuteEvent())
+            if (!this->_ExecuteEncounterEvent(eventId, victim))
+                _LogError(eventId);
+    }
+
+private:
+    void _LogError(uint32 eventId);
+
+    //RuneCarverEncounterAI calls
+    bool _IsStandingInMelee(Unit* victim) const;
+    void _CastFlames();
+};
+
+}
+
+//every member of the bases and the stand-ins, per core flavour
+template class RuneworderEncounterAI<runeworder_stubs::RuneworderAI<runeworder_stubs::tc::EventMap, runeworder_stubs::tc::Milliseconds>,
+    runeworder_stubs::tc::EventMap, runeworder_stubs::tc::Milliseconds>;
+template class RuneCarverEncounterAI<runeworder_stubs::RuneCarverAI<runeworder_stubs::tc::EventMap, runeworder_stubs::tc::Milliseconds>,
+    runeworder_stubs::tc::EventMap, runeworder_stubs::tc::Milliseconds>;
+template struct runeworder_stubs::RuneworderAI<runeworder_stubs::tc::EventMap, runeworder_stubs::tc::Milliseconds>;
+template struct runeworder_stubs::RuneCarverAI<runeworder_stubs::tc::EventMap, runeworder_stubs::tc::Milliseconds>;
+
+template class RuneworderEncounterAI<runeworder_stubs::RuneworderAI<runeworder_stubs::ac::EventMap, runeworder_stubs::ac::Milliseconds>,
+    runeworder_stubs::ac::EventMap, runeworder_stubs::ac::Milliseconds>;
+template class RuneCarverEncounterAI<runeworder_stubs::RuneCarverAI<runeworder_stubs::ac::EventMap, runeworder_stubs::ac::Milliseconds>,
+    runeworder_stubs::ac::EventMap, runeworder_stubs::ac::Milliseconds>;
+template struct runeworder_stubs::RuneworderAI<runeworder_stubs::ac::EventMap, runeworder_stubs::ac::Milliseconds>;
+template struct runeworder_stubs::RuneCarverAI<runeworder_stubs::ac::EventMap, runeworder_stubs::ac::Milliseconds>;
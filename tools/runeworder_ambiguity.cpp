@@ -0,0 +1,263 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Offline rune ambiguity analyzer
+//Walks every sequence of a pack's match table (see boss_runeworder_table.h) and reports
+//which runes co-match, on what share of sequences and at which lengths, and how often
+//each rune wins the weighted roll (same top-k heap and weights as the boss)
+//usage: runeworder_ambiguity [--threads N] [--matrix matrix.csv] <pack.rwpk>
+
+#include "boss_runeworder_pack.h"
+#include "runeworder_pool.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+constexpr uint64 TASK_WORDS = 1024; //table words (64 sequences each) per task
+
+//per thread, merged at the end
+struct AmbiguityStats
+{
+    void Resize(size_t lengths)
+    {
+        sequences.assign(lengths, 0);
+        ambiguous.assign(lengths, 0);
+        matched.assign(lengths * MAX_RUNE_PATTERNS, 0);
+        shared.assign(lengths * MAX_RUNE_PATTERNS, 0);
+        coMatched.assign(lengths * MAX_RUNE_PATTERNS * MAX_RUNE_PATTERNS, 0);
+        wins.assign(MAX_RUNE_TYPES, 0.0);
+    }
+
+    void Merge(AmbiguityStats const& other)
+    {
+        auto add = [](auto& to, auto const& from)
+        {
+            for (size_t i = 0; i < to.size(); ++i)
+                to[i] += from[i];
+        };
+        add(sequences, other.sequences);
+        add(ambiguous, other.ambiguous);
+        add(matched, other.matched);
+        add(shared, other.shared);
+        add(coMatched, other.coMatched);
+        add(wins, other.wins);
+    }
+
+    std::vector<uint64> sequences;  //[length] matched by any rune
+    std::vector<uint64> ambiguous;  //[length] matched by 2+ runes
+    std::vector<uint64> matched;    //[length][rune]
+    std::vector<uint64> shared;     //[length][rune] matched together with another rune
+    std::vector<uint64> coMatched;  //[length][rune][rune] matched by both
+    std::vector<double> wins;       //[rune type] expected roll wins
+};
+
+//expected roll result of a matched sequence, same heap and weights as _ComputateRuneType with the default budget
+void AddRollWins(std::vector<RunePattern> const& patterns, Stroke const* compSeq, size_t size, RunePatternBits const& set, std::vector<double>& wins)
+{
+    RuneMatchHeap<MAX_RUNE_MATCHES> matches;
+    set.ForEach([&](size_t i)
+    {
+        RuneMatch match;
+        match.type = patterns[i].type;
+        if (patterns[i].Matches(compSeq, size, match.score) && match.score.errors <= UNMATCH_THRESHOLD)
+            matches.Push(match);
+    });
+
+    uint32 total = 0;
+    for (RuneMatch const& match : matches)
+        total += GetRuneMatchWeight(match, UNMATCH_THRESHOLD);
+    for (RuneMatch const& match : matches)
+        wins[match.type] += double(GetRuneMatchWeight(match, UNMATCH_THRESHOLD)) / total;
+}
+
+double GetShare(uint64 part, uint64 whole)
+{
+    return whole ? 100.0 * double(part) / double(whole) : 0.0;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 threadCount = WorkStealingPool::GetDefaultThreads();
+    char const* matrixFile = nullptr;
+    std::vector<char const*> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threadCount = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--matrix") && i + 1 < argc)
+            matrixFile = argv[++i];
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (args.size() != 1)
+    {
+        std::fprintf(stderr, "usage: %s [--threads N] [--matrix matrix.csv] <pack file>\n", argv[0]);
+        return 1;
+    }
+
+    RunePack pack;
+    std::string error;
+    if (!pack.Load(args[0], error))
+    {
+        std::fprintf(stderr, "cannot load %s: %s\n", args[0], error.c_str());
+        return 1;
+    }
+
+    RuneMatchTable const& table = pack.GetMatchTable();
+    if (table.empty())
+    {
+        std::fprintf(stderr, "%s has no match table, generate it with --table-length\n", args[0]);
+        return 1;
+    }
+
+    std::vector<RunePattern> const& patterns = pack.GetRunePatterns();
+    size_t const runeCount = patterns.size();
+    size_t const lengths = table.maxLength - table.minLength + 1;
+    uint64 const wordCount = GetRuneTableWords(table.minLength, table.maxLength);
+
+    std::vector<AmbiguityStats> stats(threadCount);
+    for (AmbiguityStats& threadStats : stats)
+        threadStats.Resize(lengths);
+
+    //word ranges, rank of the first word locates the match sets
+    WorkStealingPool::Run(uint32((wordCount + TASK_WORDS - 1) / TASK_WORDS), threadCount, [&](uint32 task, uint32 thread)
+    {
+        AmbiguityStats& threadStats = stats[thread];
+        uint64 const firstWord = task * TASK_WORDS;
+        uint64 const lastWord = std::min(wordCount, firstWord + TASK_WORDS);
+
+        uint64 rank = table.ranks[firstWord / RUNE_TABLE_RANK_WORDS];
+        for (uint64 i = firstWord - firstWord % RUNE_TABLE_RANK_WORDS; i < firstWord; ++i)
+            rank += uint64(std::popcount(table.words[i]));
+
+        std::vector<size_t> runes;
+        for (uint64 word = firstWord; word < lastWord; ++word)
+        {
+            for (uint64 bits = table.words[word]; bits; bits &= bits - 1, ++rank)
+            {
+                uint64 number = word * 64 + uint64(std::countr_zero(bits));
+                size_t length = table.minLength;
+                while (number >= GetRuneTableSequences(length))
+                    number -= GetRuneTableSequences(length++);
+
+                size_t const l = length - table.minLength;
+                RunePatternBits const& set = table.sets[table.matchSets[rank]];
+                runes.clear();
+                set.ForEach([&](size_t i) { runes.push_back(i); });
+
+                ++threadStats.sequences[l];
+                if (runes.size() > 1)
+                    ++threadStats.ambiguous[l];
+                for (size_t a : runes)
+                {
+                    ++threadStats.matched[l * MAX_RUNE_PATTERNS + a];
+                    if (runes.size() > 1)
+                        ++threadStats.shared[l * MAX_RUNE_PATTERNS + a];
+                    for (size_t b : runes)
+                        if (a != b)
+                            ++threadStats.coMatched[(l * MAX_RUNE_PATTERNS + a) * MAX_RUNE_PATTERNS + b];
+                }
+
+                RuneTableSequence const sequence = GetRuneTableSequence(number, length);
+                AddRollWins(patterns, sequence.data(), length, set, threadStats.wins);
+            }
+        }
+    });
+
+    AmbiguityStats& total = stats[0];
+    for (size_t i = 1; i < stats.size(); ++i)
+        total.Merge(stats[i]);
+
+    std::printf("%s: %u runes, match table of %u-%u strokes\n", args[0], uint32(runeCount), uint32(table.minLength), uint32(table.maxLength));
+    std::printf("\nlength   sequences     matched    ambiguous\n");
+    for (size_t l = 0; l < lengths; ++l)
+    {
+        uint64 all = GetRuneTableSequences(table.minLength + l);
+        std::printf("%6u %11llu %11llu %5.1f%% %6.1f%% of matched\n", uint32(table.minLength + l), (unsigned long long)all,
+            (unsigned long long)total.sequences[l], GetShare(total.sequences[l], all), GetShare(total.ambiguous[l], total.sequences[l]));
+    }
+
+    //pairs over all lengths, most co-matched first
+    struct Pair
+    {
+        size_t a;
+        size_t b;
+        uint64 count;
+    };
+    std::vector<Pair> pairs;
+    std::vector<uint64> matched(runeCount, 0), shared(runeCount, 0);
+    for (size_t a = 0; a < runeCount; ++a)
+    {
+        for (size_t l = 0; l < lengths; ++l)
+        {
+            matched[a] += total.matched[l * MAX_RUNE_PATTERNS + a];
+            shared[a] += total.shared[l * MAX_RUNE_PATTERNS + a];
+        }
+        for (size_t b = a + 1; b < runeCount; ++b)
+        {
+            uint64 count = 0;
+            for (size_t l = 0; l < lengths; ++l)
+                count += total.coMatched[(l * MAX_RUNE_PATTERNS + a) * MAX_RUNE_PATTERNS + b];
+            if (count)
+                pairs.push_back({ a, b, count });
+        }
+    }
+    std::sort(pairs.begin(), pairs.end(), [](Pair const& x, Pair const& y) { return x.count > y.count; });
+
+    std::printf("\nco-matching runes (%u pairs), share of each rune's sequences:\n", uint32(pairs.size()));
+    for (size_t i = 0; i < pairs.size() && i < 30; ++i)
+    {
+        Pair const& pair = pairs[i];
+        std::printf("%-6s %-6s %10llu %5.1f%% %5.1f%%  by length:", pack.GetRuneName(pair.a), pack.GetRuneName(pair.b),
+            (unsigned long long)pair.count, GetShare(pair.count, matched[pair.a]), GetShare(pair.count, matched[pair.b]));
+        for (size_t l = 0; l < lengths; ++l)
+            std::printf(" %u:%llu", uint32(table.minLength + l),
+                (unsigned long long)total.coMatched[(l * MAX_RUNE_PATTERNS + pair.a) * MAX_RUNE_PATTERNS + pair.b]);
+        std::printf("\n");
+    }
+
+    std::printf("\nrune      matched   shared  roll wins   win rate\n");
+    for (size_t a = 0; a < runeCount; ++a)
+    {
+        double wins = total.wins[patterns[a].type];
+        std::printf("%-6s %10llu %6.1f%% %10.0f %8.1f%%\n", pack.GetRuneName(a), (unsigned long long)matched[a],
+            GetShare(shared[a], matched[a]), wins, matched[a] ? 100.0 * wins / double(matched[a]) : 0.0);
+    }
+
+    if (matrixFile)
+    {
+        FILE* file = std::fopen(matrixFile, "w");
+        if (!file)
+        {
+            std::fprintf(stderr, "cannot write %s\n", matrixFile);
+            return 1;
+        }
+
+        std::fprintf(file, "length,rune,other,matched,co_matched,share\n");
+        for (size_t l = 0; l < lengths; ++l)
+        {
+            for (size_t a = 0; a < runeCount; ++a)
+            {
+                uint64 runeMatched = total.matched[l * MAX_RUNE_PATTERNS + a];
+                for (size_t b = 0; b < runeCount; ++b)
+                {
+                    uint64 count = total.coMatched[(l * MAX_RUNE_PATTERNS + a) * MAX_RUNE_PATTERNS + b];
+                    if (count)
+                        std::fprintf(file, "%u,%s,%s,%llu,%llu,%.4f\n", uint32(table.minLength + l), pack.GetRuneName(a),
+                            pack.GetRuneName(b), (unsigned long long)runeMatched, (unsigned long long)count, double(count) / double(runeMatched));
+                }
+            }
+        }
+        std::fclose(file);
+    }
+
+    return 0;
+}
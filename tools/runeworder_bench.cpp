@@ -0,0 +1,186 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Offline matcher benchmark
+//Checks the specialized matchers (boss_runeworder_matchers.h) against the generic one on every sequence
+//of up to 6 strokes and on random longer ones, then times both on the same random carved-like sequences
+//and counts L1 data cache misses per rune (one pass over all runes) where the CPU exposes the counter,
+//then times the stroke classifier on random carved paths of the same lengths
+//usage: runeworder_bench [sequences] [min length] [max length]
+
+#include "boss_runeworder_matchers.h"
+#include "boss_runeworder_strokes.h"
+#include "boss_runeworder_table.h"
+#include "runeworder_perf.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+namespace
+{
+
+bool SameMatch(size_t i, Stroke const* compSeq, size_t size)
+{
+    RuneEncodedSequence seq;
+    EncodeRuneSequence(compSeq, size, seq);
+    RuneMatchScore generic, specialized;
+    bool genericMatch = RunePatterns[i].Matches(compSeq, size, generic);
+    bool specializedMatch = RuneMatchers[i](seq, specialized);
+    return genericMatch == specializedMatch && (!genericMatch || (generic.errors == specialized.errors &&
+        generic.offset == specialized.offset && generic.coverage == specialized.coverage && generic.reversed == specialized.reversed));
+}
+
+struct MatchTiming
+{
+    double nanoseconds;     //per rune pattern
+    double l1Misses;        //per rune (all patterns)
+};
+
+//sequence is encoded once for all runes, as the boss does
+template<typename F>
+MatchTiming TimeMatches(std::vector<Strokes> const& sequences, F const& match, PerfCounter& counter, uint32& matched)
+{
+    counter.Start();
+    auto start = std::chrono::steady_clock::now();
+    matched = 0;
+    for (Strokes const& sequence : sequences)
+    {
+        RuneEncodedSequence seq;
+        EncodeRuneSequence(sequence.data(), sequence.size(), seq);
+        for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+        {
+            RuneMatchScore score;
+            matched += match(i, seq, score);
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    uint64 misses = counter.Stop();
+    return { elapsed.count() / (double(sequences.size()) * double(MAX_RUNE_TYPES)), double(misses) / double(sequences.size()) };
+}
+
+//one generic pass over all runes per sequence with data caches evicted before each, built-in patterns
+//read from their scattered definitions or from the arena, average ns per pass
+double TimeColdPasses(std::vector<Strokes> const& sequences, RunePattern const* patterns, std::vector<uint8>& evict, uint32& matched)
+{
+    double total = 0.0;
+    size_t passes = std::min<size_t>(sequences.size(), 2000);
+    for (size_t s = 0; s < passes; ++s)
+    {
+        for (size_t i = 0; i < evict.size(); i += 64)
+            ++evict[i];
+
+        auto start = std::chrono::steady_clock::now();
+        RuneEncodedSequence seq;
+        EncodeRuneSequence(sequences[s].data(), sequences[s].size(), seq);
+        for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+        {
+            RuneMatchScore score;
+            matched += patterns[i].MatchesEncoded(seq, score);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed.count();
+    }
+    return total / double(passes);
+}
+
+//vertex angles and strokes of random carved paths as _ComputateRuneType does, average ns per path
+double TimeClassify(uint32 count, uint32 minLength, uint32 maxLength, std::mt19937& rng, uint32& strokes)
+{
+    std::uniform_real_distribution<float> coord(-20.f, 20.f);
+    std::vector<std::vector<Position>> paths(count);
+    for (std::vector<Position>& path : paths)
+    {
+        path.resize(minLength + 2 + rng() % (maxLength - minLength + 1));
+        for (Position& pos : path)
+            pos.Relocate(coord(rng), coord(rng));
+    }
+
+    std::vector<int32> angles;
+    auto start = std::chrono::steady_clock::now();
+    for (std::vector<Position> const& path : paths)
+    {
+        angles.resize(path.size() - 2);
+        for (size_t i = 1; i + 1 < path.size(); ++i)
+            angles[i - 1] = GetDegrees(&path[i - 1], &path[i], &path[i + 1]);
+        strokes += uint32(ClassifyRuneStrokes(angles.data(), uint32(angles.size())).size());
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / double(count);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 count = argc > 1 ? uint32(std::strtoul(argv[1], nullptr, 10)) : 200000;
+    uint32 minLength = argc > 2 ? uint32(std::strtoul(argv[2], nullptr, 10)) : MIN_RUNE_PATTERN_LENGTH;
+    uint32 maxLength = argc > 3 ? uint32(std::strtoul(argv[3], nullptr, 10)) : 10;
+    if (!count || minLength < 1 || minLength > maxLength || maxLength > MAX_RUNE_SEQUENCE_LENGTH)
+    {
+        std::fprintf(stderr, "usage: %s [sequences] [min length] [max length <= %u]\n", argv[0], uint32(MAX_RUNE_SEQUENCE_LENGTH));
+        return 1;
+    }
+
+    std::mt19937 rng(12345);
+    std::vector<Strokes> sequences(count);
+    for (Strokes& sequence : sequences)
+    {
+        sequence.resize(minLength + rng() % (maxLength - minLength + 1), Stroke(LINE, false));
+        for (Stroke& stroke : sequence)
+            stroke = GetRuneTableStroke(rng() % RUNE_TABLE_SYMBOLS);
+    }
+
+    //exhaustive up to 6 strokes, then the timed set
+    uint64 checked = 0, mismatches = 0;
+    for (size_t length = 1; length <= 6; ++length)
+    {
+        for (uint64 number = 0; number < GetRuneTableSequences(length); ++number)
+        {
+            RuneTableSequence const sequence = GetRuneTableSequence(number, length);
+            for (size_t i = 0; i < MAX_RUNE_TYPES; ++i, ++checked)
+                mismatches += !SameMatch(i, sequence.data(), length);
+        }
+    }
+    for (Strokes const& timed : sequences)
+        for (size_t i = 0; i < MAX_RUNE_TYPES; ++i, ++checked)
+            mismatches += !SameMatch(i, timed.data(), timed.size());
+
+    std::printf("checked %llu pattern/sequence pairs, %llu mismatches\n", (unsigned long long)checked, (unsigned long long)mismatches);
+    if (mismatches)
+        return 1;
+
+    PerfCounter counter(PERF_L1D_READ_MISSES);
+    uint32 genericMatched = 0, specializedMatched = 0;
+    MatchTiming generic = TimeMatches(sequences, [](size_t i, RuneEncodedSequence const& seq, RuneMatchScore& score)
+    {
+        return RunePatterns[i].MatchesEncoded(seq, score);
+    }, counter, genericMatched);
+    MatchTiming specialized = TimeMatches(sequences, [](size_t i, RuneEncodedSequence const& seq, RuneMatchScore& score)
+    {
+        return RuneMatchers[i](seq, score);
+    }, counter, specializedMatched);
+
+    std::printf("%u sequences of %u-%u strokes x %u runes: generic %.1f ns, specialized %.1f ns per match (%.2fx), %u matched\n",
+        count, minLength, maxLength, uint32(MAX_RUNE_TYPES), generic.nanoseconds, specialized.nanoseconds,
+        generic.nanoseconds / specialized.nanoseconds, genericMatched);
+    if (counter.IsOpen())
+        std::printf("L1D read misses per rune: generic %.2f, specialized %.2f (pattern arena %u bytes, %u cache lines)\n",
+            generic.l1Misses, specialized.l1Misses, uint32(sizeof(RuneArena.masks)), uint32((sizeof(RuneArena.masks) + 63) / 64));
+    else
+        std::printf("L1D miss counter unavailable: %s\n", counter.GetError());
+
+    std::vector<uint8> evict(32 << 20, 0);
+    uint32 coldMatched = 0;
+    double scattered = TimeColdPasses(sequences, RunePatternDefs, evict, coldMatched);
+    double arena = TimeColdPasses(sequences, RunePatterns.data(), evict, coldMatched);
+    std::printf("cold pass over all runes (caches evicted): scattered patterns %.0f ns, arena %.0f ns\n", scattered, arena);
+
+    uint32 classified = 0;
+    double classify = TimeClassify(count, minLength, maxLength, rng, classified);
+    std::printf("stroke classifier: %.1f ns per path, %u strokes\n", classify, classified);
+    return genericMatched == specializedMatched ? 0 : 1;
+}
@@ -0,0 +1,385 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Benchmark baseline comparator
+//Reruns the rune recognition (GetDegrees, stroke classification, candidate match), runeword resolution
+//(runeword candidates, weighted roll) and encounter tick (carver sampling) stages of runeworder_stages.h
+//with warm-up and repetitions, and compares the medians with a baseline JSON. Fails when a stage result (checksum)
+//changed or a gated metric is worse than the baseline by more than its tolerance. Machine-independent metrics
+//(allocations, instructions where perf events are available) are gated tightly, timings with a wide tolerance that
+//still catches a complexity regression on another machine; tighten it with --tolerance on the machine that recorded
+//the baseline, or drop a gate with --no-gate (--update keeps tolerances and gates).
+//usage: runeworder_compare [--warmup N] [--repetitions N] [--inputs N] [--tolerance metric=value] [--gate metric]
+//                          [--no-gate metric] [--update] <baseline.json>
+
+#define RUNEWORDER_COUNT_ALLOCATIONS
+#include "runeworder_stages.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+
+constexpr uint32 DEFAULT_COMPARE_INPUTS = 5000;
+
+//stages of the compared benchmarks
+constexpr char const* CompareStages[] = { "degrees/", "classify/", "match_all/", "runeword/", "roll/", "sample/" };
+
+enum CompareMetrics
+{
+    METRIC_NS,
+    METRIC_ALLOCS,
+    METRIC_CYCLES,
+    METRIC_INSTRUCTIONS,
+    METRIC_BRANCH_MISSES,
+    METRIC_L1D_READ_MISSES,
+    MAX_COMPARE_METRICS
+};
+
+constexpr char const* CompareMetricNames[MAX_COMPARE_METRICS] =
+{
+    "ns_per_op", "allocs_per_op", "cycles_per_op", "instructions_per_op", "branch_misses_per_op", "l1d_read_misses_per_op"
+};
+
+//allowed relative increase, overridden by the baseline and the command line
+//timings vary up to 3x between machines and loads, so they fail only past that
+constexpr double DefaultTolerances[MAX_COMPARE_METRICS] = { 2.0, 0.0, 1.0, 0.03, 0.25, 0.25 };
+//metrics failing the comparison, cache and branch misses are reported only
+constexpr bool DefaultGated[MAX_COMPARE_METRICS] = { true, true, true, true, false, false };
+
+//-1 if unavailable
+double GetMetric(BenchResult const& result, uint32 metric)
+{
+    switch (metric)
+    {
+        case METRIC_NS:     return result.nanoseconds;
+        case METRIC_ALLOCS: return result.allocations;
+        default:            return result.events[metric - METRIC_CYCLES];
+    }
+}
+
+//value of "key": in a flat JSON object, false if missing or null
+bool FindJsonNumber(std::string const& object, char const* key, double& value)
+{
+    std::string quoted = std::string("\"") + key + "\":";
+    size_t pos = object.find(quoted);
+    if (pos == std::string::npos)
+        return false;
+
+    char const* begin = object.c_str() + pos + quoted.size();
+    char* end = nullptr;
+    value = std::strtod(begin, &end);
+    return end != begin;
+}
+
+//integers beyond double precision (checksums)
+bool FindJsonUInt(std::string const& object, char const* key, uint64& value)
+{
+    std::string quoted = std::string("\"") + key + "\":";
+    size_t pos = object.find(quoted);
+    if (pos == std::string::npos)
+        return false;
+
+    char const* begin = object.c_str() + pos + quoted.size();
+    char* end = nullptr;
+    value = std::strtoull(begin, &end, 10);
+    return end != begin;
+}
+
+bool FindJsonString(std::string const& object, char const* key, std::string& value)
+{
+    std::string quoted = std::string("\"") + key + "\": \"";
+    size_t pos = object.find(quoted);
+    if (pos == std::string::npos)
+        return false;
+
+    size_t begin = pos + quoted.size();
+    size_t end = object.find('"', begin);
+    if (end == std::string::npos)
+        return false;
+    value = object.substr(begin, end - begin);
+    return true;
+}
+
+struct Baseline
+{
+    uint32 inputs = DEFAULT_COMPARE_INPUTS;
+    double tolerances[MAX_COMPARE_METRICS];
+    bool gated[MAX_COMPARE_METRICS];
+    std::vector<BenchResult> results;
+    std::vector<std::array<bool, MAX_COMPARE_METRICS>> present;
+};
+
+//reads the files written by WriteBaseline, results are flat objects
+bool LoadBaseline(char const* fileName, Baseline& baseline, std::string& error)
+{
+    std::copy(std::begin(DefaultTolerances), std::end(DefaultTolerances), baseline.tolerances);
+    std::copy(std::begin(DefaultGated), std::end(DefaultGated), baseline.gated);
+
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        error = "cannot open file";
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    double value;
+    if (FindJsonNumber(text, "inputs", value) && value >= 1.0)
+        baseline.inputs = uint32(value);
+
+    size_t tolerances = text.find("\"tolerances\"");
+    if (tolerances != std::string::npos)
+    {
+        std::string object = text.substr(tolerances, text.find('}', tolerances) - tolerances);
+        for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+            if (FindJsonNumber(object, CompareMetricNames[m], value) && value >= 0.0)
+                baseline.tolerances[m] = value;
+    }
+
+    size_t gated = text.find("\"gated\"");
+    if (gated != std::string::npos)
+    {
+        std::string object = text.substr(gated, text.find('}', gated) - gated);
+        for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+            if (FindJsonNumber(object, CompareMetricNames[m], value))
+                baseline.gated[m] = value != 0.0;
+    }
+
+    size_t pos = text.find("\"results\"");
+    if (pos == std::string::npos)
+    {
+        error = "no results";
+        return false;
+    }
+
+    while ((pos = text.find('{', pos)) != std::string::npos)
+    {
+        size_t end = text.find('}', pos);
+        if (end == std::string::npos)
+            break;
+
+        std::string object = text.substr(pos, end - pos);
+        pos = end;
+
+        BenchResult result;
+        if (!FindJsonString(object, "name", result.name))
+        {
+            error = "result without name";
+            return false;
+        }
+        FindJsonUInt(object, "checksum", result.checksum);
+
+        std::array<bool, MAX_COMPARE_METRICS> present;
+        for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+        {
+            present[m] = FindJsonNumber(object, CompareMetricNames[m], value);
+            if (!present[m])
+                continue;
+            if (m == METRIC_NS)
+                result.nanoseconds = value;
+            else if (m == METRIC_ALLOCS)
+                result.allocations = value;
+            else
+                result.events[m - METRIC_CYCLES] = value;
+        }
+        baseline.results.push_back(result);
+        baseline.present.push_back(present);
+    }
+    return true;
+}
+
+bool WriteBaseline(char const* fileName, Baseline const& baseline, std::vector<BenchResult> const& results)
+{
+    FILE* file = std::fopen(fileName, "w");
+    if (!file)
+        return false;
+
+    std::fprintf(file, "{\n  \"benchmark\": \"runeworder_compare\",\n  \"inputs\": %u,\n  \"compiler\": \"%s\",\n  \"tolerances\": {",
+        baseline.inputs, __VERSION__);
+    for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+        std::fprintf(file, "%s\"%s\": %.3f", m ? ", " : " ", CompareMetricNames[m], baseline.tolerances[m]);
+    std::fprintf(file, " },\n  \"gated\": {");
+    for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+        std::fprintf(file, "%s\"%s\": %u", m ? ", " : " ", CompareMetricNames[m], uint32(baseline.gated[m]));
+    std::fprintf(file, " },\n");
+    WriteBenchResults(file, results);
+    std::fprintf(file, "}\n");
+    std::fclose(file);
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 warmups = 2;
+    uint32 repetitions = 11;
+    uint32 inputs = 0;
+    bool update = false;
+    std::vector<std::pair<std::string, double>> tolerances;
+    std::vector<std::pair<std::string, bool>> gates;
+    std::vector<char const*> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--warmup") && i + 1 < argc)
+            warmups = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--repetitions") && i + 1 < argc)
+            repetitions = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--inputs") && i + 1 < argc)
+            inputs = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--tolerance") && i + 1 < argc)
+        {
+            std::string arg = argv[++i];
+            size_t eq = arg.find('=');
+            if (eq != std::string::npos)
+                tolerances.emplace_back(arg.substr(0, eq), std::strtod(arg.c_str() + eq + 1, nullptr));
+        }
+        else if (!std::strcmp(argv[i], "--gate") && i + 1 < argc)
+            gates.emplace_back(argv[++i], true);
+        else if (!std::strcmp(argv[i], "--no-gate") && i + 1 < argc)
+            gates.emplace_back(argv[++i], false);
+        else if (!std::strcmp(argv[i], "--update"))
+            update = true;
+        else
+            args.push_back(argv[i]);
+    }
+
+    if (args.size() != 1)
+    {
+        std::fprintf(stderr, "usage: %s [--warmup N] [--repetitions N] [--inputs N] [--tolerance metric=value] [--gate metric] "
+            "[--no-gate metric] [--update] <baseline.json>\n", argv[0]);
+        return 1;
+    }
+
+    Baseline baseline;
+    std::string error;
+    bool loaded = LoadBaseline(args[0], baseline, error);
+    if (!loaded && !update)
+    {
+        std::fprintf(stderr, "cannot load %s: %s\n", args[0], error.c_str());
+        return 1;
+    }
+    if (inputs)
+        baseline.inputs = inputs;
+    for (auto const& [metric, tolerance] : tolerances)
+    {
+        uint32 m = 0;
+        while (m < MAX_COMPARE_METRICS && metric != CompareMetricNames[m])
+            ++m;
+        if (m == MAX_COMPARE_METRICS || tolerance < 0.0)
+        {
+            std::fprintf(stderr, "unknown metric or bad tolerance: %s\n", metric.c_str());
+            return 1;
+        }
+        baseline.tolerances[m] = tolerance;
+    }
+    for (auto const& [metric, gate] : gates)
+    {
+        uint32 m = 0;
+        while (m < MAX_COMPARE_METRICS && metric != CompareMetricNames[m])
+            ++m;
+        if (m == MAX_COMPARE_METRICS)
+        {
+            std::fprintf(stderr, "unknown metric: %s\n", metric.c_str());
+            return 1;
+        }
+        baseline.gated[m] = gate;
+    }
+
+    BenchInputs realistic = GetRealisticBenchInputs(baseline.inputs);
+    BenchInputs adversarial = GetAdversarialBenchInputs(baseline.inputs);
+    std::vector<BenchStage> stages;
+    AddBenchStages(stages, realistic, "realistic");
+    AddBenchStages(stages, adversarial, "adversarial");
+
+    PerfCounters counters;
+    std::vector<BenchResult> results;
+    uint32 regressions = 0;
+    std::string gatedNames;
+    for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+        if (baseline.gated[m])
+            gatedNames += std::string(gatedNames.empty() ? "" : ", ") + CompareMetricNames[m];
+    std::printf("%u inputs, %u warm-up passes, %u repetitions, gated: checksum%s%s\n", baseline.inputs, warmups, repetitions,
+        gatedNames.empty() ? "" : ", ", gatedNames.c_str());
+    std::printf("%-24s %10s %10s %7s  %s\n", "stage", "ns/op", "baseline", "stddev", "result");
+    for (BenchStage const& stage : stages)
+    {
+        bool compared = false;
+        for (char const* prefix : CompareStages)
+            compared = compared || !stage.name.compare(0, std::strlen(prefix), prefix);
+        if (!compared)
+            continue;
+
+        BenchResult result = RunBenchStage(stage, counters, warmups, repetitions);
+        results.push_back(result);
+
+        size_t b = 0;
+        while (b < baseline.results.size() && baseline.results[b].name != result.name)
+            ++b;
+        if (b == baseline.results.size())
+        {
+            std::printf("%-24s %10.1f %10s %6.1f%%  new\n", result.name.c_str(), result.nanoseconds, "-", 100.0 * result.deviation);
+            continue;
+        }
+
+        BenchResult const& base = baseline.results[b];
+        std::string verdict;
+        std::string notes; //worse beyond tolerance, not gated
+        if (result.checksum != base.checksum)
+        {
+            verdict += " checksum changed";
+            ++regressions;
+        }
+        for (uint32 m = 0; m < MAX_COMPARE_METRICS; ++m)
+        {
+            double current = GetMetric(result, m);
+            double previous = GetMetric(base, m);
+            if (!baseline.present[b][m] || current < 0.0 || previous < 0.0)
+                continue;
+
+            double limit = previous * (1.0 + baseline.tolerances[m]) + 1e-9;
+            if (current > limit)
+            {
+                char text[128];
+                std::snprintf(text, sizeof(text), " %s %.3f > %.3f (+%.0f%%)", CompareMetricNames[m], current, previous,
+                    previous > 0.0 ? 100.0 * (current / previous - 1.0) : 100.0);
+                if (baseline.gated[m])
+                {
+                    verdict += text;
+                    ++regressions;
+                }
+                else
+                    notes += text;
+            }
+        }
+
+        std::printf("%-24s %10.1f %10.1f %6.1f%%  %s\n", result.name.c_str(), result.nanoseconds, base.nanoseconds,
+            100.0 * result.deviation, !verdict.empty() ? ("REGRESSION" + verdict).c_str() : notes.empty() ? "ok" : ("ok, not gated:" + notes).c_str());
+    }
+
+    if (update)
+    {
+        if (!WriteBaseline(args[0], baseline, results))
+        {
+            std::fprintf(stderr, "cannot write %s\n", args[0]);
+            return 1;
+        }
+        std::printf("baseline %s updated\n", args[0]);
+        return 0;
+    }
+
+    if (regressions)
+    {
+        std::printf("%u regressions beyond tolerance\n", regressions);
+        return 1;
+    }
+    std::printf("no regressions\n");
+    return 0;
+}
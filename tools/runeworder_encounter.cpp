@@ -0,0 +1,173 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Headless encounter simulator
+//Runs whole fights of the boss AI state machine (runeworder_encounter.h) on a virtual clock, on all threads,
+//and reports the AI CPU time per simulated fight minute and per tick, the cost of each event and the fight
+//outcome. Fights are seeded by their index, the digest of the executed events does not depend on the thread
+//count, so a change to the simulated UpdateAI that should not alter behaviour can be checked by it.
+//usage: runeworder_encounter [--fights N] [--threads N] [--seed N] [--tick ms] [--players N] [--style name]
+//                            [--tank-style name] [--dps pct/s] [--speed speed_run] [--points N] [--budget N]
+//                            [--rune-duration ms] [--runeword-duration ms]
+
+#include "runeworder_encounter.h"
+#include "runeworder_pool.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+
+constexpr uint32 FIGHTS_PER_TASK = 4;
+
+struct EncounterThread
+{
+    EncounterStats stats;
+    std::vector<uint32> tickNs;     //boss and carver AI of each tick
+};
+
+bool ParseStyle(char const* name, MovementStyles& style)
+{
+    for (uint32 s = 0; s < MAX_MOVEMENT_STYLES; ++s)
+    {
+        if (!std::strcmp(name, MovementStyleNames[s]))
+        {
+            style = MovementStyles(s);
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32 GetPercentile(std::vector<uint32>& values, double percentile)
+{
+    if (values.empty())
+        return 0;
+    size_t index = std::min(values.size() - 1, size_t(double(values.size()) * percentile));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 fights = 200;
+    uint32 threads = WorkStealingPool::GetDefaultThreads();
+    uint32 seed = 12345;
+    EncounterOptions options;
+    bool valid = true;
+    for (int i = 1; i < argc && valid; ++i)
+    {
+        if (!std::strcmp(argv[i], "--fights") && i + 1 < argc)
+            fights = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--tick") && i + 1 < argc)
+            options.tick = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--players") && i + 1 < argc)
+            options.players = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--style") && i + 1 < argc)
+            valid = ParseStyle(argv[++i], options.style);
+        else if (!std::strcmp(argv[i], "--tank-style") && i + 1 < argc)
+            valid = ParseStyle(argv[++i], options.tankStyle);
+        else if (!std::strcmp(argv[i], "--dps") && i + 1 < argc)
+            options.raidDps = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--speed") && i + 1 < argc)
+            options.carverSpeedRate = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--points") && i + 1 < argc)
+            options.runePoints = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--budget") && i + 1 < argc)
+            options.budget = std::min(uint32(std::strtoul(argv[++i], nullptr, 10)), uint32(MAX_RUNE_MATCH_ERRORS));
+        else if (!std::strcmp(argv[i], "--rune-duration") && i + 1 < argc)
+            options.runeDuration = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--runeword-duration") && i + 1 < argc)
+            options.runewordDuration = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else
+            valid = false;
+    }
+
+    if (!valid || !fights || !options.tick || !options.players || options.raidDps <= 0.f || options.carverSpeedRate <= 0.f ||
+        options.runePoints < MIN_RUNE_PATTERN_LENGTH + 2 || options.runePoints > MAX_RUNE_SEQUENCE_LENGTH + 2)
+    {
+        std::fprintf(stderr, "usage: %s [--fights N] [--threads N] [--seed N] [--tick ms] [--players N] [--style name] [--tank-style name]\n"
+            "    [--dps pct/s] [--speed speed_run] [--points %u-%u] [--budget N] [--rune-duration ms] [--runeword-duration ms]\n"
+            "styles: circle|zigzag|stand|random_walk\n",
+            argv[0], uint32(MIN_RUNE_PATTERN_LENGTH + 2), uint32(MAX_RUNE_SEQUENCE_LENGTH + 2));
+        return 1;
+    }
+
+    std::printf("%u fights, %u threads, %u ms ticks, %u players (tank %s, others %s), raid dps %.3f%%/s, %u points, budget %u\n",
+        fights, threads, options.tick, options.players, MovementStyleNames[options.tankStyle],
+        options.style < MAX_MOVEMENT_STYLES ? MovementStyleNames[options.style] : "mixed", options.raidDps, options.runePoints, options.budget);
+
+    uint32 tasks = (fights + FIGHTS_PER_TASK - 1) / FIGHTS_PER_TASK;
+    std::vector<EncounterThread> threadData(threads);
+    std::vector<uint32> digests(fights);
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool::Run(tasks, threads, [&](uint32 task, uint32 thread)
+    {
+        EncounterThread& data = threadData[thread];
+        for (uint32 fight = task * FIGHTS_PER_TASK; fight < std::min(fights, (task + 1) * FIGHTS_PER_TASK); ++fight)
+        {
+            EncounterFight encounter(options, seed ^ (fight * 0x9E3779B9u), data.stats);
+            while (encounter.Update())
+                data.tickNs.push_back(encounter.GetLastTickNs());
+            data.tickNs.push_back(encounter.GetLastTickNs());
+            digests[fight] = encounter.GetDigest();
+        }
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EncounterStats stats;
+    std::vector<uint32> tickNs;
+    for (EncounterThread const& data : threadData)
+    {
+        stats.Add(data.stats);
+        tickNs.insert(tickNs.end(), data.tickNs.begin(), data.tickNs.end());
+    }
+    uint32 digest = 2166136261u;
+    for (uint32 value : digests)
+        for (uint32 i = 0; i < 4; ++i)
+            digest = (digest ^ ((value >> (i * 8)) & 0xFF)) * 16777619u;
+
+    double simMinutes = double(stats.duration) / 60000.0;
+    double cpuSeconds = elapsed.count() * threads; //upper bound if threads were idle
+    double aiNs = double(stats.bossNs + stats.carverNs);
+    double count = double(stats.fights);
+    uint64 maxTick = tickNs.empty() ? 0 : *std::max_element(tickNs.begin(), tickNs.end());
+
+    std::printf("\nsimulated %.1f fight minutes (%.2f min/fight, %llu cut off) in %.3f s wall, %.0fx real time per thread\n",
+        simMinutes, simMinutes / count, (unsigned long long)stats.cutOff, elapsed.count(), simMinutes * 60.0 / cpuSeconds);
+    std::printf("per fight minute: boss AI %.1f us, carver AI %.1f us, mock units %.1f us\n",
+        double(stats.bossNs) / simMinutes * 0.001, double(stats.carverNs) / simMinutes * 0.001, double(stats.mockNs) / simMinutes * 0.001);
+    std::printf("per tick (AI): mean %.0f ns, p50 %u ns, p99 %u ns, p99.9 %u ns, max %llu ns over %llu ticks\n",
+        aiNs / double(std::max<uint64>(stats.ticks, 1)), GetPercentile(tickNs, 0.5), GetPercentile(tickNs, 0.99),
+        GetPercentile(tickNs, 0.999), (unsigned long long)maxTick, (unsigned long long)stats.ticks);
+
+    std::printf("\n%-18s %10s %12s %10s %8s\n", "event", "per fight", "ns/event", "us/fight", "share");
+    for (uint32 e = 1; e < MAX_RUNEWORDER_EVENTS; ++e)
+    {
+        if (!stats.events[e])
+            continue;
+        std::printf("%-18s %10.2f %12.0f %10.2f %7.1f%%\n", RuneworderEventNames[e], double(stats.events[e]) / count,
+            double(stats.eventNs[e]) / double(stats.events[e]), double(stats.eventNs[e]) / count * 0.001,
+            100.0 * double(stats.eventNs[e]) / std::max(double(stats.bossNs), 1.0));
+    }
+
+    std::printf("\nper fight: %.2f runes (%.1f%% withdrawal), %.2f runewords, %.1f points, %.1f flames, %.1f swings, %.2f incinerates, "
+        "%.2f threat switches, %.2f thorns\n", double(stats.carvings) / count,
+        100.0 * double(stats.invalidRunes) / double(std::max<uint64>(stats.carvings, 1)), double(stats.runewords) / count,
+        double(stats.pointsSummoned) / count, double(stats.flames) / count, double(stats.meleeSwings) / count,
+        double(stats.incinerates) / count, double(stats.threatSwitches) / count, double(stats.thorns) / count);
+    if (stats.frenzies)
+        std::printf("frenzy in %.1f%% of fights, at %.2f min on average\n", 100.0 * double(stats.frenzies) / count,
+            double(stats.frenzyTime) / double(stats.frenzies) / 60000.0);
+    std::printf("digest %08x\n", digest);
+    return 0;
+}
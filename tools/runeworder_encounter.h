@@ -0,0 +1,665 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_ENCOUNTER_H
+#define RUNEWORDER_ENCOUNTER_H
+
+//Headless encounter
+//boss_runeworderAI and npc_rune_carverAI need the game core, so EncounterFight runs their event handlers
+//and timers (RuneworderEncounterAI and RuneCarverEncounterAI, boss_runeworder_encounter.h) on mock units
+//and a virtual clock, and calls the module code they call: RunePointSampler, RunePathSimplifier, stroke
+//classification, rune matching and roll, runeword candidates. Spell data is not in the tree: aura durations, swing timer
+//and creature speeds are options, spells without a cast time here are instant, target spells only
+//land. A fight is deterministic for a given seed.
+
+#include "runeworder_trajectory.h"
+#include <array>
+#include <chrono>
+#include <map>
+
+constexpr float ENCOUNTER_MELEE_RANGE = 5.f;
+constexpr float ENCOUNTER_SELECT_RANGE = 50.f; //SelectTarget(Random, 0, 50.f)
+constexpr float ENCOUNTER_CARVER_RANGE = 40.f; //SelectTarget(MaxDistance, 0, 40.f, true)
+
+constexpr char const* RuneworderEventNames[MAX_RUNEWORDER_EVENTS] =
+{
+    "", "carver", "point_put", "rune_assemble", "points_unsummon", "runeword_assemble", "frenzy", "rain_of_fire", "incinerate",
+    "enigma_teleport"
+};
+
+struct EncounterOptions
+{
+    uint32 tick = 100;                  //map update diff, ms
+    uint32 players = 10;                //first one tanks
+    MovementStyles tankStyle = MOVEMENT_STAND;
+    MovementStyles style = MAX_MOVEMENT_STYLES; //of the others, all styles in turn if MAX_MOVEMENT_STYLES
+    float playerSpeed = TRAJECTORY_RUN_SPEED;
+    float carverSpeedRate = 1.f;        //speed_run of NPC_RUNE_CARVER_STALKER
+    float bossWalkRate = 1.f;           //speed_walk of NPC_BOSS_RUNEWORDER
+    float bossRunRate = 1.14286f;       //speed_run of NPC_BOSS_RUNEWORDER
+    uint32 runePoints = DEFAULT_RUNE_POINTS;
+    uint32 budget = UNMATCH_THRESHOLD;
+    float raidDps = 100.f / 360.f;      //boss health percent per second
+    uint32 swingTime = 2000;            //boss melee attack time, ms
+    uint32 runeDuration = 60000;        //rune self auras, ms
+    uint32 runewordDuration = 60000;    //runeword auras, ms
+    uint32 maxDuration = 20 * 60 * 1000; //fight is cut off after this
+
+    float GetPointStep() const { return TRAJECTORY_RUN_SPEED * (POINT_PUT_DELAY * 0.001f) * carverSpeedRate; }
+};
+
+//EventMap: events due at the same time run in scheduling order
+class EncounterEventMap
+{
+public:
+    void Reset()
+    {
+        _events.clear();
+        _time = 0;
+    }
+
+    void Update(uint32 diff) { _time += diff; }
+    void ScheduleEvent(uint32 eventId, uint32 time) { _events.emplace(_time + time, eventId); }
+
+    uint32 ExecuteEvent()
+    {
+        if (_events.empty() || _events.begin()->first > _time)
+            return 0;
+        uint32 eventId = _events.begin()->second;
+        _events.erase(_events.begin());
+        return eventId;
+    }
+
+private:
+    uint32 _time = 0;
+    std::multimap<uint32, uint32> _events;
+};
+
+struct EncounterStats
+{
+    uint64 fights = 0;
+    uint64 duration = 0;        //simulated ms
+    uint64 ticks = 0;
+    uint64 bossNs = 0;          //boss spell hits and UpdateAI
+    uint64 carverNs = 0;        //carver UpdateAI
+    uint64 mockNs = 0;          //movement, auras and damage of the mock units
+    std::array<uint64, MAX_RUNEWORDER_EVENTS> events = { };
+    std::array<uint64, MAX_RUNEWORDER_EVENTS> eventNs = { };
+    uint64 carvings = 0;
+    uint64 invalidRunes = 0;
+    uint64 runewords = 0;
+    uint64 frenzies = 0;
+    uint64 frenzyTime = 0;      //ms into the fight, summed
+    uint64 pointsSummoned = 0;
+    uint64 flames = 0;
+    uint64 meleeSwings = 0;
+    uint64 incinerates = 0;     //out of melee range, not the frenzy event
+    uint64 threatSwitches = 0;
+    uint64 thorns = 0;
+    uint64 cutOff = 0;          //fights that reached maxDuration
+
+    void Add(EncounterStats const& other)
+    {
+        fights += other.fights;
+        duration += other.duration;
+        ticks += other.ticks;
+        bossNs += other.bossNs;
+        carverNs += other.carverNs;
+        mockNs += other.mockNs;
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            events[i] += other.events[i];
+            eventNs[i] += other.eventNs[i];
+        }
+        carvings += other.carvings;
+        invalidRunes += other.invalidRunes;
+        runewords += other.runewords;
+        frenzies += other.frenzies;
+        frenzyTime += other.frenzyTime;
+        pointsSummoned += other.pointsSummoned;
+        flames += other.flames;
+        meleeSwings += other.meleeSwings;
+        incinerates += other.incinerates;
+        threatSwitches += other.threatSwitches;
+        thorns += other.thorns;
+        cutOff += other.cutOff;
+    }
+};
+
+//rune self spell offset of each rune type: variants share the spell, groups are in spell order
+inline std::array<uint8, MAX_RUNE_TYPES> const& GetEncounterRuneSpells()
+{
+    static std::array<uint8, MAX_RUNE_TYPES> const spells = []()
+    {
+        std::array<uint8, MAX_RUNE_TYPES> result = { };
+        std::string last;
+        int32 spell = -1;
+        for (size_t rune = 0; rune < MAX_RUNE_TYPES; ++rune)
+        {
+            std::string name = RuneTypeNames[rune];
+            while (!name.empty() && name.back() >= '0' && name.back() <= '9')
+                name.pop_back();
+            if (name != last)
+                ++spell;
+            last = name;
+            result[rune] = uint8(spell);
+        }
+        return result;
+    }();
+    return spells;
+}
+
+//One fight: boss, carver, point bunnies and players
+class EncounterFight : public RuneworderEncounterAI<EncounterFight, EncounterEventMap, uint32>
+{
+    friend class RuneworderEncounterAI<EncounterFight, EncounterEventMap, uint32>;
+
+public:
+    EncounterFight(EncounterOptions const& options, uint32 seed, EncounterStats& stats) : _options(options), _stats(stats), _rng(seed),
+        _carverAI(*this)
+    {
+        TrajectoryOptions playerOptions;
+        playerOptions.playerSpeed = options.playerSpeed;
+        for (uint32 i = 0; i < std::max(options.players, 1u); ++i)
+        {
+            MovementStyles style = i == 0 ? options.tankStyle :
+                options.style < MAX_MOVEMENT_STYLES ? options.style : MovementStyles((i - 1) % MAX_MOVEMENT_STYLES);
+            _players.emplace_back(style, playerOptions, _rng);
+            _moved.push_back(false);
+        }
+        _runeSpells = &GetEncounterRuneSpells();
+        _speedRate = options.bossRunRate;
+        _runePoints = options.runePoints;
+
+        //JustEngagedWith
+        _ScheduleCombatEvents();
+    }
+
+    //one map update, false once the boss is dead or the fight is cut off
+    bool Update()
+    {
+        uint32 diff = _options.tick;
+        _time += diff;
+        ++_stats.ticks;
+
+        auto start = std::chrono::steady_clock::now();
+        _UpdatePlayers(diff);
+        _UpdateMovement(diff);
+        auto carverStart = std::chrono::steady_clock::now();
+        if (_carverActive)
+            _UpdateCarverAI(diff);
+        auto bossStart = std::chrono::steady_clock::now();
+        _UpdateSpells(diff);
+        _UpdateAI(diff);
+        auto bossEnd = std::chrono::steady_clock::now();
+        _UpdateAuras(diff);
+        _DealRaidDamage(diff);
+        auto end = std::chrono::steady_clock::now();
+
+        uint64 carverNs = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(bossStart - carverStart).count());
+        uint64 bossNs = uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(bossEnd - bossStart).count());
+        _stats.carverNs += carverNs;
+        _stats.bossNs += bossNs;
+        _stats.mockNs += uint64(std::chrono::duration_cast<std::chrono::nanoseconds>((carverStart - start) + (end - bossEnd)).count());
+        _lastTickNs = uint32(std::min<uint64>(carverNs + bossNs, UINT32_MAX));
+
+        if (_health > 0.f && _time < _options.maxDuration)
+            return true;
+
+        ++_stats.fights;
+        _stats.duration += _time;
+        _stats.cutOff += _health > 0.f;
+        return false;
+    }
+
+    //boss and carver AI of the last tick
+    uint32 GetLastTickNs() const { return _lastTickNs; }
+    //FNV-1a of the executed events and their times
+    uint32 GetDigest() const { return _digest; }
+
+private:
+    struct EncounterAura
+    {
+        uint32 stacks = 0;
+        uint32 duration = 0;
+    };
+
+    struct EncounterCast
+    {
+        uint32 spellId = 0;
+        uint32 target = 0;
+        uint32 remaining = 0;
+    };
+
+    //npc_rune_carverAI of the summoned carver
+    class EncounterCarverAI : public RuneCarverEncounterAI<EncounterCarverAI, EncounterEventMap, uint32>
+    {
+        friend class RuneCarverEncounterAI<EncounterCarverAI, EncounterEventMap, uint32>;
+
+    public:
+        explicit EncounterCarverAI(EncounterFight& fight) : _fight(fight) { }
+
+        //IsSummonedBy
+        void Summoned()
+        {
+            _events.Reset();
+            _ScheduleCarverEvents();
+        }
+
+        void Update(uint32 diff, uint32 victim)
+        {
+            _events.Update(diff);
+            while (uint32 eventId = _events.ExecuteEvent())
+                _ExecuteEncounterEvent(eventId, victim);
+        }
+
+    private:
+        bool _IsStandingInMelee(uint32 victim) const
+        {
+            return !_fight._moved[victim] && _fight._GetDistance(_fight._carverX, _fight._carverY, victim) <= ENCOUNTER_MELEE_RANGE;
+        }
+
+        void _CastFlames() { ++_fight._stats.flames; }
+
+        EncounterFight& _fight;
+    };
+
+    uint32 _Urand(uint32 min, uint32 max) { return std::uniform_int_distribution<uint32>(min, max)(_rng); }
+
+    float _GetDistance(float x, float y, uint32 player) const
+    {
+        float dx = _players[player].GetPositionX() - x, dy = _players[player].GetPositionY() - y;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    //SelectTarget(Random, 0, range)
+    bool _SelectRandomTarget(float range, uint32& target)
+    {
+        uint32 count = 0;
+        for (uint32 i = 0; i < _players.size(); ++i)
+            count += _GetDistance(_x, _y, i) <= range;
+        if (!count)
+            return false;
+        uint32 pick = _Urand(0, count - 1);
+        for (uint32 i = 0; i < _players.size(); ++i)
+            if (_GetDistance(_x, _y, i) <= range && !pick--)
+                target = i;
+        return true;
+    }
+
+    void _UpdatePlayers(uint32 diff)
+    {
+        for (uint32 i = 0; i < _players.size(); ++i)
+        {
+            float x = _players[i].GetPositionX(), y = _players[i].GetPositionY();
+            _players[i].Update(diff, _rng);
+            _moved[i] = x != _players[i].GetPositionX() || y != _players[i].GetPositionY();
+        }
+    }
+
+    static void _MoveTo(float& x, float& y, float destX, float destY, float move, float stopDist)
+    {
+        float dx = destX - x, dy = destY - y;
+        float dist = std::sqrt(dx * dx + dy * dy);
+        if (dist <= stopDist)
+            return;
+        move = std::min(move, dist - stopDist);
+        x += dx / dist * move;
+        y += dy / dist * move;
+    }
+
+    //chase of the boss, MovePoint of the carver
+    void _UpdateMovement(uint32 diff)
+    {
+        float step = TRAJECTORY_RUN_SPEED * diff * 0.001f;
+        if (!_cast.spellId)
+            _MoveTo(_x, _y, _players[_victim].GetPositionX(), _players[_victim].GetPositionY(),
+                step * _speedRate, ENCOUNTER_MELEE_RANGE - 1.f);
+        if (_carverActive)
+            _MoveTo(_carverX, _carverY, _carverDestX, _carverDestY, step * _options.carverSpeedRate, 0.f);
+    }
+
+    //npc_rune_carverAI::UpdateAI
+    void _UpdateCarverAI(uint32 diff)
+    {
+        if (_carverChase < 0)
+        {
+            float farthest = -1.f;
+            for (uint32 i = 0; i < _players.size(); ++i)
+            {
+                float dist = _GetDistance(_x, _y, i);
+                if (dist <= ENCOUNTER_CARVER_RANGE && dist > farthest)
+                {
+                    farthest = dist;
+                    _carverChase = int32(i);
+                }
+            }
+            if (_carverChase < 0)
+                _carverChase = int32(_victim);
+        }
+
+        uint32 victim = uint32(_carverChase);
+        _carverAI.Update(diff, victim);
+
+        _carverDestX = _players[victim].GetPositionX();
+        _carverDestY = _players[victim].GetPositionY();
+    }
+
+    //a second cast fails while one is in progress (SPELL_FAILED_SPELL_IN_PROGRESS)
+    void _DoCast(uint32 spellId, uint32 target, uint32 castTime)
+    {
+        if (_cast.spellId)
+            return;
+        _cast.spellId = spellId;
+        _cast.target = target;
+        _cast.remaining = castTime;
+    }
+
+    //cast progress, SpellHitTarget
+    void _UpdateSpells(uint32 diff)
+    {
+        if (!_cast.spellId)
+            return;
+        if (_cast.remaining > diff)
+        {
+            _cast.remaining -= diff;
+            return;
+        }
+
+        uint32 spellId = _cast.spellId;
+        _cast.spellId = 0;
+        if (spellId == SPELL_LAUNCH_RUNE_CARVER)
+        {
+            //SummonCreature(NPC_RUNE_CARVER_STALKER, *target), IsSummonedBy
+            _carverActive = true;
+            _carverX = _carverDestX = _players[_cast.target].GetPositionX();
+            _carverY = _carverDestY = _players[_cast.target].GetPositionY();
+            _carverChase = -1;
+            _carverAI.Summoned();
+        }
+        else if (spellId == SPELL_ACTIVATE_RUNE)
+            _ProcessRune();
+        else if (spellId == SPELL_RUNEWORD)
+            _ProcessRuneword();
+    }
+
+    void _DespawnCarver()
+    {
+        _carverActive = false;
+    }
+
+    void _UnsummonPoints()
+    {
+        _summonedPoints = 0;
+    }
+
+    //boss_runeworderAI::UpdateAI
+    void _UpdateAI(uint32 diff)
+    {
+        _events.Update(diff);
+
+        if (_cast.spellId)
+            return;
+
+        while (uint32 eventId = _events.ExecuteEvent())
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (uint32 value : { _time, eventId })
+                for (uint32 i = 0; i < 4; ++i)
+                    _digest = (_digest ^ ((value >> (i * 8)) & 0xFF)) * 16777619u;
+
+            _ExecuteEncounterEvent(eventId);
+
+            if (eventId < MAX_RUNEWORDER_EVENTS)
+            {
+                ++_stats.events[eventId];
+                _stats.eventNs[eventId] += uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count());
+            }
+        }
+
+        _UpdateEncounterTimers(diff);
+    }
+
+    //RuneworderEncounterAI calls
+    void _Talk(uint32 /*text*/) { }
+
+    //spells with a cast time block the boss, the others land at once; SPELL_FRENZY is the frenzy
+    void _CastSelf(uint32 spellId, bool /*triggered*/)
+    {
+        if (spellId == SPELL_FRENZY)
+        {
+            ++_stats.frenzies;
+            _stats.frenzyTime += _time;
+        }
+        if (uint32 castTime = GetRuneworderCastTime(spellId))
+            _DoCast(spellId, 0, castTime);
+    }
+
+    bool _CastOnRandomTarget(uint32 spellId)
+    {
+        uint32 target = 0;
+        if (!_SelectRandomTarget(ENCOUNTER_SELECT_RANGE, target))
+            return false;
+        if (uint32 castTime = GetRuneworderCastTime(spellId))
+            _DoCast(spellId, target, castTime);
+        return true;
+    }
+
+    bool _HasCarver() const { return _carverActive; }
+
+    void _GetCarverPosition(float& x, float& y) const
+    {
+        x = _carverX;
+        y = _carverY;
+    }
+
+    bool _SummonCarvePoint(float /*x*/, float /*y*/)
+    {
+        ++_summonedPoints;
+        ++_stats.pointsSummoned;
+        return true;
+    }
+
+    size_t _GetCarvePointsCount() const { return _summonedPoints; }
+    float _GetPointStep() const { return _options.GetPointStep(); }
+    bool _HasRunewordType() const { return _runewordType != RUNEWORD_INVALID; }
+    float _GetHealthPct() const { return _health; }
+    void _EnigmaTeleport() { } //SPELL_PERIODIC_TELEPORT_DUMMY is not simulated
+
+    bool _IsVictimInMelee() const { return _GetDistance(_x, _y, _victim) <= ENCOUNTER_MELEE_RANGE; }
+    void _SetWalkSpeed(bool walk) { _speedRate = walk ? _options.bossWalkRate : _options.bossRunRate; }
+
+    //DoMeleeAttackIfReady
+    void _MeleeAttack(uint32 diff)
+    {
+        if (_swingTimer <= diff)
+        {
+            ++_stats.meleeSwings;
+            _swingTimer = _options.swingTime;
+        }
+        else
+            _swingTimer -= diff;
+    }
+
+    float _GetVictimDistance() const { return _GetDistance(_x, _y, _victim); }
+
+    //SelectNearestTargetInAttackDistance(14), threat moved to it
+    bool _SwitchToNearestTarget()
+    {
+        float nearest = 14.f;
+        int32 target = -1;
+        for (uint32 i = 0; i < _players.size(); ++i)
+        {
+            float dist = _GetDistance(_x, _y, i);
+            if (dist <= nearest)
+            {
+                nearest = dist;
+                target = int32(i);
+            }
+        }
+        if (target < 0)
+            return false;
+        _victim = uint32(target);
+        ++_stats.threatSwitches;
+        return true;
+    }
+
+    void _IncinerateVictim() { ++_stats.incinerates; }
+
+    void _ComputateRuneType()
+    {
+        _carving.summoned = uint32(_summonedPoints);
+        RecognizeTrajectoryCarving(_carving, _carvePath, _options.budget, _rng);
+        _runeType = _carving.rune;
+        ++_stats.carvings;
+    }
+
+    void _AddAura(EncounterAura& aura, uint32 duration)
+    {
+        ++aura.stacks;
+        aura.duration = duration;
+    }
+
+    void _ProcessRune()
+    {
+        uint32 spell;
+        if (_runeType >= MAX_RUNE_TYPES)
+        {
+            //enrage and cast random rune anyway
+            _AddAura(_withdrawal, _options.runeDuration);
+            ++_stats.invalidRunes;
+            spell = _Urand(0, MAX_RUNE_SPELLS - 1);
+        }
+        else
+            spell = (*_runeSpells)[_runeType];
+        _AddAura(_runeAuras[spell], _options.runeDuration);
+    }
+
+    void _ComputateRunewordType()
+    {
+        RuneStacks myRunes = { };
+        uint32 myRunesCount = 0;
+        for (uint32 i = 0; i < MAX_RUNE_SPELLS; ++i)
+        {
+            if (!_runeAuras[i].stacks)
+                continue;
+            AddRuneStacks(myRunes, SPELL_EL_SELF + i, _runeAuras[i].stacks);
+            myRunesCount += _runeAuras[i].stacks;
+        }
+
+        //as the boss, the previous runeword is kept then
+        if (myRunesCount < MIN_RUNEWORD_LENGTH)
+            return;
+
+        _runewordMatches.clear();
+        RunewordRunes.Candidates(myRunes).ForEach([&](size_t i)
+        {
+            if (RunewordPatterns[i].Contains(myRunes) && !_runewordAuras[RunewordPatterns[i].type])
+                _runewordMatches.push_back(RunewordPatterns[i].type);
+        });
+
+        _runewordType = RUNEWORD_INVALID;
+        if (_runewordMatches.empty())
+            return;
+        if (_runewordMatches.size() < 2)
+        {
+            _runewordType = _runewordMatches.front();
+            return;
+        }
+
+        int32 roll = std::uniform_int_distribution<int32>(1, int32(100 * _runewordMatches.size()))(_rng);
+        for (uint32 type : _runewordMatches)
+        {
+            roll -= 100;
+            if (roll <= 0)
+            {
+                _runewordType = type;
+                break;
+            }
+        }
+    }
+
+    void _ProcessRuneword()
+    {
+        if (_runewordType >= MAX_RUNEWORD_TYPES)
+            return;
+
+        ++_stats.runewords;
+        _stats.thorns += _runewordType == RUNEWORD_EDGE;
+        _runewordAuras[_runewordType] = _options.runewordDuration;
+
+        //refresh runeword's runes duration
+        RunewordPattern const& pattern = RunewordPatterns[_runewordType];
+        for (uint8 i = 0; i < pattern.GetSize(); ++i)
+            if (EncounterAura& aura = _runeAuras[pattern.GetRuneSpellList()[i] - SPELL_EL_SELF]; aura.stacks)
+                aura.duration = _options.runewordDuration;
+    }
+
+    void _UpdateAuras(uint32 diff)
+    {
+        for (EncounterAura& aura : _runeAuras)
+        {
+            if (aura.duration > diff)
+                aura.duration -= diff;
+            else
+                aura = EncounterAura();
+        }
+        if (_withdrawal.duration > diff)
+            _withdrawal.duration -= diff;
+        else
+            _withdrawal = EncounterAura();
+        for (uint32& duration : _runewordAuras)
+            duration = duration > diff ? duration - diff : 0;
+    }
+
+    //DamageTaken: unkillable while ZOD is active
+    void _DealRaidDamage(uint32 diff)
+    {
+        float damage = _options.raidDps * diff * 0.001f;
+        if (damage >= _health && _runeAuras[SPELL_ZOD_SELF - SPELL_EL_SELF].stacks)
+            damage = _health - 0.001f;
+        _health = std::max(_health - damage, 0.f);
+    }
+
+    EncounterOptions const& _options;
+    EncounterStats& _stats;
+    std::mt19937 _rng;
+    std::array<uint8, MAX_RUNE_TYPES> const* _runeSpells;
+
+    std::vector<TrajectoryPlayer> _players;
+    std::vector<bool> _moved;
+    uint32 _time = 0;
+    uint32 _lastTickNs = 0;
+    uint32 _digest = 2166136261u;
+
+    //boss
+    float _x = 0.f;
+    float _y = 0.f;
+    float _health = 100.f;
+    uint32 _victim = 0;
+    EncounterCast _cast;
+    uint32 _runeType = RUNE_INVALID;
+    uint32 _runewordType = RUNEWORD_INVALID;
+    uint32 _swingTimer = 0;
+    float _speedRate;
+    TrajectoryCarving _carving;
+    size_t _summonedPoints = 0;
+    std::vector<uint32> _runewordMatches;
+    std::array<EncounterAura, MAX_RUNE_SPELLS> _runeAuras = { };
+    EncounterAura _withdrawal;
+    std::array<uint32, MAX_RUNEWORD_TYPES> _runewordAuras = { };
+
+    //carver
+    bool _carverActive = false;
+    float _carverX = 0.f;
+    float _carverY = 0.f;
+    float _carverDestX = 0.f;
+    float _carverDestY = 0.f;
+    int32 _carverChase = -1;
+    EncounterCarverAI _carverAI;
+};
+
+#endif
@@ -0,0 +1,489 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Differential fuzzer of the rune and runeword matchers
+//Every input goes through the frozen reference (RunePattern::MatchesReference, the slot-marking runeword
+//check) and through the engines the boss uses: Matches, MatchesEncoded, the specialized matchers, the
+//candidate indexes and RunewordPattern::Contains. The first divergence is reported with its input.
+//Strokes are arbitrary: any type including NO_STROKE, reversed or not (lines can not be).
+//Input bytes: first byte selects strokes (even) or runes (odd), then one stroke or rune per byte.
+//Built with -fsanitize=fuzzer (RUNEWORDER_LIBFUZZER) it is a libFuzzer target, otherwise:
+//usage: runeworder_fuzz [--exhaustive max length] [--classes max length] [--class-limit N] [--random count] [--threads N] [input files...]
+//--classes checks each pattern alone on every sequence of the stroke classes its reference can tell apart,
+//which reaches lengths the 14 symbols can not
+//input files are replayed (AFL: runeworder_fuzz @@)
+
+#include "boss_runeworder_matchers.h"
+#include "runeworder_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+
+namespace
+{
+
+constexpr uint32 FUZZ_STROKE_SYMBOLS = 14; //every stroke type, reversed too except lines
+constexpr uint32 FUZZ_RUNE_SYMBOLS = MAX_RUNE_SPELLS + 1; //every rune and a spell that is not one
+
+constexpr Stroke GetFuzzStroke(uint32 symbol)
+{
+    if (symbol <= TURN_SHARP)
+        return Stroke(uint8(symbol), false);
+    symbol -= TURN_SHARP + 1;
+    return Stroke(symbol ? uint8(symbol + CURVE_L - 1) : uint8(NO_STROKE), true);
+}
+
+constexpr RuneworderSpells GetFuzzRune(uint32 symbol)
+{
+    return symbol < MAX_RUNE_SPELLS ? RuneworderSpells(SPELL_EL_SELF + symbol) : SPELL_STEEL;
+}
+
+//MatchesReference needs the sequence size at compile time
+typedef bool (*RuneReferenceFunc)(Stroke const* compSeq, RunePattern const& pattern);
+
+template<size_t N>
+bool MatchesReferenceN(Stroke const* compSeq, RunePattern const& pattern)
+{
+    std::array<Stroke, N> const seq = [&]<size_t... I>(std::index_sequence<I...>) { return std::array<Stroke, N>{ compSeq[I]... }; }(std::make_index_sequence<N>());
+    return RunePattern::MatchesReference(seq, pattern);
+}
+
+template<size_t... N>
+constexpr std::array<RuneReferenceFunc, sizeof...(N)> BuildRuneReferences(std::index_sequence<N...>)
+{
+    return { &MatchesReferenceN<N>... };
+}
+
+constexpr std::array<RuneReferenceFunc, MAX_RUNE_SEQUENCE_LENGTH + 1> RuneReferences =
+    BuildRuneReferences(std::make_index_sequence<MAX_RUNE_SEQUENCE_LENGTH + 1>());
+
+//RunewordPattern::Contains before rune stacks, an entry now fills a single slot (repeated runes need as many)
+bool RunewordContainsReference(RunewordPattern const& pattern, RuneSpellVec const& compSeq)
+{
+    if (pattern.size > compSeq.size())
+        return false; //impossible
+
+    std::vector<std::pair<uint32, bool>> s(pattern.size);
+    for (size_t i = 0; i < s.size(); ++i)
+        s[i] = { pattern.runeSpellList[i], false };
+
+    for (size_t i = 0; i < compSeq.size(); ++i)
+    {
+        for (size_t j = 0; j < s.size(); ++j)
+        {
+            if (!s[j].second && s[j].first == compSeq[i])
+            {
+                s[j].second = true;
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < s.size(); ++i)
+        if (!s[i].second)
+            return false;
+    return true;
+}
+
+std::string GetStrokesText(Stroke const* compSeq, size_t size)
+{
+    constexpr char letters[] = "-IVLMHCS";
+    std::string text;
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (i)
+            text += ' ';
+        text += letters[compSeq[i].type & 7];
+        if (compSeq[i].reverse)
+            text += "/r";
+    }
+    return text;
+}
+
+std::mutex ReportLock;
+std::atomic<bool> Diverged = false;
+
+void ReportDivergence(char const* engine, char const* pattern, std::string const& input, bool expected, bool got)
+{
+    std::lock_guard<std::mutex> lock(ReportLock);
+    if (Diverged.exchange(true))
+        return;
+    std::fprintf(stderr, "divergence: %s on %s, input [%s]: reference %s, engine %s\n", engine, pattern, input.c_str(),
+        expected ? "match" : "no match", got ? "match" : "no match");
+}
+
+bool SameScore(RuneMatchScore const& a, RuneMatchScore const& b)
+{
+    return a.errors == b.errors && a.offset == b.offset && a.coverage == b.coverage && a.reversed == b.reversed;
+}
+
+//false on a divergence of any engine on one pattern
+bool CheckPattern(size_t i, Stroke const* compSeq, size_t size, RuneEncodedSequence const& encoded, RunePatternBits const& candidates)
+{
+    RunePattern const& pattern = RunePatterns[i];
+    bool expected = RuneReferences[size](compSeq, pattern);
+    char const* failed = nullptr;
+    bool got = expected;
+
+    RuneMatchScore score, encodedScore, specializedScore;
+    if ((got = pattern.Matches(compSeq, size)) != expected)
+        failed = "Matches";
+    else if ((got = pattern.Matches(compSeq, size, score)) != expected)
+        failed = "Matches with score";
+    else if ((got = pattern.MatchesEncoded(encoded, encodedScore)) != expected || (got && !SameScore(score, encodedScore)))
+        failed = "MatchesEncoded";
+    else if ((got = RuneMatchers[i](encoded, specializedScore)) != expected || (got && !SameScore(score, specializedScore)))
+        failed = "specialized matcher";
+    else if (expected && !(got = candidates.Test(i)))
+        failed = "candidate index";
+
+    if (failed)
+    {
+        ReportDivergence(failed, RuneTypeNames[i], GetStrokesText(compSeq, size), expected, got);
+        return false;
+    }
+    return true;
+}
+
+//false on the first divergence
+bool CheckStrokes(Stroke const* compSeq, size_t size)
+{
+    if (size > MAX_RUNE_SEQUENCE_LENGTH)
+        size = MAX_RUNE_SEQUENCE_LENGTH;
+
+    RuneEncodedSequence encoded;
+    EncodeRuneSequence(compSeq, size, encoded);
+    RunePatternBits candidates = RuneCandidates.Candidates(Strokes(compSeq, compSeq + size));
+    for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+        if (!CheckPattern(i, compSeq, size, encoded, candidates))
+            return false;
+    return true;
+}
+
+bool CheckRunes(RuneSpellVec const& spells)
+{
+    RuneStacks stacks = { };
+    for (RuneworderSpells spell : spells)
+        AddRuneStacks(stacks, spell, 1);
+    RunePatternBits candidates = RunewordRunes.Candidates(stacks);
+
+    for (size_t i = 0; i < MAX_RUNEWORD_TYPES; ++i)
+    {
+        RunewordPattern const& pattern = RunewordPatterns[i];
+        bool expected = RunewordContainsReference(pattern, spells);
+        char const* failed = nullptr;
+        bool got = expected;
+        if ((got = pattern.Contains(spells)) != expected)
+            failed = "Contains";
+        else if (expected && !(got = candidates.Test(i)))
+            failed = "runeword index";
+        //stacks only count runes, the entry count check is Contains(RuneSpellVec) only
+        else if (pattern.size <= spells.size() && (got = pattern.Contains(stacks)) != expected)
+            failed = "Contains (stacks)";
+
+        if (failed)
+        {
+            std::string input;
+            for (RuneworderSpells spell : spells)
+            {
+                if (!input.empty())
+                    input += ' ';
+                input += std::to_string(uint32(spell));
+            }
+            ReportDivergence(failed, RunewordTypeNames[i], input, expected, got);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CheckInput(uint8 const* data, size_t size)
+{
+    if (!size)
+        return true;
+
+    if (!(data[0] & 1))
+    {
+        Strokes strokes;
+        for (size_t i = 1; i < size && strokes.size() < MAX_RUNE_SEQUENCE_LENGTH; ++i)
+            strokes.push_back(GetFuzzStroke(data[i] % FUZZ_STROKE_SYMBOLS));
+        return CheckStrokes(strokes.data(), strokes.size());
+    }
+
+    RuneSpellVec spells;
+    for (size_t i = 1; i < size && spells.size() < 4 * MAX_RUNEWORD_LENGTH; ++i)
+        spells.push_back(GetFuzzRune(data[i] % FUZZ_RUNE_SYMBOLS));
+    return CheckRunes(spells);
+}
+
+}
+
+#ifdef RUNEWORDER_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(uint8 const* data, size_t size)
+{
+    if (!CheckInput(data, size))
+        std::abort();
+    return 0;
+}
+
+#else
+
+namespace
+{
+
+constexpr uint64 FUZZ_TASK_SEQUENCES = 4096;
+constexpr uint64 FUZZ_CLASS_SEQUENCES = 1 << 24; //default limit per pattern and length of --classes
+
+uint64 GetSequenceCount(uint32 symbols, size_t length)
+{
+    uint64 count = 1;
+    for (size_t i = 0; i < length; ++i)
+        count *= symbols;
+    return count;
+}
+
+//every stroke sequence and every rune multiset up to maxLength
+uint64 RunExhaustive(size_t maxLength, uint32 threads)
+{
+    std::atomic<uint64> checked = 0;
+    for (size_t length = 0; length <= maxLength && !Diverged; ++length)
+    {
+        uint64 count = GetSequenceCount(FUZZ_STROKE_SYMBOLS, length);
+        WorkStealingPool::Run(uint32((count + FUZZ_TASK_SEQUENCES - 1) / FUZZ_TASK_SEQUENCES), threads, [&](uint32 task, uint32)
+        {
+            Strokes strokes(length, Stroke(NO_STROKE, false));
+            for (uint64 n = task * FUZZ_TASK_SEQUENCES; n < std::min(count, (task + 1) * FUZZ_TASK_SEQUENCES) && !Diverged; ++n)
+            {
+                uint64 number = n;
+                for (size_t i = 0; i < length; ++i, number /= FUZZ_STROKE_SYMBOLS)
+                    strokes[i] = GetFuzzStroke(uint32(number % FUZZ_STROKE_SYMBOLS));
+                CheckStrokes(strokes.data(), length);
+            }
+            checked += std::min(count, (task + 1) * FUZZ_TASK_SEQUENCES) - task * FUZZ_TASK_SEQUENCES;
+        });
+    }
+
+    //non-decreasing rune lists are the multisets
+    for (size_t length = 1; length <= std::min(maxLength, MAX_RUNEWORD_LENGTH) && !Diverged; ++length)
+    {
+        std::vector<uint32> symbols(length, 0);
+        RuneSpellVec spells(length);
+        for (;;)
+        {
+            for (size_t i = 0; i < length; ++i)
+                spells[i] = GetFuzzRune(symbols[i]);
+            if (!CheckRunes(spells))
+                break;
+            ++checked;
+
+            size_t i = length;
+            while (i > 0 && symbols[i - 1] == FUZZ_RUNE_SYMBOLS - 1)
+                --i;
+            if (!i)
+                break;
+            ++symbols[i - 1];
+            std::fill(symbols.begin() + i, symbols.end(), symbols[i - 1]);
+        }
+    }
+    return checked;
+}
+
+//strokes the reference can not tell apart on a pattern: accepted by the same slots, same reverse flag and
+//same answer to its line test (it compares the type to ST_LINE and ST_LINE_REV, so LINE_REV and CURVE_M)
+std::vector<Strokes> GetReferenceClasses(RunePattern const& pattern)
+{
+    std::map<uint32, Strokes> classes;
+    for (uint32 symbol = 0; symbol < FUZZ_STROKE_SYMBOLS; ++symbol)
+    {
+        Stroke stroke = GetFuzzStroke(symbol);
+        uint32 signature = (stroke.reverse ? 1 : 0) | (stroke.type == ST_LINE || stroke.type == ST_LINE_REV ? 2 : 0);
+        for (uint8 k = 0; k < pattern.size; ++k)
+            if (pattern.strokeSequence[k] & (1 << stroke.type))
+                signature |= 4 << k;
+        classes[signature].push_back(stroke);
+    }
+
+    std::vector<Strokes> result;
+    for (auto const& [signature, strokes] : classes)
+        result.push_back(strokes);
+    return result;
+}
+
+//every sequence of each pattern's reference classes up to maxLength, each stroke taken in turn from its class
+//so the engines see all members; a pattern stops before the first length of more than limit sequences
+uint64 RunClasses(size_t maxLength, uint64 limit, uint32 threads)
+{
+    std::atomic<uint64> checked = 0;
+    size_t shortest = maxLength, complete = 0;
+    for (size_t p = 0; p < MAX_RUNE_TYPES && !Diverged; ++p)
+    {
+        std::vector<Strokes> const classes = GetReferenceClasses(RunePatterns[p]);
+        uint32 symbols = uint32(classes.size());
+        size_t length = 1;
+        for (; length <= maxLength && GetSequenceCount(symbols, length) <= limit && !Diverged; ++length)
+        {
+            uint64 count = GetSequenceCount(symbols, length);
+            WorkStealingPool::Run(uint32((count + FUZZ_TASK_SEQUENCES - 1) / FUZZ_TASK_SEQUENCES), threads, [&](uint32 task, uint32)
+            {
+                Strokes strokes(length, Stroke(NO_STROKE, false));
+                for (uint64 n = task * FUZZ_TASK_SEQUENCES; n < std::min(count, (task + 1) * FUZZ_TASK_SEQUENCES) && !Diverged; ++n)
+                {
+                    uint64 number = n;
+                    for (size_t i = 0; i < length; ++i, number /= symbols)
+                    {
+                        Strokes const& members = classes[number % symbols];
+                        strokes[i] = members[(n + i) % members.size()];
+                    }
+                    RuneEncodedSequence encoded;
+                    EncodeRuneSequence(strokes.data(), length, encoded);
+                    CheckPattern(p, strokes.data(), length, encoded, RuneCandidates.Candidates(strokes));
+                }
+                checked += std::min(count, (task + 1) * FUZZ_TASK_SEQUENCES) - task * FUZZ_TASK_SEQUENCES;
+            });
+        }
+        shortest = std::min(shortest, length - 1);
+        complete += length > maxLength;
+    }
+
+    std::printf("classes: %zu of %zu patterns checked on every sequence up to %zu strokes, the rest up to %zu at least\n",
+        complete, size_t(MAX_RUNE_TYPES), maxLength, shortest);
+    return checked;
+}
+
+//input carving a random built-in rune: a stroke of each slot, optional slots dropped at random,
+//then up to two strokes replaced, random strokes around it and read backwards half of the time
+void GetRuneInput(std::mt19937& rng, std::vector<uint8>& input)
+{
+    RunePattern const& pattern = RunePatterns[rng() % MAX_RUNE_TYPES];
+    std::vector<uint8> symbols;
+    for (uint8 k = 0; k < pattern.size; ++k)
+    {
+        if ((pattern.strokeSequence[k] & STDEF_CAN_BE_EMPTY) && rng() % 2)
+            continue;
+
+        uint32 symbol = rng() % FUZZ_STROKE_SYMBOLS;
+        for (uint32 s = 0; s < FUZZ_STROKE_SYMBOLS; ++s, symbol = (symbol + 1) % FUZZ_STROKE_SYMBOLS)
+        {
+            Stroke stroke = GetFuzzStroke(symbol);
+            if ((pattern.strokeSequence[k] & (1 << stroke.type)) && (k == 0 || stroke.reverse == bool(pattern.strokeSequence[k] & STDEF_REV)))
+                break;
+        }
+        symbols.push_back(uint8(symbol));
+    }
+
+    for (uint32 m = rng() % 3; m > 0 && !symbols.empty(); --m)
+        symbols[rng() % symbols.size()] = uint8(rng() % FUZZ_STROKE_SYMBOLS);
+    for (uint32 m = rng() % 4; m > 0; --m)
+        symbols.insert(rng() % 2 ? symbols.begin() : symbols.end(), uint8(rng() % FUZZ_STROKE_SYMBOLS));
+    if (rng() % 2)
+        std::reverse(symbols.begin(), symbols.end());
+
+    input.assign(1, 0);
+    input.insert(input.end(), symbols.begin(), symbols.end());
+}
+
+//random inputs, a quarter of them carved runes (uniform strokes rarely match anything)
+uint64 RunRandom(uint64 count, uint32 threads)
+{
+    std::atomic<uint64> checked = 0;
+    WorkStealingPool::Run(uint32((count + FUZZ_TASK_SEQUENCES - 1) / FUZZ_TASK_SEQUENCES), threads, [&](uint32 task, uint32)
+    {
+        std::mt19937 rng(task + 1);
+        std::vector<uint8> input;
+        for (uint64 n = task * FUZZ_TASK_SEQUENCES; n < std::min(count, (task + 1) * FUZZ_TASK_SEQUENCES) && !Diverged; ++n)
+        {
+            if (n % 4 == 0)
+                GetRuneInput(rng, input);
+            else
+            {
+                input.resize(1 + rng() % (n % 2 ? 4 * MAX_RUNEWORD_LENGTH : MAX_RUNE_SEQUENCE_LENGTH + 1));
+                for (uint8& byte : input)
+                    byte = uint8(rng());
+                input[0] = uint8(n % 2);
+            }
+            CheckInput(input.data(), input.size());
+            ++checked;
+        }
+    });
+    return checked;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    size_t exhaustive = 0;
+    size_t classes = 0;
+    uint64 classLimit = FUZZ_CLASS_SEQUENCES;
+    uint64 random = 0;
+    uint32 threads = WorkStealingPool::GetDefaultThreads();
+    std::vector<char const*> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--exhaustive") && i + 1 < argc)
+            exhaustive = std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--classes") && i + 1 < argc)
+            classes = std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--class-limit") && i + 1 < argc)
+            classLimit = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--random") && i + 1 < argc)
+            random = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else
+            files.push_back(argv[i]);
+    }
+
+    if (!exhaustive && !classes && !random && files.empty())
+    {
+        std::fprintf(stderr, "usage: %s [--exhaustive max length] [--classes max length] [--class-limit N] [--random count] "
+            "[--threads N] [input files...]\n", argv[0]);
+        return 1;
+    }
+    if (exhaustive > 6)
+    {
+        std::fprintf(stderr, "exhaustive length is at most 6 (14^6 sequences)\n");
+        return 1;
+    }
+    if (classes > MAX_RUNE_SEQUENCE_LENGTH)
+    {
+        std::fprintf(stderr, "class sequence length is at most %zu\n", MAX_RUNE_SEQUENCE_LENGTH);
+        return 1;
+    }
+
+    uint64 checked = 0;
+    for (char const* fileName : files)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file)
+        {
+            std::fprintf(stderr, "cannot open %s\n", fileName);
+            return 1;
+        }
+        std::vector<uint8> input((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        CheckInput(input.data(), input.size());
+        ++checked;
+    }
+    if (exhaustive)
+        checked += RunExhaustive(exhaustive, threads);
+    if (classes)
+        checked += RunClasses(classes, classLimit, threads);
+    if (random)
+        checked += RunRandom(random, threads);
+
+    std::printf("%llu inputs checked against the reference, %s\n", (unsigned long long)checked, Diverged ? "DIVERGED" : "no divergence");
+    return Diverged ? 1 : 0;
+}
+
+#endif
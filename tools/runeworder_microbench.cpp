@@ -0,0 +1,108 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Rune pipeline microbenchmarks
+//Times each stage on its own (runeworder_stages.h): carver sampling, GetDegrees, stroke classification,
+//every built-in rune matcher, the full candidate match, runeword resolution and the weighted roll,
+//on realistic and adversarial inputs. Reports ns, heap allocations and, where perf events are
+//available (Linux), cycles, instructions, branch and L1D read misses per op.
+//usage: runeworder_microbench [--inputs N] [--repetitions N] [--filter text] [--json results.json]
+
+#define RUNEWORDER_COUNT_ALLOCATIONS
+#include "runeworder_stages.h"
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+
+void WriteBenchJson(FILE* file, std::vector<BenchResult> const& results, PerfCounters const& counters, uint32 inputs)
+{
+    std::fprintf(file, "{\n  \"benchmark\": \"runeworder_microbench\",\n  \"inputs\": %u,\n  \"compiler\": \"%s\",\n  \"perf_events\": {",
+        inputs, __VERSION__);
+    for (uint32 e = 0; e < MAX_PERF_EVENTS; ++e)
+        std::fprintf(file, "%s\"%s\": %s", e ? ", " : " ", PerfEventNames[e], counters.IsOpen(PerfEvents(e)) ? "true" : "false");
+    std::fprintf(file, " },\n");
+    WriteBenchResults(file, results);
+    std::fprintf(file, "}\n");
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 count = 20000;
+    uint32 repetitions = 1;
+    char const* filter = nullptr;
+    char const* jsonFile = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--inputs") && i + 1 < argc)
+            count = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--repetitions") && i + 1 < argc)
+            repetitions = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+            filter = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc)
+            jsonFile = argv[++i];
+        else
+            count = 0;
+    }
+
+    if (!count)
+    {
+        std::fprintf(stderr, "usage: %s [--inputs N] [--repetitions N] [--filter text] [--json results.json]\n", argv[0]);
+        return 1;
+    }
+
+    BenchInputs realistic = GetRealisticBenchInputs(count);
+    BenchInputs adversarial = GetAdversarialBenchInputs(count);
+    std::vector<BenchStage> stages;
+    AddBenchStages(stages, realistic, "realistic");
+    AddBenchStages(stages, adversarial, "adversarial");
+    AddBenchRuneStages(stages, realistic, "realistic");
+
+    PerfCounters counters;
+    for (uint32 e = 0; e < MAX_PERF_EVENTS; ++e)
+        if (!counters.IsOpen(PerfEvents(e)))
+            std::printf("%s counter unavailable: %s\n", PerfEventNames[e], counters.GetError(PerfEvents(e)));
+
+    std::vector<BenchResult> results;
+    std::printf("%-28s %10s %10s %8s %10s %10s %10s\n", "stage", "ops", "ns/op", "allocs", "cycles", "instrs", "br-miss");
+    for (BenchStage const& stage : stages)
+    {
+        if (filter && stage.name.find(filter) == std::string::npos)
+            continue;
+
+        BenchResult result = RunBenchStage(stage, counters, 1, repetitions);
+        std::printf("%-28s %10llu %10.1f %8.2f", result.name.c_str(), (unsigned long long)result.ops, result.nanoseconds, result.allocations);
+        for (uint32 e = PERF_CYCLES; e <= PERF_BRANCH_MISSES; ++e)
+        {
+            if (result.events[e] >= 0.0)
+                std::printf(" %10.1f", result.events[e]);
+            else
+                std::printf(" %10s", "-");
+        }
+        std::printf("\n");
+        results.push_back(std::move(result));
+    }
+
+    if (jsonFile)
+    {
+        FILE* file = std::fopen(jsonFile, "w");
+        if (!file)
+        {
+            std::fprintf(stderr, "cannot write %s\n", jsonFile);
+            return 1;
+        }
+        WriteBenchJson(file, results, counters, count);
+        std::fclose(file);
+    }
+
+    for (BenchResult const& result : results)
+        if (result.checksum == ~uint64(0))
+            return 1;
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Offline pattern pack generator
+//Writes the compiled rune and runeword tables into a binary pack (see boss_runeworder_pack.h)
+//usage: runeworder_packgen [--table-length N] [--threads N] [--allow-shadowing] <output.rwpk> [patterns.txt]
+//patterns.txt overrides built-in rune strokes, one rune per line in stroke notation:
+//  # comment
+//  EL1 MH LM CH/r S/r I LM LM
+//--table-length: longest stroke sequence in the exhaustive match table (0: no table, default 6, max 7)
+//--threads: enumeration threads (default: all cores)
+//--allow-shadowing: only warn if a rune matches every canonical of another one (see RuneShadowAllowlist)
+//Every pack rune must match its own canonical sequences, the same check built-in runes pass at compile time.
+
+#include "boss_runeworder_coverage.h"
+#include "boss_runeworder_pack.h"
+#include "runeworder_pool.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace
+{
+
+class PackWriter
+{
+public:
+    template<typename T>
+    uint32 Append(T const* data, size_t count)
+    {
+        while (_buffer.size() % 8)
+            _buffer.push_back(0);
+        uint32 offset = uint32(_buffer.size());
+        uint8 const* bytes = reinterpret_cast<uint8 const*>(data);
+        _buffer.insert(_buffer.end(), bytes, bytes + count * sizeof(T));
+        return offset;
+    }
+
+    template<typename T>
+    void Overwrite(uint32 offset, T const& value)
+    {
+        std::memcpy(_buffer.data() + offset, &value, sizeof(T));
+    }
+
+    std::vector<uint8>& GetBuffer() { return _buffer; }
+
+private:
+    std::vector<uint8> _buffer;
+};
+
+uint32 AddString(std::vector<char>& strings, char const* str)
+{
+    uint32 offset = uint32(strings.size());
+    strings.insert(strings.end(), str, str + std::strlen(str) + 1);
+    return offset;
+}
+
+char const* const ParseErrorNames[] =
+{
+    "ok", "empty pattern", "unknown letter", "duplicate letter", "bad suffix", "unknown combination", "too many strokes"
+};
+
+//rune name -> strokes, same notation and rules as the built-in tables
+bool ReadPatternOverrides(char const* fileName, std::map<std::string, std::vector<StrokeTypeDefs>>& overrides)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        std::fprintf(stderr, "cannot read %s\n", fileName);
+        return false;
+    }
+
+    std::string line;
+    for (uint32 lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        size_t const nameBegin = line.find_first_not_of(" \t\r");
+        if (nameBegin == std::string::npos || line[nameBegin] == '#')
+            continue;
+
+        size_t const nameEnd = std::min(line.find_first_of(" \t", nameBegin), line.size());
+        std::string const name = line.substr(nameBegin, nameEnd - nameBegin);
+        std::string_view const text = std::string_view(line).substr(nameEnd);
+
+        bool known = false;
+        for (char const* runeName : RuneTypeNames)
+            if (name == runeName)
+                known = true;
+        if (!known)
+        {
+            std::fprintf(stderr, "%s:%u: unknown rune %s\n", fileName, lineNumber, name.c_str());
+            return false;
+        }
+
+        std::vector<StrokeTypeDefs> strokes(MAX_RUNE_PATTERN_LENGTH);
+        RuneStrokeParseResult const result = ParseRuneStrokes(text, strokes.data(), strokes.size());
+        if (result.error != RSPE_NONE)
+        {
+            std::string const token(text.substr(result.errorPos, result.errorLen));
+            std::fprintf(stderr, "%s:%u: %s: %s '%s'\n", fileName, lineNumber, name.c_str(), ParseErrorNames[result.error], token.c_str());
+            return false;
+        }
+        if (result.size < MIN_RUNE_PATTERN_LENGTH || (strokes[0] & (STDEF_REV | STDEF_CAN_BE_EMPTY)))
+        {
+            std::fprintf(stderr, "%s:%u: %s: needs %u-%u strokes, first one can not be reversed or empty\n", fileName, lineNumber,
+                name.c_str(), uint32(MIN_RUNE_PATTERN_LENGTH), uint32(MAX_RUNE_PATTERN_LENGTH));
+            return false;
+        }
+
+        strokes.resize(result.size);
+        overrides[name] = std::move(strokes);
+    }
+
+    return true;
+}
+
+struct MatchTable
+{
+    RunePackTable header = { };
+    RuneMatchTableData data;
+};
+
+//exhaustive match table of the pack runes (boss_runeworder_table.h) on all threads
+bool BuildMatchTable(std::vector<RunePattern> const& patterns, uint8 maxLength, uint32 threadCount, MatchTable& table)
+{
+    auto runTasks = [threadCount](uint32 taskCount, auto&& run)
+    {
+        WorkStealingPool::Run(taskCount, threadCount, [&run](uint32 taskIndex, uint32 /*thread*/) { run(taskIndex); });
+    };
+    if (!BuildRuneMatchTable(patterns.data(), patterns.size(), maxLength, runTasks, table.data))
+    {
+        std::fprintf(stderr, "too many distinct match sets, use a shorter table\n");
+        return false;
+    }
+
+    table.header.minLength = table.data.minLength;
+    table.header.maxLength = table.data.maxLength;
+    table.header.setCount = uint16(table.data.sets.size());
+    table.header.matchCount = uint32(table.data.matchSets.size());
+
+    std::printf("match table: %llu sequences (%u-%u strokes), %u matched, %u match sets\n",
+        (unsigned long long)GetRuneTableBase(table.data.minLength, table.data.maxLength + 1),
+        uint32(table.data.minLength), uint32(table.data.maxLength), table.header.matchCount, uint32(table.header.setCount));
+    return true;
+}
+
+//canonical coverage and shadowing of the pack runes (boss_runeworder_coverage.h)
+bool CheckRuneCoverage(std::vector<RunePattern> const& patterns, bool allowShadowing)
+{
+    RuneCandidateIndex const candidates = BuildCandidateIndex(patterns.data(), patterns.size());
+    bool valid = true;
+    for (size_t i = 0; i < patterns.size(); ++i)
+    {
+        RunePattern const& pattern = patterns[i];
+        if (!TestRuneCanonicals(pattern, i, candidates))
+        {
+            std::fprintf(stderr, "%s does not match its own canonical sequences\n", RuneTypeNames[pattern.type]);
+            valid = false;
+        }
+
+        GetRuneShadowing(patterns.data(), patterns.size(), i).ForEach([&](size_t other)
+        {
+            if (IsRuneShadowAllowed(RuneTypes(patterns[other].type), RuneTypes(pattern.type)))
+                return;
+            std::fprintf(stderr, "%s: %s matches every canonical of %s, %s can never win alone\n", allowShadowing ? "warning" : "error",
+                RuneTypeNames[patterns[other].type], RuneTypeNames[pattern.type], RuneTypeNames[pattern.type]);
+            valid &= allowShadowing;
+        });
+    }
+    return valid;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint32 tableLength = DEFAULT_RUNE_TABLE_LENGTH;
+    uint32 threadCount = WorkStealingPool::GetDefaultThreads();
+    bool allowShadowing = false;
+    std::vector<char const*> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--table-length") && i + 1 < argc)
+            tableLength = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threadCount = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--allow-shadowing"))
+            allowShadowing = true;
+        else
+            args.push_back(argv[i]);
+    }
+
+    if ((args.size() != 1 && args.size() != 2) || (tableLength && (tableLength < MIN_RUNE_PATTERN_LENGTH || tableLength > MAX_RUNE_TABLE_LENGTH)))
+    {
+        std::fprintf(stderr, "usage: %s [--table-length 0|%u-%u] [--threads N] [--allow-shadowing] <output file> [patterns file]\n", argv[0],
+            uint32(MIN_RUNE_PATTERN_LENGTH), uint32(MAX_RUNE_TABLE_LENGTH));
+        return 1;
+    }
+
+    std::map<std::string, std::vector<StrokeTypeDefs>> overrides;
+    if (args.size() == 2 && !ReadPatternOverrides(args[1], overrides))
+        return 1;
+
+    std::vector<RunePackRune> runes;
+    std::vector<RunePackRuneword> runewords;
+    std::vector<uint16> masks;
+    std::vector<uint32> spells;
+    std::vector<char> strings;
+
+    for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+    {
+        RunePattern const& pattern = RunePatterns[i];
+        std::vector<StrokeTypeDefs> strokes(pattern.strokeSequence, pattern.strokeSequence + pattern.size);
+        auto itr = overrides.find(RuneTypeNames[pattern.type]);
+        if (itr != overrides.end())
+            strokes = itr->second;
+
+        RunePackRune rune = { };
+        rune.type = pattern.type;
+        rune.size = uint8(strokes.size());
+        rune.minSize = 0;
+        for (StrokeTypeDefs stroke : strokes)
+            if (!(stroke & STDEF_CAN_BE_EMPTY))
+                ++rune.minSize;
+        rune.maskIndex = uint32(masks.size());
+        rune.nameOffset = AddString(strings, RuneTypeNames[pattern.type]);
+        masks.insert(masks.end(), strokes.begin(), strokes.end());
+        runes.push_back(rune);
+    }
+
+    for (size_t i = 0; i < MAX_RUNEWORD_TYPES; ++i)
+    {
+        RunewordPattern const& pattern = RunewordPatterns[i];
+        RunePackRuneword runeword = { };
+        runeword.type = uint8(pattern.type);
+        runeword.size = uint8(pattern.size);
+        runeword.spellIndex = uint32(spells.size());
+        runeword.nameOffset = AddString(strings, RunewordTypeNames[pattern.type]);
+        spells.insert(spells.end(), pattern.runeSpellList, pattern.runeSpellList + pattern.size);
+        runewords.push_back(runeword);
+    }
+
+    //match table is built over the pack's own rune order
+    std::vector<RunePattern> patterns;
+    patterns.reserve(runes.size());
+    for (RunePackRune const& rune : runes)
+        patterns.emplace_back(rune.type, reinterpret_cast<StrokeTypeDefs const*>(masks.data() + rune.maskIndex), rune.size, rune.minSize);
+
+    if (!CheckRuneCoverage(patterns, allowShadowing))
+        return 1;
+
+    MatchTable table;
+    if (tableLength && !BuildMatchTable(patterns, uint8(tableLength), threadCount, table))
+        return 1;
+
+    PackWriter writer;
+    RunePackHeader header = { };
+    writer.Append(&header, 1);
+    header.magic = RUNEPACK_MAGIC;
+    header.version = RUNEPACK_VERSION;
+    header.headerSize = sizeof(RunePackHeader);
+    header.runeCount = uint32(runes.size());
+    header.runeOffset = writer.Append(runes.data(), runes.size());
+    header.runewordCount = uint32(runewords.size());
+    header.runewordOffset = writer.Append(runewords.data(), runewords.size());
+    header.maskCount = uint32(masks.size());
+    header.maskOffset = writer.Append(masks.data(), masks.size());
+    header.spellCount = uint32(spells.size());
+    header.spellOffset = writer.Append(spells.data(), spells.size());
+    header.stringsSize = uint32(strings.size());
+    header.stringsOffset = writer.Append(strings.data(), strings.size());
+    if (tableLength)
+    {
+        header.tableOffset = writer.Append(&table.header, 1);
+        table.header.wordsOffset = writer.Append(table.data.words.data(), table.data.words.size());
+        table.header.ranksOffset = writer.Append(table.data.ranks.data(), table.data.ranks.size());
+        table.header.matchSetsOffset = writer.Append(table.data.matchSets.data(), table.data.matchSets.size());
+        table.header.setsOffset = writer.Append(table.data.sets.data(), table.data.sets.size());
+        writer.Overwrite(header.tableOffset, table.header);
+    }
+
+    std::vector<uint8>& buffer = writer.GetBuffer();
+    while (buffer.size() % 8)
+        buffer.push_back(0);
+    header.fileSize = uint32(buffer.size());
+    header.checksum = RunePackChecksum(buffer.data() + sizeof(RunePackHeader), buffer.size() - sizeof(RunePackHeader));
+    writer.Overwrite(0, header);
+
+    FILE* file = std::fopen(args[0], "wb");
+    if (!file || std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size())
+    {
+        std::fprintf(stderr, "cannot write %s\n", args[0]);
+        if (file)
+            std::fclose(file);
+        return 1;
+    }
+    std::fclose(file);
+
+    std::printf("%s: %u runes (%u overridden), %u runewords, %u bytes\n", args[0], header.runeCount, uint32(overrides.size()),
+        header.runewordCount, header.fileSize);
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_PERF_H
+#define RUNEWORDER_PERF_H
+
+//Hardware event and heap allocation counters shared by the benchmarks
+
+#include "Define.h"
+#include <array>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+enum PerfEvents
+{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_READ_MISSES,
+    MAX_PERF_EVENTS
+};
+
+constexpr char const* PerfEventNames[MAX_PERF_EVENTS] = { "cycles", "instructions", "branch_misses", "l1d_read_misses" };
+
+//One hardware event of this thread (perf_event_open), unavailable without a PMU or with perf_event_paranoid > 2
+class PerfCounter
+{
+public:
+    PerfCounter() { }
+    explicit PerfCounter(PerfEvents event) { Open(event); }
+    PerfCounter(PerfCounter const&) = delete;
+    PerfCounter& operator=(PerfCounter const&) = delete;
+
+    ~PerfCounter()
+    {
+#ifdef __linux__
+        if (_fd >= 0)
+            close(_fd);
+#endif
+    }
+
+    void Open(PerfEvents event)
+    {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        switch (event)
+        {
+            case PERF_CYCLES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PERF_INSTRUCTIONS:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PERF_BRANCH_MISSES:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            default:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+        }
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        _error = _fd < 0 ? std::strerror(errno) : nullptr;
+#else
+        (void)event;
+#endif
+    }
+
+    bool IsOpen() const { return _fd >= 0; }
+    char const* GetError() const { return _error; }
+
+    void Start()
+    {
+#ifdef __linux__
+        if (_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    uint64 Stop()
+    {
+        uint64 count = 0;
+#ifdef __linux__
+        if (_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(_fd, &count, sizeof(count)) != sizeof(count))
+                count = 0;
+        }
+#endif
+        return count;
+    }
+
+private:
+    int _fd = -1;
+    char const* _error = "not supported on this platform";
+};
+
+//All events, counts are -1 for unavailable ones
+class PerfCounters
+{
+public:
+    typedef std::array<double, MAX_PERF_EVENTS> Counts;
+
+    PerfCounters()
+    {
+        for (uint32 i = 0; i < MAX_PERF_EVENTS; ++i)
+            _counters[i].Open(PerfEvents(i));
+    }
+
+    bool IsOpen(PerfEvents event) const { return _counters[event].IsOpen(); }
+    char const* GetError(PerfEvents event) const { return _counters[event].GetError(); }
+
+    void Start()
+    {
+        for (PerfCounter& counter : _counters)
+            counter.Start();
+    }
+
+    Counts Stop()
+    {
+        Counts counts;
+        for (uint32 i = MAX_PERF_EVENTS; i-- > 0;)
+            counts[i] = _counters[i].IsOpen() ? double(_counters[i].Stop()) : -1.0;
+        return counts;
+    }
+
+private:
+    std::array<PerfCounter, MAX_PERF_EVENTS> _counters;
+};
+
+//Heap allocations of the process. Counted only in the one translation unit defining
+//RUNEWORDER_COUNT_ALLOCATIONS before this header, which replaces the global operator new.
+inline uint64 RuneworderAllocations = 0;
+
+#ifdef RUNEWORDER_COUNT_ALLOCATIONS
+void* operator new(std::size_t size)
+{
+    ++RuneworderAllocations;
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+#endif
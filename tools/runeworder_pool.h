@@ -0,0 +1,78 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_POOL_H
+#define RUNEWORDER_POOL_H
+
+//Thread pool shared by the offline tools
+
+#include "Define.h"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Runs tasks on all threads, each thread drains its own queue from the back
+//and steals from the front of the others once it is empty
+class WorkStealingPool
+{
+public:
+    static uint32 GetDefaultThreads() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+    //func(task, thread), thread is 0..threadCount-1 so callers can keep per-thread state
+    template<typename F>
+    static void Run(uint32 taskCount, uint32 threadCount, F const& func)
+    {
+        std::vector<Queue> queues(threadCount);
+        for (uint32 i = 0; i < threadCount; ++i) //contiguous blocks, neighbour tasks share cache
+            for (uint32 task = taskCount * i / threadCount; task < taskCount * (i + 1) / threadCount; ++task)
+                queues[i].tasks.push_back(task);
+
+        std::vector<std::thread> threads;
+        for (uint32 i = 0; i < threadCount; ++i)
+        {
+            threads.emplace_back([&queues, &func, i, threadCount]()
+            {
+                uint32 task;
+                while (Pop(queues[i], true, task) || Steal(queues, i, threadCount, task))
+                    func(task, i);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<uint32> tasks;
+    };
+
+    static bool Pop(Queue& queue, bool back, uint32& task)
+    {
+        std::lock_guard<std::mutex> guard(queue.lock);
+        if (queue.tasks.empty())
+            return false;
+        task = back ? queue.tasks.back() : queue.tasks.front();
+        if (back)
+            queue.tasks.pop_back();
+        else
+            queue.tasks.pop_front();
+        return true;
+    }
+
+    //tasks never add tasks, all queues empty means done
+    static bool Steal(std::vector<Queue>& queues, uint32 self, uint32 threadCount, uint32& task)
+    {
+        for (uint32 i = 1; i < threadCount; ++i)
+            if (Pop(queues[(self + i) % threadCount], false, task))
+                return true;
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,302 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Carve capture replay
+//Streams capture logs (Runeworder.Capture.File, boss_runeworder_capture.h) back through the recognizer at full speed:
+//vertex angles from the captured points, strokes from the captured angles, matches of the built-in patterns
+//and the rune picked by the captured roll, each compared with what the boss computed. Reports divergences and
+//recognition time per record, fails if any stage diverged, so changes can be checked against real carvings.
+//--dump prints every record with the closest runes, for triage of reported runes.
+//usage: runeworder_replay [--dump] [--repeat N] <capture files...>
+
+#include "boss_runeworder_capture.h"
+#include "boss_runeworder_path.h"
+#include "boss_runeworder_recognition.h"
+#include "boss_runeworder_strokes.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+
+constexpr size_t REPLAY_CHUNK_SIZE = 1 << 20;
+constexpr uint32 REPLAY_CLOSEST_RUNES = 3;
+
+constexpr char const StrokeSymbols[TURN_REVERSE] = { '-', 'I', 'V', 'L', 'M', 'H', 'C', 'S' };
+
+enum ReplayStages
+{
+    REPLAY_ANGLES,
+    REPLAY_STROKES,
+    REPLAY_MATCHES,
+    REPLAY_RUNE,
+    MAX_REPLAY_STAGES
+};
+
+constexpr char const* ReplayStageNames[MAX_REPLAY_STAGES] = { "angles", "strokes", "matches", "rune" };
+
+struct ReplayStats
+{
+    uint64 records = 0;
+    uint64 checked[MAX_REPLAY_STAGES] = { };
+    uint64 diverged[MAX_REPLAY_STAGES] = { };
+    uint64 corrupt = 0;
+    uint64 torn = 0;
+    double nanoseconds = 0.0;   //recognition only
+};
+
+std::string GetRuneName(uint32 rune)
+{
+    if (rune < MAX_RUNE_TYPES)
+        return RuneTypeNames[rune];
+    if (rune == RUNE_INVALID)
+        return "INVALID";
+    //appended, GCC 12 -Wrestrict misreads "#" + std::string&&
+    std::string name = "#";
+    name += std::to_string(rune);
+    return name;
+}
+
+std::string GetStrokesText(Strokes const& strokes)
+{
+    std::string text;
+    for (Stroke const& stroke : strokes)
+    {
+        if (!text.empty())
+            text += ' ';
+        text += StrokeSymbols[stroke.type < TURN_REVERSE ? stroke.type : uint8(NO_STROKE)];
+        if (stroke.reverse)
+            text += "/r";
+    }
+    return text;
+}
+
+bool SameMatches(RuneMatchHeap<MAX_RUNE_MATCHES> const& replayed, std::vector<RuneMatch> const& captured)
+{
+    if (replayed.size() != captured.size())
+        return false;
+    for (size_t i = 0; i < captured.size(); ++i)
+    {
+        RuneMatch const& a = replayed.begin()[i];
+        RuneMatch const& b = captured[i];
+        if (a.type != b.type || a.score.errors != b.score.errors || a.score.offset != b.score.offset ||
+            a.score.coverage != b.score.coverage || a.score.reversed != b.score.reversed)
+            return false;
+    }
+    return true;
+}
+
+void DumpCapture(RuneCapture const& capture, RuneMatchHeap<MAX_RUNE_MATCHES> const& matches)
+{
+    RuneCaptureRecordHeader const& header = capture.header;
+    std::printf("time %llu entry %u map %u instance %u difficulty %u engine %u budget %u%s%s\n",
+        (unsigned long long)header.time, header.entry, uint32(header.mapId), header.instanceId, uint32(header.difficulty),
+        uint32(header.engine), uint32(header.budget), (header.flags & RUNECAPTURE_FLAG_FORCED) ? " forced" : "",
+        (header.flags & RUNECAPTURE_FLAG_PACK) ? " pack" : "");
+    std::printf("  points:");
+    for (RuneTemplatePoint const& point : capture.points)
+        std::printf(" (%.2f %.2f)", point.x, point.y);
+    std::printf("\n  vertices:");
+    for (uint32 vertex : capture.vertices)
+        std::printf(" %u", vertex);
+    std::printf("\n  angles:");
+    for (int32 angle : capture.angles)
+        std::printf(" %i", angle);
+    std::printf("\n  strokes: %s\n  matches:", GetStrokesText(capture.strokes).c_str());
+    for (RuneMatch const& match : capture.matches)
+        std::printf(" %s(e%u c%u @%u%s)", GetRuneName(match.type).c_str(), uint32(match.score.errors), uint32(match.score.coverage),
+            uint32(match.score.offset), match.score.reversed ? "r" : "");
+    std::printf("\n  roll %i of %i: %s (replayed %u matches)\n", header.roll, header.rollMax, GetRuneName(header.rune).c_str(), uint32(matches.size()));
+
+    //runes the strokes came closest to, by approximate matcher errors
+    std::vector<std::pair<uint32, uint32>> closest;
+    for (size_t i = 0; i < MAX_RUNE_TYPES; ++i)
+        closest.emplace_back(RunePatterns[i].GetMatchErrors(capture.strokes.data(), capture.strokes.size(), MAX_RUNE_MATCH_ERRORS), uint32(i));
+    std::partial_sort(closest.begin(), closest.begin() + REPLAY_CLOSEST_RUNES, closest.end());
+    std::printf("  closest:");
+    for (uint32 i = 0; i < REPLAY_CLOSEST_RUNES; ++i)
+    {
+        if (closest[i].first > MAX_RUNE_MATCH_ERRORS)
+            std::printf(" %s(>%u errors)", RuneTypeNames[closest[i].second], MAX_RUNE_MATCH_ERRORS);
+        else
+            std::printf(" %s(%u errors)", RuneTypeNames[closest[i].second], closest[i].first);
+    }
+    std::printf("\n");
+}
+
+void ReplayCapture(RuneCapture const& capture, bool dump, ReplayStats& stats)
+{
+    RuneCaptureRecordHeader const& header = capture.header;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Position> vertices;
+    for (uint32 vertex : capture.vertices)
+        vertices.emplace_back(capture.points[vertex].x, capture.points[vertex].y);
+    std::vector<int32> angles;
+    for (size_t i = 1; i + 1 < vertices.size(); ++i)
+        angles.push_back(GetDegrees(&vertices[i - 1], &vertices[i], &vertices[i + 1]));
+    Strokes strokes = ClassifyRuneStrokes(capture.angles.data(), uint32(capture.angles.size()));
+
+    //template engine and pack runes are not replayed, built-in stroke patterns only
+    bool matchable = header.engine == RUNE_ENGINE_STROKES && !(header.flags & RUNECAPTURE_FLAG_PACK);
+    RuneMatchHeap<MAX_RUNE_MATCHES> matches;
+    if (matchable)
+        FindRuneMatches(RuneRecognitionSet(), capture.strokes, header.budget, matches);
+    uint32 rune = matchable ? GetRolledRune(matches, header.budget, header.roll) : RUNE_INVALID;
+
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    stats.nanoseconds += elapsed.count();
+    ++stats.records;
+
+    bool diverged[MAX_REPLAY_STAGES] =
+    {
+        angles != capture.angles,
+        strokes.size() != capture.strokes.size() || !std::equal(strokes.begin(), strokes.end(), capture.strokes.begin(),
+            [](Stroke const& a, Stroke const& b) { return a.type == b.type && a.reverse == b.reverse; }),
+        matchable && !SameMatches(matches, capture.matches),
+        matchable && !(header.flags & RUNECAPTURE_FLAG_FORCED) && rune != header.rune
+    };
+    stats.checked[REPLAY_ANGLES] += 1;
+    stats.checked[REPLAY_STROKES] += 1;
+    stats.checked[REPLAY_MATCHES] += matchable;
+    stats.checked[REPLAY_RUNE] += matchable && !(header.flags & RUNECAPTURE_FLAG_FORCED);
+
+    bool any = false;
+    for (uint32 s = 0; s < MAX_REPLAY_STAGES; ++s)
+    {
+        stats.diverged[s] += diverged[s];
+        any = any || diverged[s];
+    }
+
+    if (dump || any)
+    {
+        if (any)
+        {
+            std::printf("record %llu diverged:", (unsigned long long)stats.records);
+            for (uint32 s = 0; s < MAX_REPLAY_STAGES; ++s)
+                if (diverged[s])
+                    std::printf(" %s", ReplayStageNames[s]);
+            std::printf(" (replayed strokes %s, rune %s)\n", GetStrokesText(strokes).c_str(), GetRuneName(rune).c_str());
+        }
+        DumpCapture(capture, matches);
+    }
+}
+
+//reads the file in chunks, records crossing a chunk boundary are completed from the next one
+bool ReplayFile(char const* fileName, bool dump, ReplayStats& stats)
+{
+    FILE* file = std::fopen(fileName, "rb");
+    if (!file)
+    {
+        std::fprintf(stderr, "cannot open %s\n", fileName);
+        return false;
+    }
+
+    std::vector<uint8> buffer;
+    size_t size = 0, offset = 0;
+    bool headerRead = false, eof = false;
+    RuneCapture capture;
+    while (true)
+    {
+        //keep the unread tail, append the next chunk
+        if (offset)
+        {
+            std::memmove(buffer.data(), buffer.data() + offset, size - offset);
+            size -= offset;
+            offset = 0;
+        }
+        if (!eof)
+        {
+            buffer.resize(std::max(buffer.size(), size + REPLAY_CHUNK_SIZE));
+            size_t read = std::fread(buffer.data() + size, 1, buffer.size() - size, file);
+            size += read;
+            eof = read == 0;
+        }
+
+        if (!headerRead)
+        {
+            std::string error;
+            if (!ReadRuneCaptureFileHeader(buffer.data(), size, offset, error))
+            {
+                std::fprintf(stderr, "%s: %s\n", fileName, error.c_str());
+                std::fclose(file);
+                return false;
+            }
+            headerRead = true;
+        }
+
+        RuneCaptureReadResults result;
+        while ((result = ReadRuneCapture(buffer.data(), size, offset, capture)) == RUNECAPTURE_READ_OK)
+            ReplayCapture(capture, dump, stats);
+
+        if (result == RUNECAPTURE_READ_CORRUPT)
+        {
+            std::fprintf(stderr, "%s: corrupt record after %llu records, rest of the file skipped\n", fileName, (unsigned long long)stats.records);
+            ++stats.corrupt;
+            break;
+        }
+        if (eof)
+        {
+            if (result == RUNECAPTURE_READ_TRUNCATED)
+            {
+                std::fprintf(stderr, "%s: last record is incomplete (%u bytes)\n", fileName, uint32(size - offset));
+                ++stats.torn;
+            }
+            break;
+        }
+    }
+
+    std::fclose(file);
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    bool dump = false;
+    uint32 repeat = 1;
+    std::vector<char const*> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!std::strcmp(argv[i], "--dump"))
+            dump = true;
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc)
+            repeat = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else
+            files.push_back(argv[i]);
+    }
+
+    if (files.empty())
+    {
+        std::fprintf(stderr, "usage: %s [--dump] [--repeat N] <capture files...>\n", argv[0]);
+        return 1;
+    }
+
+    ReplayStats stats;
+    auto start = std::chrono::steady_clock::now();
+    bool ok = true;
+    for (uint32 r = 0; r < repeat; ++r)
+        for (char const* fileName : files)
+            ok = ReplayFile(fileName, dump && !r, stats) && ok;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double records = double(std::max<uint64>(stats.records, 1));
+    std::printf("%llu records replayed in %.3f s (%.0f records/s), recognition %.1f ns per record\n",
+        (unsigned long long)stats.records, elapsed.count(), double(stats.records) / elapsed.count(), stats.nanoseconds / records);
+    uint64 divergences = 0;
+    for (uint32 s = 0; s < MAX_REPLAY_STAGES; ++s)
+    {
+        std::printf("%-8s %12llu checked %10llu diverged\n", ReplayStageNames[s], (unsigned long long)stats.checked[s],
+            (unsigned long long)stats.diverged[s]);
+        divergences += stats.diverged[s];
+    }
+    if (stats.torn)
+        std::printf("%llu files end with an incomplete record\n", (unsigned long long)stats.torn);
+
+    return ok && !stats.corrupt && !divergences ? 0 : 1;
+}
@@ -0,0 +1,410 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_STAGES_H
+#define RUNEWORDER_STAGES_H
+
+//Rune pipeline stages for the benchmarks, each timed on its own
+//Realistic inputs are carved from the built-in runes (one rune per path, jittered angles and steps),
+//adversarial ones are the worst cases of each stage: longest sequences of random strokes, random angles,
+//stalled and kiting carvers, every rune stacked, full match heaps.
+//Inputs are deterministic (fixed seed), so runs on different commits do the same work.
+
+#include "boss_runeworder_matchers.h"
+#include "boss_runeworder_path.h"
+#include "boss_runeworder_recognition.h"
+#include "boss_runeworder_strokes.h"
+#include "boss_runeworder_table.h"
+#include "runeworder_perf.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+
+constexpr float BENCH_POINT_STEP = 14.7f; //run speed 7 * POINT_PUT_DELAY, see _GetPointStep()
+constexpr float BENCH_DIST_THRESHOLD = 0.25f; //DIST_THRESHOLD
+constexpr uint32 BENCH_SAMPLE_INTERVAL = 300; //POINT_SAMPLE_INTERVAL
+constexpr uint32 BENCH_SAMPLE_TICKS = 7; //polls per step at run speed
+
+struct BenchInputs
+{
+    std::vector<std::vector<Position>> paths;   //carve vertices
+    std::vector<std::vector<Position>> carves;  //carver position per sampler poll
+    std::vector<std::vector<int32>> angles;     //vertex angles of each path
+    std::vector<Strokes> sequences;
+    std::vector<RuneEncodedSequence> encoded;
+    std::vector<RuneStacks> stacks;
+    std::vector<RuneMatchHeap<MAX_RUNE_MATCHES>> heaps;
+};
+
+//vertex angle inside the stroke band, see ClassifyRuneStrokes
+inline int32 GetBenchStrokeAngle(uint8 type, std::mt19937& rng)
+{
+    auto band = [&](int32 lo, int32 hi) { return lo + 1 + int32(rng() % uint32(hi - lo - 1)); };
+    switch (type)
+    {
+        case LINE:          return band(171, 180);
+        case LINE_REV:      return band(0, 15);
+        case CURVE_L:       return band(141, 170);
+        case CURVE_M:       return band(121, 140);
+        case CURVE_H:       return band(101, 120);
+        case TURN_CUBIC:    return band(81, 100);
+        default:            return band(16, 80);
+    }
+}
+
+//one carving of the pattern: a random stroke of each slot, optional slots dropped half of the time
+inline std::vector<int32> GetBenchRuneAngles(RunePattern const& pattern, std::mt19937& rng)
+{
+    std::vector<int32> angles;
+    int32 side = 1;
+    for (uint8 k = 0; k < pattern.size; ++k)
+    {
+        uint32 mask = pattern.strokeSequence[k];
+        if ((mask & STDEF_CAN_BE_EMPTY) && rng() % 2)
+            continue;
+
+        uint8 types[TURN_REVERSE];
+        uint32 count = 0;
+        for (uint8 type = LINE; type < TURN_REVERSE; ++type)
+            if (mask & (1 << type))
+                types[count++] = type;
+        if (!count)
+            continue;
+
+        uint8 type = types[rng() % count];
+        int32 angle = GetBenchStrokeAngle(type, rng);
+        if (type != LINE && type != LINE_REV && (mask & STDEF_REV))
+            side = -side;
+        angles.push_back(type == LINE || type == LINE_REV ? angle : angle * side);
+    }
+    return angles;
+}
+
+//vertices turning by the given vertex angles (angle between the previous and the next vertex)
+inline std::vector<Position> GetBenchPath(std::vector<int32> const& angles, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> step(0.7f * BENCH_POINT_STEP, 1.3f * BENCH_POINT_STEP);
+    std::vector<Position> path;
+    float x = 0.f, y = 0.f, heading = float(rng() % 360) * float(M_PI) / 180.f;
+    path.emplace_back(x, y);
+    for (size_t i = 0; i <= angles.size(); ++i)
+    {
+        if (i)
+            heading = heading + float(M_PI) - float(angles[i - 1]) * float(M_PI) / 180.f;
+        float length = step(rng);
+        x += std::cos(heading) * length;
+        y += std::sin(heading) * length;
+        path.emplace_back(x, y);
+    }
+    return path;
+}
+
+//carver polled along the path, stalls add polls in place
+inline std::vector<Position> GetBenchCarve(std::vector<Position> const& path, uint32 stallTicks, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> jitter(-0.05f, 0.05f);
+    std::vector<Position> carve;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+    {
+        float dx = path[i + 1].GetPositionX() - path[i].GetPositionX();
+        float dy = path[i + 1].GetPositionY() - path[i].GetPositionY();
+        uint32 ticks = uint32(path[i].GetExactDist2d(&path[i + 1]) / BENCH_POINT_STEP * BENCH_SAMPLE_TICKS) + 1;
+        for (uint32 t = 0; t < ticks; ++t)
+            carve.emplace_back(path[i].GetPositionX() + dx * t / ticks, path[i].GetPositionY() + dy * t / ticks);
+        for (uint32 t = 0; t < stallTicks; ++t)
+            carve.emplace_back(path[i + 1].GetPositionX() + jitter(rng), path[i + 1].GetPositionY() + jitter(rng));
+    }
+    carve.push_back(path.back());
+    return carve;
+}
+
+inline void FinishBenchInputs(BenchInputs& inputs)
+{
+    inputs.encoded.resize(inputs.sequences.size());
+    for (size_t i = 0; i < inputs.sequences.size(); ++i)
+        EncodeRuneSequence(inputs.sequences[i].data(), inputs.sequences[i].size(), inputs.encoded[i]);
+}
+
+inline BenchInputs GetRealisticBenchInputs(uint32 count)
+{
+    std::mt19937 rng(12345);
+    BenchInputs inputs;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        std::vector<int32> angles = GetBenchRuneAngles(RunePatterns[rng() % MAX_RUNE_TYPES], rng);
+        inputs.paths.push_back(GetBenchPath(angles, rng));
+        inputs.carves.push_back(GetBenchCarve(inputs.paths.back(), rng() % 4 ? 0 : 3, rng));
+        inputs.sequences.push_back(ClassifyRuneStrokes(angles.data(), uint32(angles.size())));
+        inputs.angles.push_back(std::move(angles));
+    }
+    FinishBenchInputs(inputs);
+
+    for (size_t i = 0; i < inputs.sequences.size(); ++i)
+    {
+        RuneMatchHeap<MAX_RUNE_MATCHES> matches;
+        FindRuneMatches(RuneRecognitionSet(), inputs.sequences[i], UNMATCH_THRESHOLD, matches);
+        if (!matches.empty())
+            inputs.heaps.push_back(matches);
+    }
+
+    //runes of a runeword and a couple of stray ones
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RunewordPattern const& pattern = RunewordPatterns[rng() % MAX_RUNEWORD_TYPES];
+        RuneStacks stacks = { };
+        for (uint32 k = 0; k < pattern.size; ++k)
+            if (rng() % 8)
+                AddRuneStacks(stacks, pattern.runeSpellList[k], 1);
+        for (uint32 k = rng() % 3; k > 0; --k)
+            AddRuneStacks(stacks, SPELL_EL_SELF + rng() % MAX_RUNE_SPELLS, 1);
+        inputs.stacks.push_back(stacks);
+    }
+    return inputs;
+}
+
+inline BenchInputs GetAdversarialBenchInputs(uint32 count)
+{
+    std::mt19937 rng(54321);
+    std::uniform_int_distribution<int32> angle(-180, 180);
+    BenchInputs inputs;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        std::vector<int32> angles(MAX_RUNE_SEQUENCE_LENGTH);
+        for (int32& a : angles)
+            a = angle(rng);
+        inputs.paths.push_back(GetBenchPath(angles, rng));
+        inputs.carves.push_back(GetBenchCarve(inputs.paths.back(), 2 * BENCH_SAMPLE_TICKS, rng));
+        inputs.angles.push_back(std::move(angles));
+
+        Strokes sequence(MAX_RUNE_SEQUENCE_LENGTH, Stroke(LINE, false));
+        for (Stroke& stroke : sequence)
+            stroke = GetRuneTableStroke(rng() % RUNE_TABLE_SYMBOLS);
+        inputs.sequences.push_back(std::move(sequence));
+    }
+    FinishBenchInputs(inputs);
+
+    RuneStacks all;
+    all.fill(2);
+    for (uint32 i = 0; i < count; ++i)
+    {
+        RuneMatchHeap<MAX_RUNE_MATCHES> matches;
+        for (size_t k = 0; k < MAX_RUNE_MATCHES + 2; ++k)
+            matches.Push(RuneMatch{ uint8(rng() % MAX_RUNE_TYPES), RuneMatchScore{ uint8(rng() % 2), 0, uint8(5 + rng() % 5), false } });
+        matches.Sort();
+        inputs.heaps.push_back(matches);
+        inputs.stacks.push_back(all);
+    }
+    return inputs;
+}
+
+//one pass over its inputs, returns a checksum so the work is not optimized away
+struct BenchStage
+{
+    std::string name;   //stage/input
+    uint64 ops;         //operations per pass
+    std::function<uint64()> pass;
+};
+
+inline void AddBenchStages(std::vector<BenchStage>& stages, BenchInputs const& in, std::string const& input)
+{
+    uint64 ticks = 0, triples = 0;
+    for (size_t i = 0; i < in.paths.size(); ++i)
+    {
+        ticks += in.carves[i].size();
+        triples += in.paths[i].size() - 2;
+    }
+
+    //carver polls: sampler and vertex simplification
+    stages.push_back({ "sample/" + input, ticks, [&in]()
+    {
+        uint64 sum = 0;
+        RunePointSampler sampler;
+        RunePathSimplifier path;
+        for (std::vector<Position> const& carve : in.carves)
+        {
+            sampler.Reset(BENCH_POINT_STEP, BENCH_POINT_STEP * BENCH_DIST_THRESHOLD, uint32(MAX_RUNE_POINTS)); //whole carve
+            path.Reset(BENCH_POINT_STEP * BENCH_DIST_THRESHOLD);
+            for (Position const& pos : carve)
+            {
+                float x = pos.GetPositionX(), y = pos.GetPositionY();
+                if (sampler.Update(BENCH_SAMPLE_INTERVAL, x, y) != RUNE_SAMPLE_NONE)
+                    path.Add(x, y);
+            }
+            sum += path.GetVertices().size();
+        }
+        return sum;
+    } });
+
+    stages.push_back({ "degrees/" + input, triples, [&in]()
+    {
+        uint64 sum = 0;
+        for (std::vector<Position> const& path : in.paths)
+            for (size_t i = 1; i + 1 < path.size(); ++i)
+                sum += uint64(GetDegrees(&path[i - 1], &path[i], &path[i + 1]));
+        return sum;
+    } });
+
+    stages.push_back({ "classify/" + input, in.angles.size(), [&in]()
+    {
+        uint64 sum = 0;
+        for (std::vector<int32> const& angles : in.angles)
+            sum += ClassifyRuneStrokes(angles.data(), uint32(angles.size())).size();
+        return sum;
+    } });
+
+    //encoding, candidates, matchers and top-k as the boss does (FindRuneMatches), per sequence
+    stages.push_back({ "match_all/" + input, in.sequences.size(), [&in]()
+    {
+        uint64 sum = 0;
+        for (Strokes const& sequence : in.sequences)
+        {
+            RuneMatchHeap<MAX_RUNE_MATCHES> matches;
+            FindRuneMatches(RuneRecognitionSet(), sequence, UNMATCH_THRESHOLD, matches);
+            sum += matches.size();
+        }
+        return sum;
+    } });
+
+    stages.push_back({ "runeword/" + input, in.stacks.size(), [&in]()
+    {
+        uint64 sum = 0;
+        for (RuneStacks const& stacks : in.stacks)
+        {
+            RunewordRunes.Candidates(stacks).ForEach([&](size_t i)
+            {
+                sum += RunewordPatterns[i].Contains(stacks);
+            });
+        }
+        return sum;
+    } });
+
+    //weights and roll of _ComputateRuneType, rolls from a fixed sequence
+    stages.push_back({ "roll/" + input, in.heaps.size(), [&in]()
+    {
+        uint64 sum = 0;
+        uint32 seed = 1;
+        auto rand = [&seed](int32 min, int32 max)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return min + int32((seed >> 8) % uint32(max - min + 1));
+        };
+        for (RuneMatchHeap<MAX_RUNE_MATCHES> const& matches : in.heaps)
+        {
+            int32 roll, rollMax;
+            uint32 rune = RollRuneMatch(matches, UNMATCH_THRESHOLD, rand, roll, rollMax);
+            sum += rune != RUNE_INVALID ? rune : 0;
+        }
+        return sum;
+    } });
+}
+
+//RunePattern::Matches of each built-in rune on its own, specialized matchers on encoded sequences
+inline void AddBenchRuneStages(std::vector<BenchStage>& stages, BenchInputs const& in, std::string const& input)
+{
+    for (size_t r = 0; r < MAX_RUNE_TYPES; ++r)
+    {
+        stages.push_back({ std::string("match/") + RuneTypeNames[r] + "/" + input, in.encoded.size(), [&in, r]()
+        {
+            uint64 sum = 0;
+            for (RuneEncodedSequence const& encoded : in.encoded)
+            {
+                RuneMatchScore score;
+                sum += RuneMatchers[r](encoded, score);
+            }
+            return sum;
+        } });
+    }
+}
+
+struct BenchResult
+{
+    std::string name;
+    uint64 ops = 0;
+    uint64 checksum = 0;
+    uint32 repetitions = 0;
+    double nanoseconds = 0.0;   //per op, median of the repetitions
+    double minimum = 0.0;       //fastest repetition, ns per op
+    double deviation = 0.0;     //standard deviation of the repetitions relative to the median
+    double allocations = 0.0;   //per op
+    PerfCounters::Counts events = { };  //per op (median), -1 if unavailable
+};
+
+inline double GetBenchMedian(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+//warm-up passes, then counted ones
+inline BenchResult RunBenchStage(BenchStage const& stage, PerfCounters& counters, uint32 warmups = 1, uint32 repetitions = 1)
+{
+    BenchResult result;
+    result.name = stage.name;
+    result.ops = stage.ops;
+    result.repetitions = std::max(repetitions, 1u);
+    result.checksum = stage.pass();
+    for (uint32 i = 1; i < warmups; ++i)
+        stage.pass();
+
+    double ops = double(std::max<uint64>(stage.ops, 1));
+    std::vector<double> times, allocations;
+    std::array<std::vector<double>, MAX_PERF_EVENTS> events;
+    for (uint32 r = 0; r < result.repetitions; ++r)
+    {
+        uint64 allocated = RuneworderAllocations;
+        counters.Start();
+        auto start = std::chrono::steady_clock::now();
+        uint64 checksum = stage.pass();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        PerfCounters::Counts counts = counters.Stop();
+        allocated = RuneworderAllocations - allocated;
+
+        times.push_back(elapsed.count() / ops);
+        allocations.push_back(double(allocated) / ops);
+        for (uint32 e = 0; e < MAX_PERF_EVENTS; ++e)
+            events[e].push_back(counts[e] >= 0.0 ? counts[e] / ops : -1.0);
+        if (checksum != result.checksum)
+            result.checksum = ~uint64(0); //passes disagree, inputs were changed by the stage
+    }
+
+    result.nanoseconds = GetBenchMedian(times);
+    result.minimum = *std::min_element(times.begin(), times.end());
+    double variance = 0.0;
+    for (double time : times)
+        variance += (time - result.nanoseconds) * (time - result.nanoseconds);
+    result.deviation = result.nanoseconds > 0.0 ? std::sqrt(variance / double(times.size())) / result.nanoseconds : 0.0;
+    result.allocations = GetBenchMedian(allocations);
+    for (uint32 e = 0; e < MAX_PERF_EVENTS; ++e)
+        result.events[e] = GetBenchMedian(events[e]);
+    return result;
+}
+
+//results array of the JSON output, one result per line
+inline void WriteBenchResults(FILE* file, std::vector<BenchResult> const& results)
+{
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        BenchResult const& result = results[i];
+        std::fprintf(file, "    { \"name\": \"%s\", \"ops\": %llu, \"repetitions\": %u, \"ns_per_op\": %.3f, \"ns_min\": %.3f, \"ns_deviation\": %.4f, \"allocs_per_op\": %.9g",
+            result.name.c_str(), (unsigned long long)result.ops, result.repetitions, result.nanoseconds, result.minimum, result.deviation, result.allocations);
+        for (uint32 e = 0; e < MAX_PERF_EVENTS; ++e)
+        {
+            if (result.events[e] >= 0.0)
+                std::fprintf(file, ", \"%s_per_op\": %.3f", PerfEventNames[e], result.events[e]);
+            else
+                std::fprintf(file, ", \"%s_per_op\": null", PerfEventNames[e]);
+        }
+        std::fprintf(file, ", \"checksum\": %llu }%s\n", (unsigned long long)result.checksum, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n");
+}
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Standalone build of the compile-time tests (boss_runeworder_tests.h)
+//Building this file is the test. Running it (after each build) checks the carve sampler, its math is not constexpr,
+//and the match table built at startup for the built-in patterns.
+
+#include "boss_runeworder_tests.h"
+#include "boss_runeworder_encounter.h"
+#include "boss_runeworder_path.h"
+#include "boss_runeworder_recognition.h"
+#include "boss_runeworder_strokes.h"
+#include <cmath>
+#include <cstdio>
+
+namespace
+{
+
+constexpr float TESTS_RUN_SPEED = 7.f; //baseMoveSpeed[MOVE_RUN]
+constexpr float TESTS_PI = 3.14159265f;
+
+//EVENT_POINT_PUT polls of a carver running at run speed, turning by turnDegrees to alternate sides every legSteps
+//returns the points summoned, path is the sampled path
+uint32 GetCarvePoints(float legSteps, float turnDegrees, RunePathSimplifier& path)
+{
+    float const step = TESTS_RUN_SPEED * POINT_PUT_DELAY * 0.001f;
+    float const move = TESTS_RUN_SPEED * POINT_SAMPLE_INTERVAL * 0.001f;
+    RunePointSampler sampler;
+    sampler.Reset(step, step * DIST_THRESHOLD, DEFAULT_RUNE_POINTS - 1);
+    path.Reset(step * DIST_THRESHOLD);
+
+    uint32 points = 0;
+    float x = 0.f, y = 0.f, heading = 0.f, leg = 0.f, side = 1.f;
+    while (!sampler.IsDone())
+    {
+        float px = x, py = y;
+        RuneSamples sample = sampler.Update(POINT_SAMPLE_INTERVAL, px, py);
+        if (sample != RUNE_SAMPLE_NONE)
+            path.Add(px, py);
+        points += sample == RUNE_SAMPLE_POINT;
+
+        leg += move;
+        if (leg >= legSteps * step)
+        {
+            leg = 0.f;
+            heading += side * turnDegrees * TESTS_PI / 180.f;
+            side = -side;
+        }
+        x += std::cos(heading) * move;
+        y += std::sin(heading) * move;
+    }
+    return points;
+}
+
+//a straight run summons its two ends but keeps a line stroke per step, a zig-zag summons its corners too
+bool TestCarveSampler()
+{
+    RunePathSimplifier straightPath, zigzagPath;
+    uint32 straight = GetCarvePoints(DEFAULT_RUNE_POINTS, 0.f, straightPath);
+    uint32 zigzag = GetCarvePoints(2.f, 60.f, zigzagPath);
+    if (straight != 2 || straight >= zigzag)
+    {
+        std::fprintf(stderr, "carve sampler: straight run summoned %u points, zig-zag %u\n", straight, zigzag);
+        return false;
+    }
+
+    RunePathPoints const& points = straightPath.GetPoints();
+    std::vector<Position> vertices;
+    for (uint32 index : straightPath.GetVertices())
+        vertices.emplace_back(points[index].x, points[index].y);
+    std::vector<int32> angles;
+    for (size_t i = 1; i + 1 < vertices.size(); ++i)
+        angles.push_back(GetDegrees(&vertices[i - 1], &vertices[i], &vertices[i + 1]));
+    Strokes strokes = ClassifyRuneStrokes(angles.data(), uint32(angles.size()));
+    uint32 lines = 0;
+    for (Stroke const& stroke : strokes)
+        lines += stroke.type == LINE;
+    //a step can take one poll more than POINT_PUT_DELAY, so the last one may not fit
+    if (strokes.size() < DEFAULT_RUNE_POINTS - 3 || lines != strokes.size())
+    {
+        std::fprintf(stderr, "carve sampler: straight run gave %u strokes, %u lines\n", uint32(strokes.size()), lines);
+        return false;
+    }
+    return true;
+}
+
+//the startup table finds the same matches as the candidate index and matchers on every sequence it covers
+bool TestBuiltinMatchTable()
+{
+    RuneMatchTableData data;
+    auto runTasks = [](uint32 taskCount, auto&& run)
+    {
+        for (uint32 i = 0; i < taskCount; ++i)
+            run(i);
+    };
+    if (!BuildRuneMatchTable(RunePatterns.data(), MAX_RUNE_TYPES, uint8(DEFAULT_BUILTIN_TABLE_LENGTH), runTasks, data))
+    {
+        std::fprintf(stderr, "match table: cannot build the built-in table\n");
+        return false;
+    }
+
+    RuneMatchTable const table = data.GetView();
+    RuneRecognitionSet withTable;
+    withTable.table = &table;
+    for (size_t length = table.minLength; length <= table.maxLength; ++length)
+    {
+        for (uint64 number = 0; number < GetRuneTableSequences(length); ++number)
+        {
+            RuneTableSequence const sequence = GetRuneTableSequence(number, length);
+            Strokes const strokes(sequence.begin(), sequence.begin() + length);
+            RuneMatchHeap<MAX_RUNE_MATCHES> found, expected;
+            bool hit = FindRuneMatches(withTable, strokes, UNMATCH_THRESHOLD, found).tableHit;
+            FindRuneMatches(RuneRecognitionSet(), strokes, UNMATCH_THRESHOLD, expected);
+            bool same = hit && found.size() == expected.size();
+            for (size_t i = 0; same && i < found.size(); ++i)
+            {
+                RuneMatch const& a = found.begin()[i];
+                RuneMatch const& b = expected.begin()[i];
+                same = a.type == b.type && a.score.errors == b.score.errors && a.score.offset == b.score.offset &&
+                    a.score.coverage == b.score.coverage && a.score.reversed == b.score.reversed;
+            }
+            if (!same)
+            {
+                std::fprintf(stderr, "match table: sequence %llu of %u strokes gave %u matches, expected %u\n",
+                    (unsigned long long)number, uint32(length), uint32(found.size()), uint32(expected.size()));
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+int main()
+{
+    if (!TestCarveSampler() || !TestBuiltinMatchTable())
+        return 1;
+
+    std::printf("%u runes, %u runewords: matcher, coverage and runeword tests passed at compile time, carve sampler and match table passed\n",
+        uint32(MAX_RUNE_TYPES), uint32(MAX_RUNEWORD_TYPES));
+    return 0;
+}
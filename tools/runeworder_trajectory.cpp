@@ -0,0 +1,302 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+//Carver trajectory simulator
+//Generates carvings of npc_rune_carver chasing a player who moves by a scripted style (circle kiting, zigzag,
+//standing still, random walk) on all threads, see runeworder_trajectory.h, and reports the throughput and the
+//recognized rune distribution of each style. RUNE_INVALID is the rune cast as SPELL_RUNIC_WITHDRAWAL.
+//usage: runeworder_trajectory [--carvings N per style] [--threads N] [--seed N] [--tick ms] [--speed speed_run]
+//                             [--player-speed yd/s] [--points N] [--budget N] [--style name] [--json file] [--capture file]
+//--capture writes the carvings as a capture log (boss_runeworder_capture.h) for runeworder_replay
+
+#include "boss_runeworder_capture.h"
+#include "runeworder_pool.h"
+#include "runeworder_trajectory.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+
+namespace
+{
+
+constexpr uint32 CARVINGS_PER_TASK = 1000;
+
+struct TrajectoryStats
+{
+    uint64 carvings = 0;
+    uint64 points = 0;      //summoned
+    uint64 vertices = 0;
+    uint64 strokes = 0;
+    uint64 duration = 0;    //ms
+    uint64 matched = 0;     //carvings with more than one match (rolled)
+    std::array<uint64, MAX_RUNE_TYPES + 1> runes = { }; //last is RUNE_INVALID
+
+    void Add(TrajectoryCarving const& carving)
+    {
+        ++carvings;
+        points += carving.summoned;
+        vertices += carving.vertices.size();
+        strokes += carving.strokes.size();
+        duration += carving.duration;
+        matched += carving.matches.size() > 1;
+        ++runes[carving.rune < MAX_RUNE_TYPES ? carving.rune : MAX_RUNE_TYPES];
+    }
+
+    void Add(TrajectoryStats const& other)
+    {
+        carvings += other.carvings;
+        points += other.points;
+        vertices += other.vertices;
+        strokes += other.strokes;
+        duration += other.duration;
+        matched += other.matched;
+        for (size_t i = 0; i < runes.size(); ++i)
+            runes[i] += other.runes[i];
+    }
+};
+
+struct StyleResult
+{
+    MovementStyles style;
+    TrajectoryStats stats;
+    double seconds;
+};
+
+//rune spell of a rune type: name without the variant number (VEX3 -> VEX)
+std::string GetRuneSpellName(size_t rune)
+{
+    if (rune >= MAX_RUNE_TYPES)
+        return "INVALID";
+    std::string name = RuneTypeNames[rune];
+    while (!name.empty() && name.back() >= '0' && name.back() <= '9')
+        name.pop_back();
+    return name;
+}
+
+//rune spells in pattern order, share of the carvings of each
+std::vector<std::pair<std::string, double>> GetRuneSpellShares(TrajectoryStats const& stats)
+{
+    std::vector<std::pair<std::string, double>> shares;
+    for (size_t rune = 0; rune <= MAX_RUNE_TYPES; ++rune)
+    {
+        std::string name = GetRuneSpellName(rune);
+        if (shares.empty() || shares.back().first != name)
+            shares.emplace_back(name, 0.0);
+        shares.back().second += stats.carvings ? double(stats.runes[rune]) / double(stats.carvings) : 0.0;
+    }
+    return shares;
+}
+
+//capture record of a simulated carving, entry and map are 0
+RuneCapture GetTrajectoryCapture(TrajectoryCarving const& carving, TrajectoryOptions const& options)
+{
+    RuneCapture capture;
+    capture.header.engine = RUNE_ENGINE_STROKES;
+    capture.header.budget = uint8(options.budget);
+    capture.header.rune = uint8(carving.rune);
+    capture.header.roll = carving.roll;
+    capture.header.rollMax = carving.rollMax;
+    for (Position const& point : carving.points)
+        capture.points.push_back({ point.GetPositionX(), point.GetPositionY() });
+    capture.vertices = carving.vertices;
+    capture.angles = carving.angles;
+    capture.strokes = carving.strokes;
+    capture.matches.assign(carving.matches.begin(), carving.matches.end());
+    return capture;
+}
+
+struct CaptureFile
+{
+    FILE* file = nullptr;
+    std::mutex lock;
+};
+
+StyleResult RunStyle(MovementStyles style, TrajectoryOptions const& options, uint64 carvings, uint32 threads, uint32 seed, CaptureFile& capture)
+{
+    uint32 tasks = uint32((carvings + CARVINGS_PER_TASK - 1) / CARVINGS_PER_TASK);
+    std::vector<TrajectoryStats> threadStats(threads);
+    auto start = std::chrono::steady_clock::now();
+    WorkStealingPool::Run(tasks, threads, [&](uint32 task, uint32 thread)
+    {
+        //seeded per task, results do not depend on the thread count
+        std::mt19937 rng(seed ^ (uint32(style) * 0x9E3779B9u) ^ (task * 0x85EBCA6Bu));
+        TrajectoryCarving carving;
+        std::string buffer;
+        uint64 count = std::min<uint64>(CARVINGS_PER_TASK, carvings - uint64(task) * CARVINGS_PER_TASK);
+        for (uint64 i = 0; i < count; ++i)
+        {
+            SimulateTrajectoryCarving(style, options, rng, carving);
+            threadStats[thread].Add(carving);
+            if (capture.file)
+                AppendRuneCapture(GetTrajectoryCapture(carving, options), buffer);
+        }
+        if (!buffer.empty())
+        {
+            std::lock_guard<std::mutex> guard(capture.lock);
+            std::fwrite(buffer.data(), buffer.size(), 1, capture.file);
+        }
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    StyleResult result = { style, TrajectoryStats(), elapsed.count() };
+    for (TrajectoryStats const& stats : threadStats)
+        result.stats.Add(stats);
+    return result;
+}
+
+void WriteTrajectoryJson(FILE* file, std::vector<StyleResult> const& results, TrajectoryOptions const& options, uint32 threads)
+{
+    std::fprintf(file, "{\n  \"benchmark\": \"runeworder_trajectory\",\n  \"threads\": %u,\n  \"tick\": %u,\n  \"speed_run\": %.3f,\n"
+        "  \"player_speed\": %.3f,\n  \"rune_points\": %u,\n  \"budget\": %u,\n  \"styles\": [\n",
+        threads, options.tick, options.carverSpeedRate, options.playerSpeed, options.runePoints, options.budget);
+    for (size_t s = 0; s < results.size(); ++s)
+    {
+        StyleResult const& result = results[s];
+        TrajectoryStats const& stats = result.stats;
+        double carvings = double(std::max<uint64>(stats.carvings, 1));
+        std::fprintf(file, "    { \"style\": \"%s\", \"carvings\": %llu, \"seconds\": %.3f, \"carvings_per_second\": %.1f, "
+            "\"points\": %.3f, \"vertices\": %.3f, \"strokes\": %.3f, \"carve_seconds\": %.3f, \"rolled\": %.6f, \"runes\": {",
+            MovementStyleNames[result.style], (unsigned long long)stats.carvings, result.seconds, double(stats.carvings) / result.seconds,
+            double(stats.points) / carvings, double(stats.vertices) / carvings, double(stats.strokes) / carvings, double(stats.duration) * 0.001 / carvings,
+            double(stats.matched) / carvings);
+        bool first = true;
+        for (auto const& [name, share] : GetRuneSpellShares(stats))
+        {
+            std::fprintf(file, "%s\"%s\": %.6f", first ? " " : ", ", name.c_str(), share);
+            first = false;
+        }
+        std::fprintf(file, " } }%s\n", s + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    uint64 carvings = 250000;
+    uint32 threads = WorkStealingPool::GetDefaultThreads();
+    uint32 seed = 12345;
+    int32 onlyStyle = -1;
+    char const* jsonFile = nullptr;
+    char const* captureFile = nullptr;
+    TrajectoryOptions options;
+    bool valid = true;
+    for (int i = 1; i < argc && valid; ++i)
+    {
+        if (!std::strcmp(argv[i], "--carvings") && i + 1 < argc)
+            carvings = std::strtoull(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+            seed = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--tick") && i + 1 < argc)
+            options.tick = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--speed") && i + 1 < argc)
+            options.carverSpeedRate = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--player-speed") && i + 1 < argc)
+            options.playerSpeed = std::strtof(argv[++i], nullptr);
+        else if (!std::strcmp(argv[i], "--points") && i + 1 < argc)
+            options.runePoints = uint32(std::strtoul(argv[++i], nullptr, 10));
+        else if (!std::strcmp(argv[i], "--budget") && i + 1 < argc)
+            options.budget = std::min(uint32(std::strtoul(argv[++i], nullptr, 10)), uint32(MAX_RUNE_MATCH_ERRORS));
+        else if (!std::strcmp(argv[i], "--style") && i + 1 < argc)
+        {
+            ++i;
+            onlyStyle = MAX_MOVEMENT_STYLES;
+            for (uint32 s = 0; s < MAX_MOVEMENT_STYLES; ++s)
+                if (!std::strcmp(argv[i], MovementStyleNames[s]))
+                    onlyStyle = int32(s);
+            valid = onlyStyle < MAX_MOVEMENT_STYLES;
+        }
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc)
+            jsonFile = argv[++i];
+        else if (!std::strcmp(argv[i], "--capture") && i + 1 < argc)
+            captureFile = argv[++i];
+        else
+            valid = false;
+    }
+
+    if (!valid || !carvings || !options.tick || options.carverSpeedRate <= 0.f || options.playerSpeed < 0.f ||
+        options.runePoints < MIN_RUNE_PATTERN_LENGTH + 2 || options.runePoints > MAX_RUNE_SEQUENCE_LENGTH + 2)
+    {
+        std::fprintf(stderr, "usage: %s [--carvings N] [--threads N] [--seed N] [--tick ms] [--speed speed_run] [--player-speed yd/s]\n"
+            "    [--points %u-%u] [--budget N] [--style circle|zigzag|stand|random_walk] [--json file] [--capture file]\n",
+            argv[0], uint32(MIN_RUNE_PATTERN_LENGTH + 2), uint32(MAX_RUNE_SEQUENCE_LENGTH + 2));
+        return 1;
+    }
+
+    std::printf("%llu carvings per style, %u threads, %u ms ticks, carver speed_run %.2f (step %.1f yd), player %.1f yd/s, %u points, budget %u\n",
+        (unsigned long long)carvings, threads, options.tick, options.carverSpeedRate, options.GetPointStep(), options.playerSpeed,
+        options.runePoints, options.budget);
+
+    CaptureFile capture;
+    if (captureFile)
+    {
+        capture.file = std::fopen(captureFile, "wb");
+        std::string header;
+        AppendRuneCaptureFileHeader(header);
+        if (!capture.file || std::fwrite(header.data(), header.size(), 1, capture.file) != 1)
+        {
+            std::fprintf(stderr, "cannot write %s\n", captureFile);
+            return 1;
+        }
+    }
+
+    std::vector<StyleResult> results;
+    for (uint32 s = 0; s < MAX_MOVEMENT_STYLES; ++s)
+        if (onlyStyle < 0 || uint32(onlyStyle) == s)
+            results.push_back(RunStyle(MovementStyles(s), options, carvings, threads, seed, capture));
+
+    if (capture.file && std::fclose(capture.file))
+    {
+        std::fprintf(stderr, "cannot write %s\n", captureFile);
+        return 1;
+    }
+
+    std::printf("\n%-12s %12s %14s %7s %9s %8s %11s %8s %9s\n", "style", "carvings/s", "carvings/min", "points", "vertices", "strokes",
+        "carve time", "rolled", "invalid");
+    for (StyleResult const& result : results)
+    {
+        TrajectoryStats const& stats = result.stats;
+        double count = double(stats.carvings);
+        double perSecond = count / result.seconds;
+        std::printf("%-12s %12.0f %14.0f %7.2f %9.2f %8.2f %10.1fs %7.1f%% %8.1f%%\n", MovementStyleNames[result.style], perSecond, perSecond * 60.0,
+            double(stats.points) / count, double(stats.vertices) / count, double(stats.strokes) / count, double(stats.duration) * 0.001 / count,
+            100.0 * double(stats.matched) / count, 100.0 * double(stats.runes[MAX_RUNE_TYPES]) / count);
+    }
+
+    //rune spells cast, INVALID casts SPELL_RUNIC_WITHDRAWAL (then a random rune)
+    std::printf("\n%-10s", "rune");
+    for (StyleResult const& result : results)
+        std::printf(" %12s", MovementStyleNames[result.style]);
+    std::printf("\n");
+    std::vector<std::vector<std::pair<std::string, double>>> shares;
+    for (StyleResult const& result : results)
+        shares.push_back(GetRuneSpellShares(result.stats));
+    for (size_t r = 0; r < shares.front().size(); ++r)
+    {
+        std::printf("%-10s", shares.front()[r].first == "INVALID" ? "WITHDRAWAL" : shares.front()[r].first.c_str());
+        for (auto const& style : shares)
+            std::printf(" %11.2f%%", 100.0 * style[r].second);
+        std::printf("\n");
+    }
+
+    if (jsonFile)
+    {
+        FILE* file = std::fopen(jsonFile, "w");
+        if (!file)
+        {
+            std::fprintf(stderr, "cannot write %s\n", jsonFile);
+            return 1;
+        }
+        WriteTrajectoryJson(file, results, options, threads);
+        std::fclose(file);
+    }
+    return 0;
+}
@@ -0,0 +1,226 @@
+/*
+ * Author:
+ * 2020-2021 Trickerer <https://github.com/trickerer>
+ */
+
+#ifndef RUNEWORDER_TRAJECTORY_H
+#define RUNEWORDER_TRAJECTORY_H
+
+//Synthetic carver trajectories
+//A player moves by a scripted style, npc_rune_carver chases it (MovePoint to the victim each update, at
+//run speed * speed_run) and the boss polls the carver every POINT_SAMPLE_INTERVAL as EVENT_POINT_PUT does:
+//RunePointSampler samples the path and picks the points to summon, RunePathSimplifier keeps the vertices, then
+//the rune is recognized and rolled by _ComputateRuneType's own FindRuneMatches and RollRuneMatch with the built-in patterns.
+
+#include "boss_runeworder_encounter.h"
+#include "boss_runeworder_matchers.h"
+#include "boss_runeworder_path.h"
+#include "boss_runeworder_recognition.h"
+#include "boss_runeworder_strokes.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+constexpr float TRAJECTORY_RUN_SPEED = 7.f; //baseMoveSpeed[MOVE_RUN]
+constexpr uint32 TRAJECTORY_FIRST_SAMPLE = 500; //first EVENT_POINT_PUT after the carver is summoned
+constexpr float TRAJECTORY_LEASH = 35.f; //players stay in reach of the boss (carver targets within 40 yd)
+
+enum MovementStyles
+{
+    MOVEMENT_CIRCLE,        //kiting around the boss
+    MOVEMENT_ZIGZAG,        //legs alternating left and right of a heading
+    MOVEMENT_STAND,         //standing still
+    MOVEMENT_RANDOM_WALK,   //random turns and pauses
+    MAX_MOVEMENT_STYLES
+};
+
+constexpr char const* MovementStyleNames[MAX_MOVEMENT_STYLES] = { "circle", "zigzag", "stand", "random_walk" };
+
+struct TrajectoryOptions
+{
+    uint32 tick = 100;          //map update diff, ms
+    float playerSpeed = TRAJECTORY_RUN_SPEED;
+    float carverSpeedRate = 1.f; //speed_run of NPC_RUNE_CARVER_STALKER
+    uint32 runePoints = DEFAULT_RUNE_POINTS;
+    uint32 budget = UNMATCH_THRESHOLD;
+
+    //expected distance between two carve points, see _GetPointStep()
+    float GetPointStep() const { return TRAJECTORY_RUN_SPEED * (POINT_PUT_DELAY * 0.001f) * carverSpeedRate; }
+};
+
+//Scripted player movement around the boss (at 0,0)
+class TrajectoryPlayer
+{
+public:
+    TrajectoryPlayer(MovementStyles style, TrajectoryOptions const& options, std::mt19937& rng) : _style(style), _speed(options.playerSpeed)
+    {
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+        float angle = unit(rng) * 2.f * PI;
+        _radius = 12.f + unit(rng) * 18.f;
+        _x = std::cos(angle) * _radius;
+        _y = std::sin(angle) * _radius;
+        _heading = unit(rng) * 2.f * PI;
+        _direction = rng() % 2 ? 1.f : -1.f;
+        _zigAngle = (30.f + unit(rng) * 30.f) * PI / 180.f;
+        _legTime = 1500 + rng() % 2000;
+        _timer = _legTime;
+    }
+
+    float GetPositionX() const { return _x; }
+    float GetPositionY() const { return _y; }
+
+    void Update(uint32 diff, std::mt19937& rng)
+    {
+        float dist = _speed * diff * 0.001f;
+        switch (_style)
+        {
+            case MOVEMENT_CIRCLE:
+            {
+                //along the circle
+                float angle = std::atan2(_y, _x) + _direction * dist / _radius;
+                _x = std::cos(angle) * _radius;
+                _y = std::sin(angle) * _radius;
+                return;
+            }
+            case MOVEMENT_ZIGZAG:
+                if (_timer <= diff)
+                {
+                    _zigSide = -_zigSide;
+                    _timer = _legTime + rng() % 500;
+                    if (std::sqrt(_x * _x + _y * _y) > TRAJECTORY_LEASH)
+                        _heading = std::atan2(-_y, -_x);
+                }
+                else
+                    _timer -= diff;
+                _Move(_heading + _zigSide * _zigAngle, dist);
+                return;
+            case MOVEMENT_STAND:
+                return;
+            default:
+                if (_timer <= diff)
+                {
+                    //new leg: turn, sometimes stop for a while
+                    std::normal_distribution<float> turn(0.f, 60.f * PI / 180.f);
+                    _heading += turn(rng);
+                    _paused = rng() % 5 == 0;
+                    _timer = 500 + rng() % 2500;
+                    if (std::sqrt(_x * _x + _y * _y) > TRAJECTORY_LEASH)
+                        _heading = std::atan2(-_y, -_x);
+                }
+                else
+                    _timer -= diff;
+                if (!_paused)
+                    _Move(_heading, dist);
+                return;
+        }
+    }
+
+private:
+    static constexpr float PI = 3.14159265f;
+
+    void _Move(float heading, float dist)
+    {
+        _x += std::cos(heading) * dist;
+        _y += std::sin(heading) * dist;
+    }
+
+    MovementStyles _style;
+    float _speed;
+    float _x = 0.f;
+    float _y = 0.f;
+    float _radius = 0.f;
+    float _heading = 0.f;
+    float _direction = 1.f;
+    float _zigAngle = 0.f;
+    float _zigSide = 1.f;
+    uint32 _legTime = 0;
+    uint32 _timer = 0;
+    bool _paused = false;
+};
+
+//One carving and its recognition
+struct TrajectoryCarving
+{
+    std::vector<Position> points;   //sampled path points
+    std::vector<uint32> vertices;   //indices of the points kept as vertices
+    uint32 summoned = 0;            //carve points summoned, straight runs have fewer than path points
+    std::vector<int32> angles;
+    Strokes strokes;
+    RuneMatchHeap<MAX_RUNE_MATCHES> matches;
+    uint32 rune = RUNE_INVALID;
+    int32 roll = 0;
+    int32 rollMax = 0;
+    uint32 duration = 0;            //ms from summon to the last point
+};
+
+//angles, strokes, matches and rune of the sampled path, as _ComputateRuneType
+inline void RecognizeTrajectoryCarving(TrajectoryCarving& carving, RunePathSimplifier const& path, uint32 budget, std::mt19937& rng)
+{
+    carving.points.clear();
+    for (RunePathPoint const& point : path.GetPoints())
+        carving.points.emplace_back(point.x, point.y);
+    carving.vertices = path.GetVertices();
+    carving.angles.clear();
+    for (size_t i = 1; i + 1 < carving.vertices.size(); ++i)
+        carving.angles.push_back(GetDegrees(&carving.points[carving.vertices[i - 1]], &carving.points[carving.vertices[i]],
+            &carving.points[carving.vertices[i + 1]]));
+    carving.strokes = ClassifyRuneStrokes(carving.angles.data(), uint32(carving.angles.size()));
+    carving.matches = RuneMatchHeap<MAX_RUNE_MATCHES>();
+    FindRuneMatches(RuneRecognitionSet(), carving.strokes, budget, carving.matches);
+    carving.rune = RollRuneMatch(carving.matches, budget,
+        [&rng](int32 min, int32 max) { return std::uniform_int_distribution<int32>(min, max)(rng); }, carving.roll, carving.rollMax);
+}
+
+//carver summoned on the player, chasing it until the carve ends
+inline void SimulateTrajectoryCarving(MovementStyles style, TrajectoryOptions const& options, std::mt19937& rng, TrajectoryCarving& carving)
+{
+    TrajectoryPlayer player(style, options, rng);
+    float carverX = player.GetPositionX(), carverY = player.GetPositionY();
+    float carverSpeed = TRAJECTORY_RUN_SPEED * options.carverSpeedRate;
+    float step = options.GetPointStep();
+
+    RunePointSampler sampler;
+    RunePathSimplifier path;
+    sampler.Reset(step, step * DIST_THRESHOLD, options.runePoints - 1);
+    path.Reset(step * DIST_THRESHOLD);
+    carving.summoned = 0;
+
+    uint32 time = 0;
+    uint32 nextSample = TRAJECTORY_FIRST_SAMPLE;
+    while (!sampler.IsDone())
+    {
+        time += options.tick;
+
+        //carver moves to where the victim was at its last update
+        float dx = player.GetPositionX() - carverX, dy = player.GetPositionY() - carverY;
+        float dist = std::sqrt(dx * dx + dy * dy);
+        float move = carverSpeed * options.tick * 0.001f;
+        if (dist <= move)
+        {
+            carverX = player.GetPositionX();
+            carverY = player.GetPositionY();
+        }
+        else
+        {
+            carverX += dx / dist * move;
+            carverY += dy / dist * move;
+        }
+        player.Update(options.tick, rng);
+
+        while (nextSample <= time && !sampler.IsDone())
+        {
+            float x = carverX, y = carverY;
+            RuneSamples sample = sampler.Update(POINT_SAMPLE_INTERVAL, x, y);
+            if (sample != RUNE_SAMPLE_NONE)
+                path.Add(x, y);
+            if (sample == RUNE_SAMPLE_POINT)
+                ++carving.summoned;
+            nextSample += POINT_SAMPLE_INTERVAL;
+        }
+    }
+
+    carving.duration = time;
+    RecognizeTrajectoryCarving(carving, path, options.budget, rng);
+}
+
+#endif